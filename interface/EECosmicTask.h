@@ -14,6 +14,10 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -44,6 +48,9 @@ void beginRun(const edm::Run & r, const edm::EventSetup & c);
 /// EndRun
 void endRun(const edm::Run & r, const edm::EventSetup & c);
 
+/// EndLuminosityBlock
+void endLuminosityBlock(const edm::LuminosityBlock& l, const edm::EventSetup& c);
+
 /// Reset
 void reset(void);
 
@@ -53,6 +60,9 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
 private:
 
 int ievt_;
@@ -65,6 +75,13 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// DCC headers of the current event, shared by the tasks
+EEDccHeaderSummary& dccHeaders_;
+
 edm::InputTag EcalRawDataCollection_;
 edm::InputTag EcalUncalibratedRecHitCollection_; 
 edm::InputTag EcalRecHitCollection_;
@@ -14,6 +14,8 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccTowerMap.h"
+
 #include "TH2F.h"
 
 class EEDataCertificationTask: public edm::EDAnalyzer{
@@ -55,6 +57,21 @@ void reset(void);
 /// Cleanup
 void cleanup(void);
 
+/// Look up the MEs of the other tasks, if not cached or if their folder went away; all of them if revalidate
+void findMonitorElements(bool revalidate = false);
+
+/// Forget the cached MEs of the other tasks
+void clearMonitorElements(void);
+
+/// Tabulate the crystals of each SM in the map bins, if the mapping changed
+void setupWeights(void);
+
+/// Copy the 40x20 map h into values, index jx + 40 * jy; -1 if h is missing
+static void pullMap(TH2F* h, float* values);
+
+/// Certify each map bin from its DQM value and the DAQ and DCS maps, scaled by the SM
+void fillCertification(const float* dqm, const float* scale);
+
  static const int DccId_[18];
  static const int nTowerMax_;
   
@@ -70,6 +87,9 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+/// super crystals of the DCC towers, shared by the tasks
+EEDccTowerMap& towerMap_;
+
 TH2F *hDQM_;
 TH2F *hDAQ_;
 TH2F *hDCS_;
@@ -80,8 +100,26 @@ TH1F *hSynchronizationByLumi_;
 MonitorElement* meEEDataCertificationSummary_;
 MonitorElement* meEEDataCertification_[18];
 MonitorElement* meEEDataCertificationSummaryMap_;
+
+/// MEs of the other tasks, cached across lumi blocks
+MonitorElement* meEEIntegrityByLumi_;
+MonitorElement* meEEFrontendByLumi_;
+MonitorElement* meEESynchronizationByLumi_;
 MonitorElement* meEEReportSummary_;
-MonitorElement* meEEReportSummaryContents_[36];
+MonitorElement* meEEReportSummaryContents_[18];
+MonitorElement* meEEReportSummaryMap_;
+MonitorElement* meEEDAQSummaryMap_;
+MonitorElement* meEEDCSSummaryMap_;
+
+/// crystals of each SM in the map bins, index jx + 40 * jy
+float weights_[18][800];
+float nCrystals_[18];
+
+/// SM writing each bin of the certification map, -1 if none
+int owner_[800];
+
+bool initWeights_;
+unsigned long long weightsCacheId_;
 
 };
 
@@ -0,0 +1,110 @@
+#ifndef EEDccHeaderSummary_H
+#define EEDccHeaderSummary_H
+
+/*
+ * \file EEDccHeaderSummary.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Endcap DCC headers of the current event, per SM: run type and its
+ * class, readout half, laser wavelength, MGPA gain, BX, L1A and the
+ * front-end status of the towers. The summary is built in one pass over
+ * the collection, once per event and collection: it is the single
+ * per-event summary of the headers, shared by all the tasks reading the
+ * same collection, EERawDataTask included.
+ *
+*/
+
+#include <vector>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
+
+class EEDccHeaderSummary {
+
+ public:
+
+  /// run type classes, as bits
+  enum RunClass {
+    Physics = 0x01,
+    TestPulse = 0x02,
+    Laser = 0x04,
+    Led = 0x08,
+    Pedestal = 0x10,
+    Beam = 0x20
+  };
+
+  /// Constructor
+  EEDccHeaderSummary();
+
+  /// Destructor
+  virtual ~EEDccHeaderSummary();
+
+  /// The summary shared by all the tasks of the process
+  static EEDccHeaderSummary& shared(void);
+
+  /// Summarize dcchs, unless already done for this event and collection
+  void update(const edm::Event& e, const edm::Handle<EcalRawDataCollection>& dcchs);
+
+  /// Class bits of a run type, 0 if not in any class
+  static unsigned int runClass(const int runType);
+
+  /// Header of SM ism (1-18) found
+  bool found(const int ism) const;
+
+  /// Header of SM ism (1-18), 0 if not found
+  const EcalDCCHeaderBlock* header(const int ism) const;
+
+  /// Run type of SM ism (1-18), -1 if not found
+  int runType(const int ism) const;
+
+  /// Class bits of the run type of SM ism (1-18)
+  unsigned int classes(const int ism) const;
+
+  /// Class bits of the run types of all the SMs found
+  unsigned int classes(void) const;
+
+  /// Class bits of the run type of the first endcap header in the collection
+  unsigned int firstClasses(void) const;
+
+  /// Readout half, laser wavelength and MGPA gain of SM ism (1-18), -1 if not found
+  int rtHalf(const int ism) const;
+  int waveLength(const int ism) const;
+  int mgpaGain(const int ism) const;
+
+  /// BX and L1A of SM ism (1-18), -1 if not found
+  int bx(const int ism) const;
+  int l1a(const int ism) const;
+
+  /// Front-end status of the towers of SM ism (1-18), empty if not found
+  const std::vector<short>& feStatus(const int ism) const;
+
+ private:
+
+  static const int nSM_ = 18;
+
+  edm::EventID eventId_;
+  edm::ProductID productId_;
+
+  const EcalDCCHeaderBlock* header_[nSM_];
+
+  int runType_[nSM_];
+  unsigned int runClass_[nSM_];
+  unsigned int classes_;
+  unsigned int firstClasses_;
+
+  int rtHalf_[nSM_];
+  int waveLength_[nSM_];
+  int mgpaGain_[nSM_];
+
+  int bx_[nSM_];
+  int l1a_[nSM_];
+
+  static const std::vector<short> empty_;
+
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef EEDccTowerMap_H
+#define EEDccTowerMap_H
+
+/*
+ * \file EEDccTowerMap.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Super crystals of each tower of the 18 endcap DCCs, with their bin in
+ * the 40x20 super crystal summary maps and the number of crystals of the
+ * tower they contain. The table is built once per EcalMappingRcd IOV,
+ * and shared by the tasks filling the summary maps.
+ *
+*/
+
+#include <vector>
+
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "DataFormats/EcalDetId/interface/EcalScDetId.h"
+
+class EEDccTowerMap {
+
+ public:
+
+  /// super crystal of a DCC tower
+  struct Sc {
+    EcalScDetId id;
+    /// bin - 1 in the summary maps, EE+ at jx >= 20
+    int jx;
+    int jy;
+    /// crystals of the tower in this super crystal
+    int ncrystals;
+  };
+
+  /// Constructor
+  EEDccTowerMap();
+
+  /// Destructor
+  virtual ~EEDccTowerMap();
+
+  /// The table shared by all the tasks of the process
+  static EEDccTowerMap& shared(void);
+
+  /// Build the table, if the mapping changed; false if the mapping is not available
+  bool update(const edm::EventSetup& c);
+
+  /// Super crystals of tower itt (1-nTowerMax) of DCC idcc (1-9, 46-54)
+  const std::vector<Sc>& scs(const int idcc, const int itt) const;
+
+  /// IOV of the mapping the table was built for
+  unsigned long long cacheIdentifier(void) const { return cacheId_; }
+
+  /// highest tower number of the endcap DCCs
+  static const int nTowerMax = 44;
+
+ private:
+
+  static const int nDCC_ = 18;
+
+  bool init_;
+
+  unsigned long long cacheId_;
+
+  std::vector<Sc> scs_[nDCC_][nTowerMax];
+
+};
+
+#endif
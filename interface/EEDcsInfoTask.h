@@ -14,7 +14,7 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
-#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccTowerMap.h"
 
 class EEDcsInfoTask: public edm::EDAnalyzer{
 
@@ -60,7 +60,7 @@ void cleanup(void);
   
 private:
 
- void fillMonitorElements(int ready[40][20], const EcalElectronicsMapping *);
+ void fillMonitorElements(int ready[40][20]);
   
 DQMStore* dqmStore_;
 
@@ -70,6 +70,9 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+/// super crystals of the DCC towers, shared by the tasks
+EEDccTowerMap& towerMap_;
+
 MonitorElement* meEEDcsFraction_;
 MonitorElement* meEEDcsActive_[18];
 MonitorElement* meEEDcsActiveMap_;
@@ -0,0 +1,106 @@
+#ifndef EEDigiScanner_H
+#define EEDigiScanner_H
+
+/*
+ * \file EEDigiScanner.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Per-frame context of the crystal digis of the current event: SM, map
+ * coordinates, channel, readout half and run type of the DCC of each
+ * frame, with the position and span of its pulse maximum. The context is
+ * decoded in one pass over the collection, once per event and digi
+ * collection, and shared by the tasks. The scanner shares the view: the
+ * samples are unpacked once, by the shared EEDigiView, and the tasks
+ * read them there. The crystal tables are rebuilt when the
+ * EcalMappingRcd IOV changes.
+ *
+*/
+
+#include <vector>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiView.h"
+
+class EEDigiScanner {
+
+ public:
+
+  /// context of one frame
+  struct Frame {
+    /// position in the digi collection, and in the arrays of the view
+    int index;
+    /// hashed index
+    int hi;
+    /// SM (1-18), ix and iy as in EEDetId, channel in the SM
+    int ism;
+    int ix;
+    int iy;
+    int ic;
+    /// readout half, as Numbers::RtHalf
+    int rtHalf;
+    /// run type of the DCC of the SM, -1 if its header is missing
+    int runType;
+    /// first sample with the largest ADC count, -1 if all the samples are 0
+    int imax;
+    /// largest minus smallest ADC count
+    int span;
+  };
+
+  /// Constructor
+  EEDigiScanner();
+
+  /// Destructor
+  virtual ~EEDigiScanner();
+
+  /// The scanner shared by all the tasks of the process
+  static EEDigiScanner& shared(void);
+
+  /// Decode digis, with the run types of headers, already updated for this event, or of no header if 0
+  void update(const edm::Event& e, const edm::EventSetup& c, const edm::Handle<EEDigiCollection>& digis, const EEDccHeaderSummary* headers);
+
+  /// Frames of the current event, in the order of the digi collection
+  const std::vector<Frame>& frames(void) const;
+
+  /// Samples of the current event, unpacked by the shared view
+  const EEDigiView& view(void) const;
+
+  /// Memory held, in bytes
+  size_t bytes(void) const;
+
+ private:
+
+  /// Build the tables, if the mapping changed; false if the mapping is not available
+  bool initTables(const edm::EventSetup& c);
+
+  static const int nSM_ = 18;
+
+  bool init_;
+
+  unsigned long long cacheId_;
+
+  edm::EventID eventId_;
+  edm::ProductID digisId_;
+  bool headers_;
+
+  EEDigiView& view_;
+
+  /// hashed index -> SM, map coordinates, channel and readout half
+  std::vector<int> ism_;
+  std::vector<int> ix_;
+  std::vector<int> iy_;
+  std::vector<int> ic_;
+  std::vector<int> rtHalf_;
+
+  std::vector<Frame> frames_;
+
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef EEDigiView_H
+#define EEDigiView_H
+
+/*
+ * \file EEDigiView.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Samples of the crystal digis of the current event, unpacked in
+ * structure-of-arrays form: the hashed index of every frame, and per
+ * sample contiguous arrays of ADC counts and gain ids over all the
+ * frames, in the order of the digi collection. The view is filled once
+ * per event and collection, and shared by the tasks.
+ *
+*/
+
+#include <vector>
+#include <stdint.h>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+
+class EEDigiView {
+
+ public:
+
+  static const int nSamples = 10;
+
+  /// Constructor
+  EEDigiView();
+
+  /// Destructor
+  virtual ~EEDigiView();
+
+  /// The view shared by all the tasks of the process
+  static EEDigiView& shared(void);
+
+  /// Unpack digis, unless already done for this event and collection
+  void update(const edm::Event& e, const edm::Handle<EEDigiCollection>& digis);
+
+  /// Number of frames, also the stride between the samples of a frame
+  int size(void) const;
+
+  /// Hashed indices of the frames
+  const int* hashedIndex(void) const;
+
+  /// ADC counts of sample i (0-9) of all the frames
+  const uint16_t* adc(const int i) const;
+
+  /// Gain ids of sample i (0-9) of all the frames
+  const uint8_t* gain(const int i) const;
+
+  /// Memory held, in bytes
+  size_t bytes(void) const;
+
+ private:
+
+  edm::EventID eventId_;
+  edm::ProductID productId_;
+
+  int size_;
+
+  std::vector<int> hashedIndex_;
+
+  std::vector<uint16_t> adc_;
+  std::vector<uint8_t> gain_;
+
+};
+
+#endif
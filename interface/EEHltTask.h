@@ -22,6 +22,12 @@
 
 #include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEIntegritySummary.h"
+
+#include <vector>
+
 class MonitorElement;
 class DQMStore;
 
@@ -52,6 +58,9 @@ void beginRun(const edm::Run & r, const edm::EventSetup & c);
 /// EndRun
 void endRun(const edm::Run & r, const edm::EventSetup & c);
 
+/// EndLuminosityBlock
+void endLuminosityBlock(const edm::LuminosityBlock& lumiBlock, const edm::EventSetup& iSetup);
+
 /// Reset
 void reset(void);
 
@@ -61,15 +70,24 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
-void initGeometry( const edm::EventSetup& setup );
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
 
-EcalSubdetector subDet( const EEDetId& id ) { return( id.subdet() ); }
+/// HLT mode sums of the fills of one FED
+struct FedCounts {
+  double entries;
+  double sumw;
+  double sumw2;
+};
 
-EcalSubdetector subDet( const EcalElectronicsId& id ) { return( id.subdet() ); }
+/// Fill me n times with weight w for FED fednumber, or accumulate in counts in HLT mode
+void fillFed(MonitorElement* me, FedCounts* counts, int fednumber, double w = 1., int n = 1);
 
-int iSM( const EEDetId& id );
+/// Add the HLT mode counts to the MEs, as the fills would have
+void flush(void);
 
-int iSM( const EcalElectronicsId& id );
+/// Add counts[54] to me, with the bin errors of weighted fills if weighted, and clear them
+void flushFeds(MonitorElement* me, FedCounts* counts, bool weighted);
 
 private:
 
@@ -84,6 +102,18 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// integrity errors of the current event, shared by the tasks
+EEIntegritySummary& integritySummary_;
+
+/// accumulate per FED, write at the end of the lumi block and never log in the event loop:
+/// the MEs are then only updated at the end of each lumi block;
+/// test/EEBenchmark_cfg.py suites hlt and hltoffline time the task with and without it
+bool hltMode_;
+
 edm::InputTag EEDetIdCollection0_;
 edm::InputTag EEDetIdCollection1_;
 edm::InputTag EEDetIdCollection2_;
@@ -95,16 +125,21 @@ edm::InputTag EcalElectronicsIdCollection3_;
 edm::InputTag EcalElectronicsIdCollection4_;
 edm::InputTag EcalElectronicsIdCollection5_;
 edm::InputTag EcalElectronicsIdCollection6_;
+
+/// integrity collections, indexed by EEIntegritySummary::ErrorType
+edm::InputTag integrityCollections_[EEIntegritySummary::nTypes];
 edm::InputTag FEDRawDataCollection_;
 
 MonitorElement* meEEFedsOccupancy_;
 MonitorElement* meEEFedsSizeErrors_;
 MonitorElement* meEEFedsIntegrityErrors_;
 
-bool init_;
-bool initGeometry_;
+/// HLT mode counts, indexed by FED number - 601
+FedCounts nFedsOccupancy_[54];
+FedCounts nFedsSizeErrors_[54];
+FedCounts nFedsIntegrityErrors_[54];
 
-const EcalElectronicsMapping* map;
+bool init_;
 
 };
 
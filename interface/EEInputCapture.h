@@ -0,0 +1,89 @@
+#ifndef EEInputCapture_H
+#define EEInputCapture_H
+
+/*
+ * \file EEInputCapture.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Write, for every event, the collections read by the endcap tasks to a
+ * binary file in the EEInputFormat, to be fed back by EEInputReplay.
+ *
+*/
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFormat.h"
+
+class EEInputCapture: public edm::EDAnalyzer{
+
+public:
+
+/// Constructor
+EEInputCapture(const edm::ParameterSet& ps);
+
+/// Destructor
+virtual ~EEInputCapture();
+
+protected:
+
+/// Analyze
+void analyze(const edm::Event& e, const edm::EventSetup& c);
+
+/// BeginJob
+void beginJob(void);
+
+/// EndJob
+void endJob(void);
+
+private:
+
+/// Start a section of type and index in the event buffer
+void beginSection(int type, int index);
+
+/// Close the current section, with count items
+void endSection(int count);
+
+void put(uint32_t word);
+
+void put(float value);
+
+/// Put n 16 bit words, two per word
+void put(const uint16_t* data, int n);
+
+/// Put a vector of shorts, preceded by its size
+void put(const std::vector<short>& data);
+
+int ievt_;
+
+std::string fileName_;
+
+std::ofstream file_;
+
+edm::InputTag EEDigiCollection_;
+edm::InputTag EcalTrigPrimDigiCollection_;
+edm::InputTag EESRFlagCollection_;
+edm::InputTag EcalUncalibratedRecHitCollection_;
+edm::InputTag EcalRecHitCollection_;
+edm::InputTag EcalPnDiodeDigiCollection_;
+edm::InputTag EcalRawDataCollection_;
+edm::InputTag EEDetIdCollection_[EEInputFormat::nDetIdErrors];
+edm::InputTag EcalElectronicsIdCollection_[EEInputFormat::nElectronicsIdErrors];
+edm::InputTag FEDRawDataCollection_;
+
+/// words of the current event, and start of the current section
+std::vector<uint32_t> buffer_;
+int section_;
+int nSections_;
+
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef EEInputFile_H
+#define EEInputFile_H
+
+/*
+ * \file EEInputFile.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Memory mapped EEInputCapture file, read by EEInputReplaySource and
+ * EEInputReplay. The events are addressed by their offset in words from
+ * the start of the file, see EEInputFormat.
+ *
+*/
+
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "DataFormats/Provenance/interface/EventID.h"
+
+class EEInputFile {
+
+ public:
+
+  /// Constructor; maps fileName, throws if it is not an EEInputCapture file
+  EEInputFile(const std::string& fileName);
+
+  /// Destructor
+  virtual ~EEInputFile();
+
+  /// Offset of the first event
+  size_t first(void) const;
+
+  /// Offset of the event after the one at event, which must be valid
+  size_t next(size_t event) const;
+
+  /// Event at event fits in the file, with a size of at least its header
+  bool valid(size_t event) const;
+
+  /// Offset past the last word of the file
+  size_t end(void) const { return size_; }
+
+  /// Run, lumi and event numbers of the event at event, which must be valid
+  edm::EventID id(size_t event) const;
+
+  /// Words of the file
+  const uint32_t* data(void) const { return file_; }
+
+ private:
+
+  EEInputFile(const EEInputFile&);
+  EEInputFile& operator=(const EEInputFile&);
+
+  /// mapped file and its size in words
+  const uint32_t* file_;
+  size_t size_;
+
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef EEInputFormat_H
+#define EEInputFormat_H
+
+/*
+ * \file EEInputFormat.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Binary format of the input files written by EEInputCapture and read
+ * by EEInputReplay. Everything is stored in native 32 bit words, so a
+ * mapped file can be read in place:
+ *
+ *   file:    magic, version, then the events
+ *   event:   number of words of the event (this one included), run,
+ *            lumi, event, number of sections, then the sections
+ *   section: type, index, number of items, number of words of the
+ *            payload, then the payload
+ *
+ * The index tells the integrity collections apart (0-3 for the crystal
+ * ids, 0-5 for the electronics ids) and holds the FED id of the FED
+ * buffers. Floats are stored bit for bit, 16 bit samples two per word.
+ *
+*/
+
+#include <stdint.h>
+
+class EEInputFormat {
+
+ public:
+
+  static const uint32_t magic = 0x4e494545;
+  static const uint32_t version = 1;
+
+  /// words of the file, event and section headers
+  static const int fileHeaderSize = 2;
+  static const int eventHeaderSize = 5;
+  static const int sectionHeaderSize = 4;
+
+  /// section types
+  enum Section {
+    Digis = 1,
+    TrigPrims = 2,
+    SrFlags = 3,
+    UncalibRecHits = 4,
+    RecHits = 5,
+    PnDigis = 6,
+    DccHeaders = 7,
+    DetIdErrors = 8,
+    ElectronicsIdErrors = 9,
+    FedBuffers = 10
+  };
+
+  static const int nDetIdErrors = 4;
+  static const int nElectronicsIdErrors = 6;
+
+  /// FEDs captured: the endcap DCCs and the GT EVM
+  static const int nFeds = 19;
+
+  static int fedId(const int i) {
+    if ( i < 9 ) return 601 + i;
+    if ( i < 18 ) return 646 + i - 9;
+    return 812;
+  }
+
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef EEInputReplay_H
+#define EEInputReplay_H
+
+/*
+ * \file EEInputReplay.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Put back in the event the collections written by EEInputCapture, from
+ * the memory mapped file. Only the collections whose input tag label is
+ * the label of this module are produced, so that one instance stands in
+ * for each producer of the original job (ecalDigis, ecalRecHit, ...).
+ * The captured event is looked up by the id of the event, which must
+ * come from EEInputReplaySource on the same file, see EEInputReplay_cff.py.
+ *
+*/
+
+#include <map>
+#include <string>
+#include <stdint.h>
+
+#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFile.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFormat.h"
+
+class EEInputReplay: public edm::EDProducer{
+
+public:
+
+/// Constructor
+EEInputReplay(const edm::ParameterSet& ps);
+
+/// Destructor
+virtual ~EEInputReplay();
+
+protected:
+
+/// Produce
+void produce(edm::Event& e, const edm::EventSetup& c);
+
+/// BeginJob
+void beginJob(void);
+
+/// EndJob
+void endJob(void);
+
+private:
+
+/// Section of type and index of the current event, 0 if not captured or
+/// if the sections run past the end of the event; end is the end of its payload
+const uint32_t* section(int type, int index, int& count, const uint32_t*& end) const;
+
+/// Number of items of words words each that fit in the payload [p, end)
+int checked(int count, size_t words, const uint32_t* p, const uint32_t* end) const;
+
+int ievt_;
+
+std::string fileName_;
+
+std::string label_;
+
+edm::InputTag EEDigiCollection_;
+edm::InputTag EcalTrigPrimDigiCollection_;
+edm::InputTag EESRFlagCollection_;
+edm::InputTag EcalUncalibratedRecHitCollection_;
+edm::InputTag EcalRecHitCollection_;
+edm::InputTag EcalPnDiodeDigiCollection_;
+edm::InputTag EcalRawDataCollection_;
+edm::InputTag EEDetIdCollection_[EEInputFormat::nDetIdErrors];
+edm::InputTag EcalElectronicsIdCollection_[EEInputFormat::nElectronicsIdErrors];
+edm::InputTag FEDRawDataCollection_;
+
+/// collections produced by this instance
+bool produceDigis_;
+bool produceTrigPrims_;
+bool produceSrFlags_;
+bool produceUncalibRecHits_;
+bool produceRecHits_;
+bool producePnDigis_;
+bool produceDccHeaders_;
+bool produceDetIdErrors_[EEInputFormat::nDetIdErrors];
+bool produceElectronicsIdErrors_[EEInputFormat::nElectronicsIdErrors];
+bool produceFedBuffers_;
+
+/// mapped file, the offset of every captured event, and the current event
+EEInputFile* file_;
+std::map<edm::EventID, size_t> index_;
+size_t event_;
+
+};
+
+#endif
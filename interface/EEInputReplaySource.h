@@ -0,0 +1,58 @@
+#ifndef EEInputReplaySource_H
+#define EEInputReplaySource_H
+
+/*
+ * \file EEInputReplaySource.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Input source of the events of an EEInputCapture file, with the run,
+ * lumi and event numbers of the capture, so that the lumi sections of
+ * the replay are those of the captured job. The collections themselves
+ * are put in the events by EEInputReplay, see EEInputReplay_cff.py. The
+ * job ends after the last captured event, or at a truncated or corrupt
+ * one. The capture does not record the time of the events, which is left
+ * invalid.
+ *
+*/
+
+#include <memory>
+#include <string>
+
+#include "FWCore/Sources/interface/RawInputSource.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/InputSourceDescription.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFile.h"
+
+class EEInputReplaySource: public edm::RawInputSource{
+
+public:
+
+/// Constructor
+EEInputReplaySource(const edm::ParameterSet& ps, const edm::InputSourceDescription& desc);
+
+/// Destructor
+virtual ~EEInputReplaySource();
+
+protected:
+
+/// Next captured event, 0 at the end of the file
+std::auto_ptr<edm::Event> readOneEvent();
+
+private:
+
+int ievt_;
+
+std::string fileName_;
+
+EEInputFile file_;
+
+/// offset of the next event
+size_t event_;
+
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef EEInstrumentation_H
+#define EEInstrumentation_H
+
+/*
+ * \file EEInstrumentation.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Opt-in timing of one task: product fetch, digi loop, rec hit loop, ME
+ * flush and the whole event. Wall time is counted in TSC ticks for
+ * every stage; CPU time, read with the thread CPU clock, only for the
+ * whole event and the flush, where the system call is small against the
+ * stage. The size of the collections looped over is recorded with them. The per event averages are published in
+ * the Instrumentation folder, with the history of the last lumi sections.
+ *
+*/
+
+#include <string>
+#include <stdint.h>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/Handle.h"
+
+class MonitorElement;
+class DQMStore;
+
+class EEInstrumentation {
+
+ public:
+
+  /// stages timed; Total is the whole event, and closes it
+  enum Stage {
+    Fetch = 0,
+    Digis = 1,
+    RecHits = 2,
+    Flush = 3,
+    Total = 4
+  };
+
+  static const int nStages = 5;
+
+  /// lumi sections in the history
+  static const int nHistory = 50;
+
+  /// Times a stage, from construction to destruction, over items items;
+  /// CPU time for Total and Flush only
+  class Timer {
+
+   public:
+
+    Timer(EEInstrumentation& instrumentation, Stage stage, int items = 0);
+
+    ~Timer();
+
+   private:
+
+    EEInstrumentation* instrumentation_;
+
+    Stage stage_;
+
+    int items_;
+
+    uint64_t ticks_;
+    uint64_t cpu_;
+
+  };
+
+  /// Constructor
+  EEInstrumentation();
+
+  /// Destructor
+  virtual ~EEInstrumentation();
+
+  /// Turn the instrumentation on or off; off by default
+  void enable(bool enabled);
+
+  bool enabled(void) const;
+
+  /// Book the MEs of task in folder, if enabled
+  void setup(DQMStore* dqmStore, const std::string& folder, const std::string& task);
+
+  /// Remove the MEs
+  void cleanup(DQMStore* dqmStore);
+
+  /// Reset the MEs and the sums
+  void reset(void);
+
+  /// Add the lumi section just ended to the history
+  void endLumi(void);
+
+  /// Event::getByLabel, timed as Fetch
+  template<class T> bool getByLabel(const edm::Event& e, const edm::InputTag& tag, edm::Handle<T>& handle) {
+    Timer timer(*this, Fetch);
+    return e.getByLabel(tag, handle);
+  }
+
+ private:
+
+  void add(Stage stage, uint64_t ticks, uint64_t cpu, int items);
+
+  /// TSC ticks, and their rate, measured once per job
+  static uint64_t ticks(void);
+  static double ticksPerSecond(void);
+  static double ticksPerSecond_;
+
+  /// thread CPU time, in ns
+  static uint64_t cpu(void);
+
+  bool enabled_;
+
+  std::string folder_;
+
+  /// sums of the current event, per stage
+  uint64_t eventTicks_[nStages];
+  uint64_t eventCpu_[nStages];
+  int eventItems_[nStages];
+  bool eventUsed_[nStages];
+
+  /// sums of the current lumi section
+  int lumiEvents_;
+  double lumiWall_;
+  double lumiCpu_;
+  uint64_t lumiStart_;
+
+  MonitorElement* meWall_;
+  MonitorElement* meCpu_;
+  MonitorElement* meItems_;
+  MonitorElement* meWallHistory_;
+  MonitorElement* meCpuHistory_;
+  MonitorElement* meRateHistory_;
+
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef EEIntegritySummary_H
+#define EEIntegritySummary_H
+
+/*
+ * \file EEIntegritySummary.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Integrity errors of the current event, decoded in one pass over the
+ * 10 integrity collections: ids per error type and SM, crystals in
+ * error with their SM and map coordinates, MEM channels in error, and a
+ * per-crystal bitmask of error types. The summary is computed once per
+ * event and set of collections, and shared by the tasks. The shared
+ * summary is counts-only, the collection sizes and the ids per SM,
+ * unless a task enables the crystals: the crystal expansion of the tower
+ * errors is then done once for all the tasks. The crystal tables are
+ * rebuilt when the EcalMappingRcd IOV changes.
+ *
+*/
+
+#include <vector>
+#include <stdint.h>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+
+class EEIntegritySummary {
+
+ public:
+
+  /// error types, in the order of the integrity collections
+  enum ErrorType {
+    DCCSize = 0,
+    Gain = 1,
+    ChId = 2,
+    GainSwitch = 3,
+    TTId = 4,
+    BlockSize = 5,
+    MemTTId = 6,
+    MemBlockSize = 7,
+    MemChId = 8,
+    MemGain = 9,
+    nTypes = 10
+  };
+
+  /// crystal in error: SM, ix (flipped in EE-), iy, and the number of
+  /// crystals of the tower in error (1 for the crystal errors); the SM of
+  /// a tower error is the one of the tower
+  struct Crystal {
+    int ism;
+    int ix;
+    int iy;
+    int n;
+  };
+
+  /// MEM channel in error: SM, MEM tower and channel
+  struct Mem {
+    int ism;
+    int itt;
+    int ich;
+  };
+
+  /// Constructor; countsOnly: no crystals, MEM channels nor bitmask
+  EEIntegritySummary(bool countsOnly = false);
+
+  /// Destructor
+  virtual ~EEIntegritySummary();
+
+  /// The summary shared by all the tasks of the process
+  static EEIntegritySummary& shared(void);
+
+  /// Decode the crystals, MEM channels and bitmask too, from the next event on
+  void enableCrystals(void);
+
+  /// Decode the collections tags[nTypes], unless already done for this event and tags
+  void update(const edm::Event& e, const edm::EventSetup& c, const edm::InputTag* tags);
+
+  /// Collection of type found in the event
+  bool found(int type) const;
+
+  /// Size of the collection of type, all subdetectors
+  int size(int type) const;
+
+  /// Endcap ids of type in SM ism (1-18)
+  int nIds(int type, int ism) const;
+
+  /// Crystals in error, for the crystal and tower error types
+  const std::vector<Crystal>& crystals(int type) const;
+
+  /// MEM channels in error, for the MEM error types
+  const std::vector<Mem>& mems(int type) const;
+
+  /// Bitmask of the error types of crystal hi (hashed index)
+  unsigned int errors(int hi) const;
+
+  /// Memory held, in bytes
+  size_t bytes(void) const;
+
+ private:
+
+  bool initTables(const edm::EventSetup& c);
+
+  void clear(void);
+
+  void addCrystal(int type, int hi, int ism, int n);
+
+  static const int nSM_ = 18;
+
+  bool countsOnly_;
+
+  bool init_;
+
+  unsigned long long cacheId_;
+
+  edm::EventID eventId_;
+  edm::InputTag tags_[nTypes];
+
+  /// hashed index -> SM and map coordinates (ix not flipped)
+  std::vector<int> ism_;
+  std::vector<int> ix_;
+  std::vector<int> iy_;
+
+  bool found_[nTypes];
+  int size_[nTypes];
+  int nIds_[nTypes][nSM_];
+
+  std::vector<Crystal> crystals_[nTypes];
+  std::vector<Mem> mems_[nTypes];
+
+  /// error bitmask per crystal, and non-zero entries cleared at the next event
+  std::vector<uint16_t> mask_;
+  std::vector<int> usedCrystals_;
+
+};
+
+#endif
@@ -15,6 +15,10 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEIntegritySummary.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -60,6 +64,18 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
+/// Fill the crystal maps me[18] with crystals, and the errors by lumi with weight per tower or crystal
+void fillCrystals(const std::vector<EEIntegritySummary::Crystal>& crystals, MonitorElement** me, double weight);
+
+/// Fill the MEM tower maps me[18] with mems
+void fillMemTowers(const std::vector<EEIntegritySummary::Mem>& mems, MonitorElement** me);
+
+/// Fill the MEM channel maps me[18] with mems
+void fillMemChannels(const std::vector<EEIntegritySummary::Mem>& mems, MonitorElement** me);
+
 private:
 
 int ievt_;
@@ -74,6 +90,13 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// integrity errors of the current event, shared by the tasks
+EEIntegritySummary& integritySummary_;
+
 edm::InputTag EEDetIdCollection0_;
 edm::InputTag EEDetIdCollection1_;
 edm::InputTag EEDetIdCollection2_;
@@ -86,6 +109,9 @@ edm::InputTag EcalElectronicsIdCollection4_;
 edm::InputTag EcalElectronicsIdCollection5_;
 edm::InputTag EcalElectronicsIdCollection6_;
 
+/// integrity collections, indexed by EEIntegritySummary::ErrorType
+edm::InputTag integrityCollections_[EEIntegritySummary::nTypes];
+
 MonitorElement* meIntegrityChId[18];
 MonitorElement* meIntegrityGain[18];
 MonitorElement* meIntegrityGainSwitch[18];
@@ -0,0 +1,83 @@
+#ifndef EEMemoryReport_H
+#define EEMemoryReport_H
+
+/*
+ * \file EEMemoryReport.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Opt-in memory footprint of one task: the bytes held by the MEs of each
+ * folder of the task and by each internal buffer the task declares. The
+ * report is logged, and published in the MemoryReport folder as one
+ * histogram per task, in kB. Tasks report at the end of setup(), once
+ * their MEs are booked, and at endJob.
+ *
+*/
+
+#include <string>
+#include <vector>
+#include <utility>
+
+class MonitorElement;
+class DQMStore;
+
+class EEMemoryReport {
+
+ public:
+
+  /// Constructor
+  EEMemoryReport();
+
+  /// Destructor
+  virtual ~EEMemoryReport();
+
+  /// Turn the report on or off; off by default
+  void enable(bool enabled);
+
+  bool enabled(void) const;
+
+  /// Forget the buffers of the previous report
+  void clear(void);
+
+  /// Add an internal buffer of the task
+  void add(const std::string& name, size_t bytes);
+
+  /// Add an array of n buffer objects, sized by their bytes() method
+  template<class T> void add(const std::string& name, const T* buf, int n) {
+    size_t bytes = 0;
+    for ( int i = 0; i < n; i++ ) bytes += buf[i].bytes();
+    this->add(name, bytes);
+  }
+
+  /// Log the report of task, whose MEs live in prefixME/folder, and publish it in prefixME/MemoryReport
+  void report(DQMStore* dqmStore, const std::string& prefixME, const std::string& folder, const std::string& task, const std::string& when);
+
+  /// Remove the ME
+  void cleanup(DQMStore* dqmStore);
+
+  /// Bytes held by the histogram of me
+  static size_t bytes(MonitorElement* me);
+
+  /// Bytes held by the elements of v
+  template<class T> static size_t bytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+  }
+
+  static size_t bytes(const std::vector<bool>& v) {
+    return v.capacity() / 8;
+  }
+
+ private:
+
+  bool enabled_;
+
+  std::string folder_;
+
+  std::vector<std::pair<std::string, size_t> > buffers_;
+
+  MonitorElement* meMemory_;
+
+};
+
+#endif
@@ -22,6 +22,11 @@
 
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiScanner.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -63,6 +68,9 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
 private:
 
 int ievt_;
@@ -77,6 +85,16 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// DCC headers of the current event, shared by the tasks
+EEDccHeaderSummary& dccHeaders_;
+
+/// per-frame context of the digis of the current event, shared by the tasks
+EEDigiScanner& digiScanner_;
+
 edm::InputTag EcalRawDataCollection_;
 edm::InputTag EEDigiCollection_;
 edm::InputTag EcalPnDiodeDigiCollection_;
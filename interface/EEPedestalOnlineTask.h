@@ -14,6 +14,11 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiView.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalStats.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -55,6 +60,12 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
+/// Copy the accumulated pedestals to the maps
+void updateMaps(void);
+
 private:
 
 int ievt_;
@@ -69,10 +80,25 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// digi samples of the current event, shared by the tasks
+EEDigiView& digiView_;
+
 edm::InputTag EEDigiCollection_;
 
 MonitorElement* mePedMapG12_[18];
 
+EEPedestalStats stats_;
+
+/// events between two writes of stats_ to the maps, 0 to write only at the end of the lumi section, run and job
+int updateEvents_;
+
+std::vector<uint8_t> mask_;
+std::vector<uint8_t> g12_;
+
 bool init_;
 
 };
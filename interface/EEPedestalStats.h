@@ -0,0 +1,68 @@
+#ifndef EEPedestalStats_H
+#define EEPedestalStats_H
+
+/*
+ * \file EEPedestalStats.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Per-crystal, per-gain pedestal accumulator: integer sums of the ADC
+ * counts and of their squares, indexed by the EEDetId hashed index.
+ * The sums are exact and are written back to the pedestal profiles
+ * only when the task asks for it.
+ *
+*/
+
+#include <vector>
+#include <stdint.h>
+
+class MonitorElement;
+
+class EEPedestalStats{
+
+public:
+
+/// Constructor
+EEPedestalStats();
+
+/// Destructor
+virtual ~EEPedestalStats();
+
+/// Reset
+void reset(void);
+
+/// Accumulate samples [first, last) of the raw frame of crystal hi
+void add(int hi, const uint16_t* samples, int first, int last);
+
+/// Accumulate n samples of crystal hi read with MGPA gain id gainId, stored every stride entries of adc
+void add(int hi, int gainId, const uint16_t* adc, int stride, int n);
+
+/// Number of accumulated samples of crystal hi for MGPA gain id gainId (1 = G12, 2 = G06, 3 = G01)
+int64_t entries(int hi, int gainId) const;
+
+/// Overwrite the 18 pedestal profiles of MGPA gain id gainId with the accumulated values, bins and global statistics as Fill would leave them
+void write(int gainId, MonitorElement* const* me);
+
+/// Memory held, in bytes
+size_t bytes(void) const;
+
+private:
+
+void initBins(void);
+
+static const int nGains_ = 3;
+
+int nCry_;
+
+std::vector<int64_t> sum_;
+std::vector<int64_t> sum2_;
+std::vector<int64_t> nent_;
+
+std::vector<int> ism_;
+std::vector<int> binx_;
+std::vector<int> biny_;
+
+};
+
+#endif
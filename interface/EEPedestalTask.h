@@ -14,6 +14,12 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiScanner.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalStats.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -55,6 +61,15 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
+/// 3x3 and 5x5 correlated noise maps of one SM
+void commonNoise(int ism);
+
+/// Copy the accumulated pedestals to the maps
+void updateMaps(void);
+
 private:
 
 int ievt_;
@@ -67,6 +82,18 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// DCC headers of the current event, shared by the tasks
+EEDccHeaderSummary& dccHeaders_;
+
+/// per-frame context of the digis of the current event, shared by the tasks
+EEDigiScanner& digiScanner_;
+
+bool enableCommonNoise_;
+
 edm::InputTag EcalRawDataCollection_;
 edm::InputTag EEDigiCollection_;
 edm::InputTag EcalPnDiodeDigiCollection_;
@@ -88,6 +115,18 @@ MonitorElement* mePed5SumMapG12_[18];
 MonitorElement* mePnPedMapG01_[18];
 MonitorElement* mePnPedMapG16_[18];
 
+float xmap01_[18][50][50];
+float xmap06_[18][50][50];
+float xmap12_[18][50][50];
+bool xmapUsed_[18];
+
+bool validMap_[18][50][50];
+
+EEPedestalStats stats_;
+
+/// events between two writes of stats_ to the maps, 0 to write only at the end of the lumi section, run and job
+int updateEvents_;
+
 bool init_;
 
 };
@@ -0,0 +1,94 @@
+#ifndef EEReadoutCensus_H
+#define EEReadoutCensus_H
+
+/*
+ * \file EEReadoutCensus.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Number of crystals read out per trigger tower, per DCC channel
+ * (readout unit) and per DCC in the current event. The counts are
+ * computed once per event and digi collection, and shared by the tasks:
+ * by EESelectiveReadoutTask in its own digi loop, or by update().
+ * The crystal tables are rebuilt when the EcalMappingRcd IOV changes.
+ *
+*/
+
+#include <vector>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+
+class EEReadoutCensus {
+
+ public:
+
+  /// Constructor
+  EEReadoutCensus();
+
+  /// Destructor
+  virtual ~EEReadoutCensus();
+
+  /// The census shared by all the tasks of the process
+  static EEReadoutCensus& shared(void);
+
+  /// Count the crystals of digis, unless already done for this event and collection
+  void update(const edm::Event& e, const edm::EventSetup& c, const edm::Handle<EEDigiCollection>& digis);
+
+  /// Start the count of digis in the caller's own loop over them: true if
+  /// each digi has to be passed to add(), false if already counted
+  bool begin(const edm::Event& e, const edm::EventSetup& c, const edm::Handle<EEDigiCollection>& digis);
+
+  /// Count the crystal of hashed index hi, after begin() returned true
+  void add(const int hi);
+
+  /// Crystals read out in trigger tower itt (1-41) of TCC itcc (1-108)
+  int nCryTT(const int itcc, const int itt) const;
+
+  /// Crystals read out in channel isc (1-68) of DCC idcc (1-54)
+  int nCryRU(const int idcc, const int isc) const;
+
+  /// Crystals read out by DCC idcc (1-54)
+  int nCryDCC(const int idcc) const;
+
+  /// Memory held, in bytes
+  size_t bytes(void) const;
+
+ private:
+
+  /// Build the tables, if the mapping changed; false if the mapping is not available
+  bool initTables(const edm::EventSetup& c);
+
+  static const int nTCC_ = 108;
+  static const int nTT_ = 41;
+  static const int nDCC_ = 54;
+  static const int nRU_ = 68;
+
+  bool init_;
+
+  unsigned long long cacheId_;
+
+  edm::EventID eventId_;
+  edm::ProductID productId_;
+
+  /// hashed index -> flat TT, RU and DCC indices
+  std::vector<int> iTT_;
+  std::vector<int> iRU_;
+  std::vector<int> iDCC_;
+
+  int nCryTT_[nTCC_ * nTT_];
+  int nCryRU_[nDCC_ * nRU_];
+  int nCryDCC_[nDCC_];
+
+  /// non-zero entries, cleared at the next event
+  std::vector<int> usedTT_;
+  std::vector<int> usedRU_;
+  std::vector<int> usedDCC_;
+
+};
+
+#endif
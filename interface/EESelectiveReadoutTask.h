@@ -17,6 +17,11 @@
 #include "DataFormats/EcalDetId/interface/EcalScDetId.h"
 #include "DataFormats/EcalDetId/interface/EcalTrigTowerDetId.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEReadoutCensus.h"
+
 class MonitorElement;
 class DQMStore;
 class EcalSRSettings;
@@ -81,6 +86,9 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
 /// Constants
 static const int nECALDcc = 54;
 static const int nEEDcc = 18;
@@ -117,10 +125,6 @@ static const int bytesPerCrystal = 24;
 ///To store the readout crystals / SC
 int nCrySC[20][20][2];
 
-///To store the readout crystals / iTT
-/// indexes are [iTTC][iTT] 
-int nCryTT[108][41];
-
 ///To store the events with full readout
 int nEvtFullReadout[20][20][2];
 
@@ -308,10 +312,6 @@ int nEeHI_[2];
  */
 int nPerDcc_[nECALDcc];
 
-/** Number of crystal read for each DCC channel (aka readout unit).
- */
-int nPerRu_[nECALDcc][nDccChs];   
-
 /** Count for each DCC of RUs with at leat one channel read out:
  */
 int nRuPerDcc_[nECALDcc];
@@ -339,6 +339,16 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// DCC headers of the current event, shared by the tasks
+EEDccHeaderSummary& dccHeaders_;
+
+/// crystals read out per tower of the current event, shared by the tasks
+EEReadoutCensus& readoutCensus_;
+
 edm::InputTag EEDigiCollection_;
 edm::InputTag EEUnsuppressedDigiCollection_;
 edm::InputTag EcalRecHitCollection_;
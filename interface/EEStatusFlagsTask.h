@@ -14,6 +14,12 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+
+#include <vector>
+
 class MonitorElement;
 class DQMStore;
 
@@ -59,8 +65,20 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
+/// Write the accumulated front-end errors to the MEs
+void updateMaps(void);
+
+/// Status bins of the crystals of tower itt (1-41) of SM ism
+const std::vector<int>& towerBins(int ism, int itt);
+
 private:
 
+/// front-end status values not counted as errors: ACTIVE, DISABLED, SUPPRESSED, FORCED FS, L1A+BX SYNC, FORCED ZS
+static const unsigned int acceptableStatus_ = (1<<0) | (1<<1) | (1<<7) | (1<<8) | (1<<12) | (1<<15);
+
 int ievt_;
 
 DQMStore* dqmStore_;
@@ -73,6 +91,13 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// DCC headers of the current event, shared by the tasks
+EEDccHeaderSummary& dccHeaders_;
+
 edm::InputTag EcalRawDataCollection_;
 
 MonitorElement* meEvtType_[18];
@@ -80,6 +105,17 @@ MonitorElement* meEvtType_[18];
 MonitorElement* meFEchErrors_[18][3];
 MonitorElement* meFEchErrorsByLumi_;
 
+/// per SM and tower, bins (x + 50 * y) of meFEchErrors_[][0] of the tower crystals
+std::vector<int> towerBins_[18][41];
+bool towerBinsInit_[18][41];
+
+/// front-end errors per SM and bin of meFEchErrors_[][0], and status values per SM, not yet written to the MEs
+std::vector<int> nFEchErrors_;
+int nStatus_[18][16];
+
+/// events between two writes of the counts to the MEs, 0 to write only at the end of the lumi section, run and job
+int updateEvents_;
+
 bool init_;
 
 };
@@ -0,0 +1,102 @@
+#ifndef EETPGFastEmulator_H
+#define EETPGFastEmulator_H
+
+/*
+ * \file EETPGFastEmulator.h
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Compact emulation of the endcap trigger primitive generation, for the
+ * comparison with the TPs read out from the TCCs: linearisation, pseudo
+ * strip sum, amplitude filter and fine grain, tower sum and compression
+ * LUT, with the integer arithmetic of the FENIX and TCC emulation and the
+ * TPG conditions tabulated per crystal, strip and tower. The crystals,
+ * strips and towers masked in the TPG status records are zeroed as in the
+ * full emulation; the spike killing is barrel only.
+ *
+*/
+
+#include <vector>
+#include <stdint.h>
+
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "DataFormats/EcalDetId/interface/EcalTrigTowerDetId.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+
+class EETPGFastEmulator {
+
+ public:
+
+  /// Constructor
+  EETPGFastEmulator();
+
+  /// Destructor
+  virtual ~EETPGFastEmulator();
+
+  /// Tabulate the TPG conditions, if they changed
+  void setup(const edm::EventSetup& c);
+
+  /// Emulate the TPs of the towers with at least one crystal in digis
+  void process(const EEDigiCollection& digis, EcalTrigPrimDigiCollection& tps);
+
+  /// Memory held by the tables, in bytes
+  size_t bytes(void) const;
+
+  /// number of TP samples written, around the sample of interest
+  static const int nTPSamples = 5;
+
+ private:
+
+  static const int nSamples_ = 10;
+
+  /// first digi sample of the written TP samples
+  static const int firstTPSample_ = 3;
+
+  /// strip identification bit of the fine grain LUT index, set for the endcap strips
+  static const int identif_ = 1;
+
+  /// number of TPG conditions records tabulated
+  static const int nRecords_ = 11;
+
+  bool init_;
+
+  unsigned long long cacheId_[nRecords_];
+
+  /// per crystal: pedestal, multiplier and shift for gain id 1 (x12), 2 (x6), 3 (x1)
+  std::vector<int> base_;
+  std::vector<int> mult_;
+  std::vector<int> shift_;
+
+  /// per crystal: strip index, position in the strip and mask
+  std::vector<int> strip_;
+  std::vector<int> stripPos_;
+  std::vector<bool> crystalMasked_;
+
+  /// per strip: amplitude filter weights, output shift, fine grain threshold and LUT, mask, tower index
+  std::vector<int> weights_;
+  std::vector<int> stripShift_;
+  std::vector<uint32_t> fgThreshold_;
+  std::vector<uint32_t> fgLut_;
+  std::vector<bool> stripMasked_;
+  std::vector<int> tower_;
+
+  /// per tower: detector id, compression LUT, inner ring flag and mask
+  std::vector<EcalTrigTowerDetId> towerId_;
+  std::vector<const unsigned int*> lut_;
+  std::vector<bool> innerRing_;
+  std::vector<bool> towerMasked_;
+
+  /// event buffers, cleared sparsely
+  std::vector<int> stripSum_;
+  std::vector<int> stripFgIndex_;
+  std::vector<int> towerEt_;
+  std::vector<int> towerFg_;
+  std::vector<int> usedStrips_;
+  std::vector<int> usedTowers_;
+  std::vector<bool> stripUsed_;
+  std::vector<bool> towerUsed_;
+
+};
+
+#endif
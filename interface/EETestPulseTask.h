@@ -14,6 +14,11 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiScanner.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -55,6 +60,15 @@ void setup(void);
 /// Cleanup
 void cleanup(void);
 
+/// Log and publish the memory footprint
+void reportMemory(const std::string& when);
+
+/// Book the crystal maps of SM ism and DCC MGPA gain mgpaGain (3: G01, 2: G06, 1: G12), on first use
+void bookMaps(int ism, int mgpaGain);
+
+/// Book the PN maps of SM ism and PN gain gainId (0: G01, 1: G16), on first use
+void bookPnMaps(int ism, int gainId);
+
 private:
 
 int ievt_;
@@ -67,6 +81,16 @@ bool enableCleanup_;
 
 bool mergeRuns_;
 
+EEInstrumentation instrumentation_;
+
+EEMemoryReport memoryReport_;
+
+/// DCC headers of the current event, shared by the tasks
+EEDccHeaderSummary& dccHeaders_;
+
+/// per-frame context of the digis of the current event, shared by the tasks
+EEDigiScanner& digiScanner_;
+
 edm::InputTag EcalRawDataCollection_;
 edm::InputTag EEDigiCollection_;
 edm::InputTag EcalPnDiodeDigiCollection_;
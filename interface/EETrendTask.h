@@ -15,6 +15,9 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+
 class MonitorElement;
 class DQMStore;
 
@@ -56,6 +59,9 @@ class EETrendTask: public edm::EDAnalyzer{
   // Cleanup
   void cleanup(void);
 
+  /// Log and publish the memory footprint
+  void reportMemory(const std::string& when);
+
   // Update time check
   void updateTime(void);
 
@@ -73,6 +79,11 @@ class EETrendTask: public edm::EDAnalyzer{
 
   bool mergeRuns_;
 
+  /// opt-in timing of the task
+  EEInstrumentation instrumentation_;
+
+  EEMemoryReport memoryReport_;
+
   bool verbose_;
 
   edm::InputTag EEDigiCollection_;
@@ -92,6 +103,7 @@ class EETrendTask: public edm::EDAnalyzer{
   edm::InputTag EcalElectronicsIdCollection4_;
   edm::InputTag EcalElectronicsIdCollection5_;
   edm::InputTag EcalElectronicsIdCollection6_;
+
   edm::InputTag FEDRawDataCollection_;
   edm::InputTag EESRFlagCollection_;
 
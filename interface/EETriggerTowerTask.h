@@ -14,6 +14,12 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
 #include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEReadoutCensus.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EETPGFastEmulator.h"
 
 #include <vector>
 
@@ -68,6 +74,9 @@ class EETriggerTowerTask : public edm::EDAnalyzer {
   /// Cleanup
   void cleanup(void);
 
+  /// Log and publish the memory footprint
+  void reportMemory(const std::string& when);
+
  private:
   
   /// 1D array
@@ -76,16 +85,18 @@ class EETriggerTowerTask : public edm::EDAnalyzer {
   /// reserve an array to hold one histogram per supermodule
   void reserveArray( array1& array );
 
-  /// process a collection of digis, either real or emulated
+  /// process a collection of digis, either real or emulated; readoutCensus if readoutCensus_ is up to date
   void processDigis( const edm::Event& e,
-                     const edm::Handle<EcalTrigPrimDigiCollection>& digis, 
+                     const EcalTrigPrimDigiCollection& digis, 
 		     array1& meEtMap,
 		     array1& meVeto,
-		     const edm::Handle<EcalTrigPrimDigiCollection>& compDigis
-		     = edm::Handle<EcalTrigPrimDigiCollection>(),
-                     const edm::Handle<edm::TriggerResults>& hltResults
-                     = edm::Handle<edm::TriggerResults>());
+		     const EcalTrigPrimDigiCollection* compDigis = 0,
+                     const edm::TriggerResults* hltResults = 0,
+                     bool readoutCensus = false);
+
 
+  /// find the process of the HLT results, once per run
+  void resolveHLTResults(const edm::Event& e);
 
   /// book monitor elements for real, or emulated digis
   void setup( std::string const &nameext,
@@ -130,6 +141,20 @@ class EETriggerTowerTask : public edm::EDAnalyzer {
   /// merge MEs across runs
   bool mergeRuns_;
 
+  /// opt-in timing of the task
+  EEInstrumentation instrumentation_;
+
+  EEMemoryReport memoryReport_;
+
+/// crystals read out per tower of the current event, shared by the tasks
+EEReadoutCensus& readoutCensus_;
+
+  /// emulate the TPs from the crystal digis, instead of reading the emulated ones
+  bool enableFastEmulation_;
+
+  /// TP emulation used with enableFastEmulation
+  EETPGFastEmulator fastEmulator_;
+
   /// to find the input collection of real digis 
   edm::InputTag realCollection_;
 
@@ -144,6 +169,15 @@ class EETriggerTowerTask : public edm::EDAnalyzer {
   std::string HLTCaloHLTBit_;
   std::string HLTMuonHLTBit_;
 
+  /// HLT results actually read in this run
+  edm::InputTag HLTResultsTag_;
+  bool HLTResultsResolved_;
+
+  /// HLT menu the path indices below were resolved for
+  edm::ParameterSetID HLTTriggerNamesID_;
+  unsigned int HLTCaloHLTBitIndex_;
+  unsigned int HLTMuonHLTBitIndex_;
+
   /// debug output root file. if empty, no output file created.
   std::string outputFile_;
 
@@ -164,6 +198,13 @@ class EETriggerTowerTask : public edm::EDAnalyzer {
   MonitorElement* meTCCTimingCalo_[2];
   MonitorElement* meTCCTimingMuon_[2];
 
+  /// HLT results used in this run
+  MonitorElement* meHLTResults_;
+
+  /// towers found only in the emulated or only in the real TPs, vs SM
+  MonitorElement* meEmulOnly_;
+  MonitorElement* meRealOnly_;
+
 };
 
 #endif
@@ -57,3 +57,14 @@ DEFINE_FWK_MODULE(EEDataCertificationTask);
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EETrendTask.h"
 DEFINE_FWK_MODULE(EETrendTask);
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputCapture.h"
+DEFINE_FWK_MODULE(EEInputCapture);
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputReplay.h"
+DEFINE_FWK_MODULE(EEInputReplay);
+
+#include "FWCore/Framework/interface/InputSourceMacros.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputReplaySource.h"
+DEFINE_FWK_INPUT_SOURCE(EEInputReplaySource);
@@ -5,6 +5,8 @@ ecalEndcapHltTask = cms.EDAnalyzer("EEHltTask",
     folderName = cms.untracked.string('FEDIntegrity'),
     enableCleanup = cms.untracked.bool(False),
     mergeRuns = cms.untracked.bool(False),    
+    # see test/EEBenchmark_cfg.py, suites hlt and hltoffline
+    hltMode = cms.untracked.bool(False),
     FEDRawDataCollection = cms.InputTag("rawDataCollector"),
     EEDetIdCollection0 = cms.InputTag("ecalDigis","EcalIntegrityDCCSizeErrors"),
     EEDetIdCollection1 = cms.InputTag("ecalDigis","EcalIntegrityGainErrors"),
@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+
+ecalEndcapInputCapture = cms.EDAnalyzer("EEInputCapture",
+    fileName = cms.untracked.string('EEInput.bin'),
+    EEDigiCollection = cms.InputTag("ecalDigis","eeDigis"),
+    EcalTrigPrimDigiCollection = cms.InputTag("ecalDigis","EcalTriggerPrimitives"),
+    EESRFlagCollection = cms.InputTag("ecalDigis"),
+    EcalUncalibratedRecHitCollection = cms.InputTag("ecalGlobalUncalibRecHit","EcalUncalibRecHitsEE"),
+    EcalRecHitCollection = cms.InputTag("ecalRecHit","EcalRecHitsEE"),
+    EcalPnDiodeDigiCollection = cms.InputTag("ecalDigis"),
+    EcalRawDataCollection = cms.InputTag("ecalDigis"),
+    EEDetIdCollection0 = cms.InputTag("ecalDigis","EcalIntegrityDCCSizeErrors"),
+    EEDetIdCollection1 = cms.InputTag("ecalDigis","EcalIntegrityGainErrors"),
+    EEDetIdCollection2 = cms.InputTag("ecalDigis","EcalIntegrityChIdErrors"),
+    EEDetIdCollection3 = cms.InputTag("ecalDigis","EcalIntegrityGainSwitchErrors"),
+    EcalElectronicsIdCollection1 = cms.InputTag("ecalDigis","EcalIntegrityTTIdErrors"),
+    EcalElectronicsIdCollection2 = cms.InputTag("ecalDigis","EcalIntegrityBlockSizeErrors"),
+    EcalElectronicsIdCollection3 = cms.InputTag("ecalDigis","EcalIntegrityMemTtIdErrors"),
+    EcalElectronicsIdCollection4 = cms.InputTag("ecalDigis","EcalIntegrityMemBlockSizeErrors"),
+    EcalElectronicsIdCollection5 = cms.InputTag("ecalDigis","EcalIntegrityMemChIdErrors"),
+    EcalElectronicsIdCollection6 = cms.InputTag("ecalDigis","EcalIntegrityMemGainErrors"),
+    FEDRawDataCollection = cms.InputTag("rawDataCollector")
+)
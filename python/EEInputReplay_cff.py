@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+
+# one replay module for each producer of the captured collections, to be
+# run in place of the unpacking and the reconstruction, on the source of
+# the captured events, which restores their run, lumi and event numbers:
+#
+# process.source = cms.Source("EEInputReplaySource",
+#     fileName = cms.untracked.string('EEInput.bin')
+# )
+#
+# the replay modules look the events up by their id, set their fileName
+# to the one of the source
+
+from DQM.EcalEndcapMonitorTasks.EEInputCapture_cfi import ecalEndcapInputCapture
+
+ecalEndcapInputReplay = cms.EDProducer("EEInputReplay", **ecalEndcapInputCapture.parameters_())
+
+ecalDigis = ecalEndcapInputReplay.clone()
+ecalGlobalUncalibRecHit = ecalEndcapInputReplay.clone()
+ecalRecHit = ecalEndcapInputReplay.clone()
+rawDataCollector = ecalEndcapInputReplay.clone()
+
+ecalEndcapInputReplaySequence = cms.Sequence(rawDataCollector*ecalDigis*ecalGlobalUncalibRecHit*ecalRecHit)
@@ -5,6 +5,7 @@ ecalEndcapPedestalOnlineTask = cms.EDAnalyzer("EEPedestalOnlineTask",
     subfolder = cms.untracked.string(""),
     enableCleanup = cms.untracked.bool(False),
     mergeRuns = cms.untracked.bool(False),    
+    updateEvents = cms.untracked.int32(100),
     EEDigiCollection = cms.InputTag("ecalDigis","eeDigis")
 )
 
@@ -3,7 +3,9 @@ import FWCore.ParameterSet.Config as cms
 ecalEndcapPedestalTask = cms.EDAnalyzer("EEPedestalTask",
     prefixME = cms.untracked.string('EcalEndcap'),
     mergeRuns = cms.untracked.bool(False),    
+    updateEvents = cms.untracked.int32(100),
     enableCleanup = cms.untracked.bool(False),
+    enableCommonNoise = cms.untracked.bool(False),
     EcalRawDataCollection = cms.InputTag("ecalDigis"),
     EEDigiCollection = cms.InputTag("ecalDigis","eeDigis"),
     EcalPnDiodeDigiCollection = cms.InputTag("ecalDigis"),
@@ -5,6 +5,7 @@ ecalEndcapStatusFlagsTask = cms.EDAnalyzer("EEStatusFlagsTask",
                                            subfolder = cms.untracked.string(''),
     enableCleanup = cms.untracked.bool(False),
     mergeRuns = cms.untracked.bool(False),    
+    updateEvents = cms.untracked.int32(100),
     EcalRawDataCollection = cms.InputTag("ecalDigis")
 )
 
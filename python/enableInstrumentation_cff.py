@@ -0,0 +1,35 @@
+import FWCore.ParameterSet.Config as cms
+
+from DQM.EcalEndcapMonitorTasks.EEClusterTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EECosmicTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEHltTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEIntegrityTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EELaserTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EELedTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEOccupancyTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEPedestalOnlineTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEPedestalTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EERawDataTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EESelectiveReadoutTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEStatusFlagsTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETestPulseTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETimingTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETrendTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETriggerTowerTask_cfi import *
+
+ecalEndcapClusterTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapCosmicTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapHltTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapIntegrityTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapLaserTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapLedTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapOccupancyTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapPedestalOnlineTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapPedestalTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapRawDataTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapSelectiveReadoutTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapStatusFlagsTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapTestPulseTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapTimingTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapTrendTask.enableInstrumentation = cms.untracked.bool(True)
+ecalEndcapTriggerTowerTask.enableInstrumentation = cms.untracked.bool(True)
@@ -0,0 +1,35 @@
+import FWCore.ParameterSet.Config as cms
+
+from DQM.EcalEndcapMonitorTasks.EEClusterTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EECosmicTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEHltTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEIntegrityTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EELaserTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EELedTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEOccupancyTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEPedestalOnlineTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEPedestalTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EERawDataTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EESelectiveReadoutTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EEStatusFlagsTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETestPulseTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETimingTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETrendTask_cfi import *
+from DQM.EcalEndcapMonitorTasks.EETriggerTowerTask_cfi import *
+
+ecalEndcapClusterTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapCosmicTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapHltTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapIntegrityTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapLaserTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapLedTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapOccupancyTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapPedestalOnlineTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapPedestalTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapRawDataTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapSelectiveReadoutTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapStatusFlagsTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapTestPulseTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapTimingTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapTrendTask.enableMemoryReport = cms.untracked.bool(True)
+ecalEndcapTriggerTowerTask.enableMemoryReport = cms.untracked.bool(True)
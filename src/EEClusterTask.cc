@@ -40,7 +40,7 @@
 
 #include "TLorentzVector.h"
 
-EEClusterTask::EEClusterTask(const edm::ParameterSet& ps){
+EEClusterTask::EEClusterTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()) {
 
   init_ = false;
 
@@ -52,6 +52,10 @@ EEClusterTask::EEClusterTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   // parameters...
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   BasicClusterCollection_ = ps.getParameter<edm::InputTag>("BasicClusterCollection");
@@ -159,10 +163,13 @@ EEClusterTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup c
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EEClusterTask::reset(void) {
 
+  instrumentation_.reset();
+
   if ( meBCEne_ ) meBCEne_->Reset();
 
   if ( meBCNum_ ) meBCNum_->Reset();
@@ -269,6 +276,8 @@ void EEClusterTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEClusterTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -505,12 +514,17 @@ void EEClusterTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEClusterTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EEClusterTask");
 
@@ -674,35 +688,37 @@ void EEClusterTask::endJob(void){
 
   edm::LogInfo("EEClusterTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
-void EEClusterTask::analyze(const edm::Event& e, const edm::EventSetup& c){
+void EEClusterTask::reportMemory(const std::string& when) {
 
-  bool enable = false;
+  if ( ! memoryReport_.enabled() ) return;
 
-  edm::Handle<EcalRawDataCollection> dcchs;
+  memoryReport_.clear();
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
 
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+  memoryReport_.report(dqmStore_, prefixME_, "EEClusterTask", "EEClusterTask", when);
 
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
+}
 
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::BEAMH4 ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::BEAMH2 ) enable = true;
+void EEClusterTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::COSMIC ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::MTCC ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::COSMICS_GLOBAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PHYSICS_GLOBAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::COSMICS_LOCAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PHYSICS_LOCAL ) enable = true;
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
 
-      break;
+  bool enable = false;
 
-    }
+  edm::Handle<EcalRawDataCollection> dcchs;
+
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
+
+    dccHeaders_.update(e, dcchs);
+
+    if ( dccHeaders_.firstClasses() & ( EEDccHeaderSummary::Beam | EEDccHeaderSummary::Physics ) ) enable = true;
 
   } else {
 
@@ -728,7 +744,7 @@ void EEClusterTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   // recHits
   edm::Handle< EcalRecHitCollection > pEERecHits;
-  e.getByLabel( EcalRecHitCollection_, pEERecHits );
+  instrumentation_.getByLabel(e, EcalRecHitCollection_, pEERecHits );
   if ( !pEERecHits.isValid() ) {
     edm::LogWarning("EEClusterTask") << "RecHit collection " << EcalRecHitCollection_ << " not available.";
     return;
@@ -739,7 +755,7 @@ void EEClusterTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   // --- Endcap Basic Clusters ---
   edm::Handle<reco::BasicClusterCollection> pBasicClusters;
-  if ( e.getByLabel(BasicClusterCollection_, pBasicClusters) ) {
+  if ( instrumentation_.getByLabel(e, BasicClusterCollection_, pBasicClusters) ) {
 
     int nbcc = pBasicClusters->size();
     if (nbcc>0) meBCNum_->Fill(float(nbcc));
@@ -828,7 +844,7 @@ void EEClusterTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   // --- Endcap Super Clusters ----
   edm::Handle<reco::SuperClusterCollection> pSuperClusters;
-  if ( e.getByLabel(SuperClusterCollection_, pSuperClusters) ) {
+  if ( instrumentation_.getByLabel(e, SuperClusterCollection_, pSuperClusters) ) {
 
     int nscc = pSuperClusters->size();
     if ( nscc > 0 ) meSCNum_->Fill(float(nscc));
@@ -26,7 +26,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EECosmicTask.h"
 
-EECosmicTask::EECosmicTask(const edm::ParameterSet& ps){
+EECosmicTask::EECosmicTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()) {
 
   init_ = false;
 
@@ -38,6 +38,10 @@ EECosmicTask::EECosmicTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   EcalUncalibratedRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalUncalibratedRecHitCollection");
   EcalRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalRecHitCollection");
@@ -82,8 +86,16 @@ void EECosmicTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
 }
 
+void EECosmicTask::endLuminosityBlock(const edm::LuminosityBlock& l, const edm::EventSetup& c) {
+
+  instrumentation_.endLumi();
+
+}
+
 void EECosmicTask::reset(void) {
 
+  instrumentation_.reset();
+
   for (int i = 0; i < 18; i++) {
     if ( meSelMap_[i] ) meSelMap_[i]->Reset();
     if ( meSpectrum_[0][i] ) meSpectrum_[0][i]->Reset();
@@ -96,6 +108,8 @@ void EECosmicTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EECosmicTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -124,12 +138,17 @@ void EECosmicTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EECosmicTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EECosmicTask");
 
@@ -157,12 +176,28 @@ void EECosmicTask::endJob(void){
 
   edm::LogInfo("EECosmicTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EECosmicTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+
+  memoryReport_.report(dqmStore_, prefixME_, "EECosmicTask", "EECosmicTask", when);
+
+}
+
 void EECosmicTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   bool isData = true;
   bool enable = false;
   int runType[18];
@@ -170,25 +205,16 @@ void EECosmicTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
-
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
-
-      runType[ism-1] = dcchItr->getRunType();
-
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::COSMIC ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::MTCC ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::COSMICS_GLOBAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PHYSICS_GLOBAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::COSMICS_LOCAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PHYSICS_LOCAL ) enable = true;
+    dccHeaders_.update(e, dcchs);
 
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      runType[ism-1] = dccHeaders_.runType(ism);
     }
 
+    if ( dccHeaders_.classes() & EEDccHeaderSummary::Physics ) enable = true;
+
   } else {
 
     isData = false; enable = true;
@@ -204,14 +230,16 @@ void EECosmicTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRecHitCollection> hits;
 
-  if ( e.getByLabel(EcalRecHitCollection_, hits) ) {
+  if ( instrumentation_.getByLabel(e, EcalRecHitCollection_, hits) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::RecHits, hits->size());
 
     int neeh = hits->size();
     LogDebug("EECosmicTask") << "event " << ievt_ << " hits collection size " << neeh;
 
     edm::Handle<EcalUncalibratedRecHitCollection> uhits;
 
-    if ( ! e.getByLabel(EcalUncalibratedRecHitCollection_, uhits) ) {
+    if ( ! instrumentation_.getByLabel(e, EcalUncalibratedRecHitCollection_, uhits) ) {
       edm::LogWarning("EECosmicTask") << EcalUncalibratedRecHitCollection_ << " not available";
     }
 
@@ -25,13 +25,11 @@
 
 #include "DataFormats/FEDRawData/interface/FEDNumbering.h"
 
-#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
-
 #include "DQM/EcalCommon/interface/Numbers.h"
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEDaqInfoTask.h"
 
-EEDaqInfoTask::EEDaqInfoTask(const edm::ParameterSet& ps) {
+EEDaqInfoTask::EEDaqInfoTask(const edm::ParameterSet& ps) : towerMap_(EEDccTowerMap::shared()) {
 
   dqmStore_ = edm::Service<DQMStore>().operator->();
 
@@ -108,34 +106,25 @@ void EEDaqInfoTask::beginLuminosityBlock(const edm::LuminosityBlock& lumiBlock,
   }
   const EcalDAQTowerStatus* daqStatus = pDAQStatus.product();
 
-  edm::ESHandle< EcalElectronicsMapping > pElecMapping;
-  iSetup.get< EcalMappingRcd >().get(pElecMapping);
-  if( !pElecMapping.isValid() ) {
+  if ( ! towerMap_.update(iSetup) ) {
     edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
     return;
   }
-  const EcalElectronicsMapping *map = pElecMapping.product();
-
-  std::vector<DetId> crystals;
-  std::vector<EcalScDetId> scs;
 
   for(unsigned i=0 ; i<sizeof(DccId_)/sizeof(int) ; i++){
     for(int t=1 ; t<=nTowerMax_ ; t++){
 
-      crystals = map->dccTowerConstituents(DccId_[i], t);
-      if(!crystals.size()) continue;
-
-      scs = map->getEcalScDetId(DccId_[i], t, false);
+      const std::vector<EEDccTowerMap::Sc>& scs = towerMap_.scs(DccId_[i], t);
 
       for(unsigned u=0 ; u<scs.size() ; u++){
 
 	uint16_t dbStatus = 0; // 0 = good
-	EcalDAQTowerStatus::const_iterator daqStatusIt = daqStatus->find( scs[u].rawId() );
+	EcalDAQTowerStatus::const_iterator daqStatusIt = daqStatus->find( scs[u].id.rawId() );
 	if ( daqStatusIt != daqStatus->end() ) dbStatus = daqStatusIt->getStatusCode();
 	
 	if ( dbStatus > 0 ) {
-	  int jx = scs[u].ix() - 1 + (scs[u].zside()<0 ? 0 : 20);
-	  int jy = scs[u].iy() - 1;
+	  int jx = scs[u].jx;
+	  int jy = scs[u].jy;
 	  readyRun[jx][jy] = 0;
 	  readyLumi[jx][jy] = 0;
 	}
@@ -147,11 +136,8 @@ void EEDaqInfoTask::beginLuminosityBlock(const edm::LuminosityBlock& lumiBlock,
 
 void EEDaqInfoTask::endLuminosityBlock(const edm::LuminosityBlock&  lumiBlock, const  edm::EventSetup& iSetup) {
 
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  iSetup.get< EcalMappingRcd >().get(handle);
-  const EcalElectronicsMapping *map = handle.product();
-  if( ! map ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
-  else this->fillMonitorElements(readyLumi, map);
+  if( ! towerMap_.update(iSetup) ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
+  else this->fillMonitorElements(readyLumi);
 
 }
 
@@ -169,11 +155,8 @@ void EEDaqInfoTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
 void EEDaqInfoTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  c.get< EcalMappingRcd >().get(handle);
-  const EcalElectronicsMapping *map = handle.product();
-  if( ! map ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
-  else this->fillMonitorElements(readyRun, map);
+  if( ! towerMap_.update(c) ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
+  else this->fillMonitorElements(readyRun);
 
 }
 
@@ -210,7 +193,7 @@ void EEDaqInfoTask::cleanup(void){
 
 }
 
-void EEDaqInfoTask::fillMonitorElements(int ready[40][20], const EcalElectronicsMapping *map) {
+void EEDaqInfoTask::fillMonitorElements(int ready[40][20]) {
 
   float readySum[18];
   int nValidChannels[18];
@@ -229,30 +212,19 @@ void EEDaqInfoTask::fillMonitorElements(int ready[40][20], const EcalElectronics
     }
   }
 
-  std::vector<DetId> crystals;
-  std::vector<EcalScDetId> scs;
-
   for ( unsigned iDcc = 0; iDcc < sizeof(DccId_)/sizeof(int); iDcc++) {
     for ( int t = 1; t<=nTowerMax_; t++ ) {
 
-      crystals = map->dccTowerConstituents(DccId_[iDcc], t);
-      if(!crystals.size()) continue;
-
-      scs = map->getEcalScDetId(DccId_[iDcc], t, false);
+      const std::vector<EEDccTowerMap::Sc>& scs = towerMap_.scs(DccId_[iDcc], t);
 
       for(unsigned u=0 ; u<scs.size() ; u++){ // most of the time one DCC tower = one SC
 
-	int jx = scs[u].ix() - 1 + (scs[u].zside()<0 ? 0 : 20);
-	int jy = scs[u].iy() - 1;
+	int jx = scs[u].jx;
+	int jy = scs[u].jy;
 
 	if(meEEDaqActiveMap_) meEEDaqActiveMap_->setBinContent( jx+1, jy+1, ready[jx][jy] );
 
-	int ncrystals = 0;
-
-	for(std::vector<DetId>::const_iterator it=crystals.begin() ; it!=crystals.end() ; ++it){
-	  EEDetId id(*it);
-	  if( id.zside() == scs[u].zside() && (id.ix()-1)/5+1 == scs[u].ix() && (id.iy()-1)/5+1 == scs[u].iy() ) ncrystals++;
-	}
+	int ncrystals = scs[u].ncrystals;
 
 	if(ready[jx][jy]) {
 	  readySum[iDcc] += ncrystals;
@@ -17,9 +17,6 @@
 
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
 
-#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
-#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
-
 #include "DQMServices/Core/interface/MonitorElement.h"
 #include "DQMServices/Core/interface/DQMStore.h"
 
@@ -28,7 +25,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEDataCertificationTask.h"
 
-EEDataCertificationTask::EEDataCertificationTask(const edm::ParameterSet& ps) {
+EEDataCertificationTask::EEDataCertificationTask(const edm::ParameterSet& ps) : towerMap_(EEDccTowerMap::shared()) {
 
   // cloneME switch
   cloneME_ = ps.getUntrackedParameter<bool>("cloneME", true);
@@ -47,6 +44,11 @@ EEDataCertificationTask::EEDataCertificationTask(const edm::ParameterSet& ps) {
     meEEDataCertification_[i] = 0;
   }
 
+  this->clearMonitorElements();
+
+  initWeights_ = false;
+  weightsCacheId_ = 0;
+
   hDQM_ = 0;
   hDAQ_ = 0;
   hIntegrityByLumi_ = 0;
@@ -108,19 +110,16 @@ void EEDataCertificationTask::endLuminosityBlock(const edm::LuminosityBlock&  lu
     DQMVal[i] = -1.;
   }
 
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  iSetup.get< EcalMappingRcd >().get(handle);
-  const EcalElectronicsMapping *map = handle.product();
+  bool map = towerMap_.update(iSetup);
   if( ! map ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
 
-  me = dqmStore_->get( prefixME_ + "/EEIntegrityTask/EEIT weighted integrity errors by lumi" );
-  hIntegrityByLumi_ = UtilsClient::getHisto<TH1F*>( me, cloneME_, hIntegrityByLumi_ );
+  this->findMonitorElements();
 
-  me = dqmStore_->get( prefixME_ + "/EEStatusFlagsTask/FEStatus/EESFT weighted frontend errors by lumi" );
-  hFrontendByLumi_ = UtilsClient::getHisto<TH1F*>( me, cloneME_, hFrontendByLumi_ );
+  hIntegrityByLumi_ = UtilsClient::getHisto<TH1F*>( meEEIntegrityByLumi_, cloneME_, hIntegrityByLumi_ );
 
-  me = dqmStore_->get( prefixME_ + "/EERawDataTask/EERDT FE synchronization errors by lumi" );
-  hSynchronizationByLumi_ = UtilsClient::getHisto<TH1F*>( me, cloneME_, hSynchronizationByLumi_ );
+  hFrontendByLumi_ = UtilsClient::getHisto<TH1F*>( meEEFrontendByLumi_, cloneME_, hFrontendByLumi_ );
+
+  hSynchronizationByLumi_ = UtilsClient::getHisto<TH1F*>( meEESynchronizationByLumi_, cloneME_, hSynchronizationByLumi_ );
 
   if( hIntegrityByLumi_ && hFrontendByLumi_ && hSynchronizationByLumi_ && map) {
 
@@ -160,21 +159,20 @@ void EEDataCertificationTask::endLuminosityBlock(const edm::LuminosityBlock&  lu
     float minVal = std::min(integrityQual,frontendQual);
     float totDQMVal = std::min(minVal,synchronizationQual);
 
-    me = dqmStore_->get( prefixME_ + "/EventInfo/reportSummary" );
+    me = meEEReportSummary_;
     if( me ) me->Fill(totDQMVal);
 
     for ( int i=0; i<18; i++) {
-      me = dqmStore_->get( prefixME_ + "/EventInfo/reportSummaryContents/EcalEndcap_" + Numbers::sEE(i+1) );
+      me = meEEReportSummaryContents_[i];
       if( me ) me->Fill(DQMVal[i]);
 
-      me = dqmStore_->get( prefixME_ + "/EventInfo/reportSummaryMap" );
+      me = meEEReportSummaryMap_;
       if( me ) {
 	for(int t=1 ; t<=nTowerMax_ ; t++){
-	  if(! map->dccTowerConstituents(DccId_[i], t).size() ) continue;
-	  std::vector<EcalScDetId> scs = map->getEcalScDetId(DccId_[i], t, false);
+	  const std::vector<EEDccTowerMap::Sc>& scs = towerMap_.scs(DccId_[i], t);
 	  for(unsigned u=0 ; u<scs.size() ; u++){
-	    int jx = scs[u].ix() + (scs[u].zside()<0 ? 0 : 20);
-	    int jy = scs[u].iy();
+	    int jx = scs[u].jx + 1;
+	    int jy = scs[u].jy + 1;
 	    me->setBinContent(jx,jy, DQMVal[i]);
           }
         }
@@ -184,85 +182,20 @@ void EEDataCertificationTask::endLuminosityBlock(const edm::LuminosityBlock&  lu
   }
 
   // now combine reduced DQM with DCS and DAQ
-  me = dqmStore_->get( prefixME_ + "/EventInfo/DAQSummaryMap" );
-  hDAQ_ = UtilsClient::getHisto<TH2F*>( me, cloneME_, hDAQ_ );
+  hDAQ_ = UtilsClient::getHisto<TH2F*>( meEEDAQSummaryMap_, cloneME_, hDAQ_ );
 
-  me = dqmStore_->get( prefixME_ + "/EventInfo/DCSSummaryMap" );
-  hDCS_ = UtilsClient::getHisto<TH2F*>( me, cloneME_, hDCS_ );
+  hDCS_ = UtilsClient::getHisto<TH2F*>( meEEDCSSummaryMap_, cloneME_, hDCS_ );
 
-  float sumCert = 0.;
-  float sumCertEE[18];
-  int nValidChannels = 0;
-  int nValidChannelsEE[18];
-
-  if ( meEEDataCertificationSummaryMap_ ){
-    for(int ix=1 ; ix<=meEEDataCertificationSummaryMap_->getNbinsX() ; ix++){
-      for(int iy=1 ; iy<=meEEDataCertificationSummaryMap_->getNbinsY() ; iy++){
-	meEEDataCertificationSummaryMap_->setBinContent( ix, iy, -1.0 );
-      }
-    }
-  }
+  // the DQM value is the same for all the towers of a SM
+  float dqm[800];
+  for (int b = 0; b < 800; b++) dqm[b] = 1.;
 
+  float scale[18];
   for (int i = 0; i < 18; i++) {
-    sumCertEE[i] = 0;
-    nValidChannelsEE[i] = 0;
-
-    for(int t=1 ; t<=nTowerMax_ ; t++){
-
-      std::vector<DetId> crystals = map->dccTowerConstituents(DccId_[i], t);
-      if(!crystals.size()) continue; // getEcalScDetId throws an exception when no crystal is found
-
-      std::vector<EcalScDetId> scs = map->getEcalScDetId(DccId_[i], t, false);
-      for(unsigned u=0 ; u<scs.size() ; u++){
-
-	int jx = scs[u].ix() + (scs[u].zside()<0 ? 0 : 20);
-	int jy = scs[u].iy();
-
-	float xvalDQM = DQMVal[i];
-
-	float xvalDAQ, xvalDCS;
-	xvalDAQ = xvalDCS = -1.;
-	float xcert = -1.;
-
-	if ( hDAQ_ ) xvalDAQ = hDAQ_->GetBinContent( jx, jy );
-	if ( hDCS_ ) xvalDCS = hDCS_->GetBinContent( jx, jy );
-
-	if ( xvalDQM == -1 || ( xvalDAQ == -1 && xvalDCS == -1 ) ) {
-	  // problems: DQM empty or DAQ and DCS not available
-	  xcert = 0.0;
-	} else {
-	  // do not consider the white value of DAQ and DCS (problems with DB)
-	  xcert = std::abs(xvalDQM) * std::abs(xvalDAQ) * std::abs(xvalDCS);
-	}
-
-	if ( meEEDataCertificationSummaryMap_ ) meEEDataCertificationSummaryMap_->setBinContent( jx, jy, xcert );
-
-	int ncrystals = 0;
-
-	for(std::vector<DetId>::const_iterator it=crystals.begin() ; it!=crystals.end() ; ++it){
-	  EEDetId id(*it);
-	  if( id.zside() == scs[u].zside() && (id.ix()-1)/5+1 == scs[u].ix() && (id.iy()-1)/5+1 == scs[u].iy() ) ncrystals++;
-	}
-
-	sumCertEE[i] += xcert * ncrystals;
-	nValidChannelsEE[i] += ncrystals;
-
-	sumCert += xcert * ncrystals;
-	nValidChannels += ncrystals;
-
-      }
-    }
-
-    if( meEEDataCertification_[i] ) {
-      if( nValidChannelsEE[i]>0 ) meEEDataCertification_[i]->Fill( sumCertEE[i]/nValidChannelsEE[i] );
-      else meEEDataCertification_[i]->Fill( 0.0 );
-    }
+    scale[i] = DQMVal[i] == -1 ? 0. : std::abs(DQMVal[i]);
   }
 
-  if( meEEDataCertificationSummary_ ) {
-    if( nValidChannels>0 ) meEEDataCertificationSummary_->Fill( sumCert/nValidChannels );
-    else meEEDataCertificationSummary_->Fill( 0.0 );
-  }
+  this->fillCertification(dqm, scale);
 
 }
 
@@ -270,95 +203,104 @@ void EEDataCertificationTask::beginRun(const edm::Run& r, const edm::EventSetup&
 
   if ( ! mergeRuns_ ) this->reset();
 
+  // the other tasks may have booked their MEs again
+  this->clearMonitorElements();
+
 }
 
 void EEDataCertificationTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
   this->reset();
 
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  c.get< EcalMappingRcd >().get(handle);
-  const EcalElectronicsMapping *map = handle.product();
-  if( ! map ){
+  if( ! towerMap_.update(c) ){
     edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
     return;
   }
 
-  MonitorElement* me;
+  this->findMonitorElements(true);
 
-  me = dqmStore_->get( prefixME_ + "/EventInfo/reportSummaryMap" );
-  hDQM_ = UtilsClient::getHisto<TH2F*>( me, cloneME_, hDQM_ );
+  hDQM_ = UtilsClient::getHisto<TH2F*>( meEEReportSummaryMap_, cloneME_, hDQM_ );
 
-  me = dqmStore_->get( prefixME_ + "/EventInfo/DAQSummaryMap" );
-  hDAQ_ = UtilsClient::getHisto<TH2F*>( me, cloneME_, hDAQ_ );
+  hDAQ_ = UtilsClient::getHisto<TH2F*>( meEEDAQSummaryMap_, cloneME_, hDAQ_ );
 
-  me = dqmStore_->get( prefixME_ + "/EventInfo/DCSSummaryMap" );
-  hDCS_ = UtilsClient::getHisto<TH2F*>( me, cloneME_, hDCS_ );
+  hDCS_ = UtilsClient::getHisto<TH2F*>( meEEDCSSummaryMap_, cloneME_, hDCS_ );
 
-  float sumCert = 0.;
-  float sumCertEE[18];
-  int nValidChannels = 0;
-  int nValidChannelsEE[18];
-
-  if ( meEEDataCertificationSummaryMap_ ){
-    for(int ix=1 ; ix<=meEEDataCertificationSummaryMap_->getNbinsX() ; ix++){
-      for(int iy=1 ; iy<=meEEDataCertificationSummaryMap_->getNbinsY() ; iy++){
-	meEEDataCertificationSummaryMap_->setBinContent( ix, iy, -1.0 );
-      }
-    }
-  }
+  float dqm[800];
+  this->pullMap(hDQM_, dqm);
+
+  float scale[18];
+  for (int i = 0; i < 18; i++) scale[i] = 1.;
+
+  this->fillCertification(dqm, scale);
+
+}
+
+void EEDataCertificationTask::setupWeights(void) {
+
+  if ( initWeights_ && weightsCacheId_ == towerMap_.cacheIdentifier() ) return;
+
+  for (int b = 0; b < 800; b++) owner_[b] = -1;
 
   for (int i = 0; i < 18; i++) {
-    sumCertEE[i] = 0;
-    nValidChannelsEE[i] = 0;
+    nCrystals_[i] = 0.;
+    for (int b = 0; b < 800; b++) weights_[i][b] = 0.;
 
     for(int t=1 ; t<=nTowerMax_ ; t++){
+      const std::vector<EEDccTowerMap::Sc>& scs = towerMap_.scs(DccId_[i], t);
+      for(unsigned u=0 ; u<scs.size() ; u++){
+        int b = scs[u].jx + 40 * scs[u].jy;
+        weights_[i][b] += scs[u].ncrystals;
+        nCrystals_[i] += scs[u].ncrystals;
+        owner_[b] = i;
+      }
+    }
+  }
 
-      std::vector<DetId> crystals = map->dccTowerConstituents(DccId_[i], t);
-      if(!crystals.size()) continue;
+  weightsCacheId_ = towerMap_.cacheIdentifier();
+  initWeights_ = true;
 
-      std::vector<EcalScDetId> scs = map->getEcalScDetId(DccId_[i], t, false);
-      for(unsigned u=0 ; u<scs.size() ; u++){
+}
 
-	int jx = scs[u].ix() + (scs[u].zside()<0 ? 0 : 20);
-	int jy = scs[u].iy();
+void EEDataCertificationTask::pullMap(TH2F* h, float* values) {
 
-	float xvalDQM, xvalDAQ, xvalDCS;
-	xvalDQM = xvalDAQ = xvalDCS = -1.;
-	float xcert = -1.;
+  if ( ! h || h->GetNbinsX() != 40 || h->GetNbinsY() != 20 ) {
+    for (int b = 0; b < 800; b++) values[b] = -1.;
+    return;
+  }
 
-	if ( hDQM_ ) xvalDQM = hDQM_->GetBinContent( jx, jy );
-	if ( hDAQ_ ) xvalDAQ = hDAQ_->GetBinContent( jx, jy );
-	if ( hDCS_ ) xvalDCS = hDCS_->GetBinContent( jx, jy );
+  for (int b = 0; b < 800; b++) values[b] = h->GetBinContent( h->GetBin( b % 40 + 1, b / 40 + 1 ) );
 
-	if ( xvalDQM == -1 || ( xvalDAQ == -1 && xvalDCS == -1 ) ) {
-	  // problems: DQM empty or DAQ and DCS not available
-	  xcert = 0.0;
-	} else {
-	  // do not consider the white value of DAQ and DCS (problems with DB)
-	  xcert = std::abs(xvalDQM) * std::abs(xvalDAQ) * std::abs(xvalDCS);
-	}
+}
 
-	if ( meEEDataCertificationSummaryMap_ ) meEEDataCertificationSummaryMap_->setBinContent( jx, jy, xcert );
+void EEDataCertificationTask::fillCertification(const float* dqm, const float* scale) {
 
-	int ncrystals = 0;
+  this->setupWeights();
 
-	for(std::vector<DetId>::const_iterator it=crystals.begin() ; it!=crystals.end() ; ++it){
-	  EEDetId id(*it);
-	  if( id.zside() == scs[u].zside() && (id.ix()-1)/5+1 == scs[u].ix() && (id.iy()-1)/5+1 == scs[u].iy() ) ncrystals++;
-	}
+  float daq[800], dcs[800], cert[800];
+  this->pullMap(hDAQ_, daq);
+  this->pullMap(hDCS_, dcs);
+
+  for (int b = 0; b < 800; b++) {
+    // problems: DQM empty or DAQ and DCS not available
+    // otherwise do not consider the white value of DAQ and DCS (problems with DB)
+    bool bad = dqm[b] == -1 || ( daq[b] == -1 && dcs[b] == -1 );
+    cert[b] = bad ? 0. : std::abs(dqm[b]) * std::abs(daq[b]) * std::abs(dcs[b]);
+  }
 
-	sumCertEE[i] += xcert * ncrystals;
-	nValidChannelsEE[i] += ncrystals;
+  float sumCert = 0.;
+  float nValidChannels = 0.;
 
-	sumCert += xcert * ncrystals;
-	nValidChannels += ncrystals;
+  for (int i = 0; i < 18; i++) {
+    const float* w = weights_[i];
+    float sumCertEE = 0.;
+    for (int b = 0; b < 800; b++) sumCertEE += w[b] * cert[b];
+    sumCertEE *= scale[i];
 
-      }
-    }
+    sumCert += sumCertEE;
+    nValidChannels += nCrystals_[i];
 
     if( meEEDataCertification_[i] ) {
-      if( nValidChannelsEE[i]>0 ) meEEDataCertification_[i]->Fill( sumCertEE[i]/nValidChannelsEE[i] );
+      if( nCrystals_[i]>0 ) meEEDataCertification_[i]->Fill( sumCertEE/nCrystals_[i] );
       else meEEDataCertification_[i]->Fill( 0.0 );
     }
   }
@@ -368,6 +310,16 @@ void EEDataCertificationTask::endRun(const edm::Run& r, const edm::EventSetup& c
     else meEEDataCertificationSummary_->Fill( 0.0 );
   }
 
+  if ( meEEDataCertificationSummaryMap_ ) {
+    TH2F* h2 = meEEDataCertificationSummaryMap_->getTH2F();
+    if ( h2 ) {
+      for (int b = 0; b < 800; b++) {
+        float xcert = owner_[b] < 0 ? -1. : cert[b] * scale[owner_[b]];
+        h2->SetBinContent( h2->GetBin( b % 40 + 1, b / 40 + 1 ), xcert );
+      }
+    }
+  }
+
 }
 
 void EEDataCertificationTask::reset(void) {
@@ -384,6 +336,56 @@ void EEDataCertificationTask::reset(void) {
 
 }
 
+void EEDataCertificationTask::findMonitorElements(bool revalidate) {
+
+  if ( ! dqmStore_ ) return;
+
+  // an ME removed by its task leaves its folder in place, so that the
+  // cached MEs are looked up again when revalidated
+  if ( revalidate ) this->clearMonitorElements();
+
+  // a folder removed from the store takes its MEs with it
+  if ( ! dqmStore_->dirExists(prefixME_ + "/EEIntegrityTask") ) meEEIntegrityByLumi_ = 0;
+  if ( ! dqmStore_->dirExists(prefixME_ + "/EEStatusFlagsTask/FEStatus") ) meEEFrontendByLumi_ = 0;
+  if ( ! dqmStore_->dirExists(prefixME_ + "/EERawDataTask") ) meEESynchronizationByLumi_ = 0;
+  if ( ! dqmStore_->dirExists(prefixME_ + "/EventInfo/reportSummaryContents") ) {
+    for (int i = 0; i < 18; i++) meEEReportSummaryContents_[i] = 0;
+  }
+  if ( ! dqmStore_->dirExists(prefixME_ + "/EventInfo") ) {
+    meEEReportSummary_ = 0;
+    meEEReportSummaryMap_ = 0;
+    meEEDAQSummaryMap_ = 0;
+    meEEDCSSummaryMap_ = 0;
+  }
+
+  if ( ! meEEIntegrityByLumi_ ) meEEIntegrityByLumi_ = dqmStore_->get( prefixME_ + "/EEIntegrityTask/EEIT weighted integrity errors by lumi" );
+  if ( ! meEEFrontendByLumi_ ) meEEFrontendByLumi_ = dqmStore_->get( prefixME_ + "/EEStatusFlagsTask/FEStatus/EESFT weighted frontend errors by lumi" );
+  if ( ! meEESynchronizationByLumi_ ) meEESynchronizationByLumi_ = dqmStore_->get( prefixME_ + "/EERawDataTask/EERDT FE synchronization errors by lumi" );
+
+  if ( ! meEEReportSummary_ ) meEEReportSummary_ = dqmStore_->get( prefixME_ + "/EventInfo/reportSummary" );
+  for (int i = 0; i < 18; i++) {
+    if ( ! meEEReportSummaryContents_[i] ) meEEReportSummaryContents_[i] = dqmStore_->get( prefixME_ + "/EventInfo/reportSummaryContents/EcalEndcap_" + Numbers::sEE(i+1) );
+  }
+  if ( ! meEEReportSummaryMap_ ) meEEReportSummaryMap_ = dqmStore_->get( prefixME_ + "/EventInfo/reportSummaryMap" );
+  if ( ! meEEDAQSummaryMap_ ) meEEDAQSummaryMap_ = dqmStore_->get( prefixME_ + "/EventInfo/DAQSummaryMap" );
+  if ( ! meEEDCSSummaryMap_ ) meEEDCSSummaryMap_ = dqmStore_->get( prefixME_ + "/EventInfo/DCSSummaryMap" );
+
+}
+
+void EEDataCertificationTask::clearMonitorElements(void) {
+
+  meEEIntegrityByLumi_ = 0;
+  meEEFrontendByLumi_ = 0;
+  meEESynchronizationByLumi_ = 0;
+  meEEReportSummary_ = 0;
+  for (int i = 0; i < 18; i++) {
+    meEEReportSummaryContents_[i] = 0;
+  }
+  meEEReportSummaryMap_ = 0;
+  meEEDAQSummaryMap_ = 0;
+  meEEDCSSummaryMap_ = 0;
+
+}
 
 void EEDataCertificationTask::cleanup(void){
 
@@ -413,6 +415,8 @@ void EEDataCertificationTask::cleanup(void){
     }
   }
 
+  this->clearMonitorElements();
+
 }
 
 void EEDataCertificationTask::analyze(const edm::Event& e, const edm::EventSetup& c){
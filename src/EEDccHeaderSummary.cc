@@ -0,0 +1,218 @@
+/*
+ * \file EEDccHeaderSummary.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "DQM/EcalCommon/interface/Numbers.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+
+const std::vector<short> EEDccHeaderSummary::empty_;
+
+EEDccHeaderSummary::EEDccHeaderSummary() {
+
+  for ( int i = 0; i < nSM_; i++ ) {
+    header_[i] = 0;
+    runType_[i] = -1;
+    runClass_[i] = 0;
+    rtHalf_[i] = -1;
+    waveLength_[i] = -1;
+    mgpaGain_[i] = -1;
+    bx_[i] = -1;
+    l1a_[i] = -1;
+  }
+
+  classes_ = 0;
+  firstClasses_ = 0;
+
+}
+
+EEDccHeaderSummary::~EEDccHeaderSummary() {
+
+}
+
+EEDccHeaderSummary& EEDccHeaderSummary::shared(void) {
+
+  static EEDccHeaderSummary summary;
+
+  return summary;
+
+}
+
+unsigned int EEDccHeaderSummary::runClass(const int runType) {
+
+  switch ( runType ) {
+  case EcalDCCHeaderBlock::COSMIC:
+  case EcalDCCHeaderBlock::MTCC:
+  case EcalDCCHeaderBlock::COSMICS_GLOBAL:
+  case EcalDCCHeaderBlock::PHYSICS_GLOBAL:
+  case EcalDCCHeaderBlock::COSMICS_LOCAL:
+  case EcalDCCHeaderBlock::PHYSICS_LOCAL:
+    return Physics;
+  case EcalDCCHeaderBlock::TESTPULSE_MGPA:
+  case EcalDCCHeaderBlock::TESTPULSE_GAP:
+    return TestPulse;
+  case EcalDCCHeaderBlock::LASER_STD:
+  case EcalDCCHeaderBlock::LASER_GAP:
+    return Laser;
+  case EcalDCCHeaderBlock::LED_STD:
+  case EcalDCCHeaderBlock::LED_GAP:
+    return Led;
+  case EcalDCCHeaderBlock::PEDESTAL_STD:
+  case EcalDCCHeaderBlock::PEDESTAL_GAP:
+    return Pedestal;
+  case EcalDCCHeaderBlock::BEAMH4:
+  case EcalDCCHeaderBlock::BEAMH2:
+    return Beam;
+  default:
+    return 0;
+  }
+
+}
+
+void EEDccHeaderSummary::update(const edm::Event& e, const edm::Handle<EcalRawDataCollection>& dcchs) {
+
+  if ( e.id() == eventId_ && dcchs.id() == productId_ ) return;
+
+  eventId_ = e.id();
+  productId_ = dcchs.id();
+
+  for ( int i = 0; i < nSM_; i++ ) {
+    header_[i] = 0;
+    runType_[i] = -1;
+    runClass_[i] = 0;
+    rtHalf_[i] = -1;
+    waveLength_[i] = -1;
+    mgpaGain_[i] = -1;
+    bx_[i] = -1;
+    l1a_[i] = -1;
+  }
+
+  classes_ = 0;
+  firstClasses_ = 0;
+
+  bool first = true;
+
+  for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+
+    if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
+
+    if ( first ) {
+      firstClasses_ = runClass(dcchItr->getRunType());
+      first = false;
+    }
+
+    int ism = Numbers::iSM( *dcchItr, EcalEndcap );
+
+    if ( ism < 1 || ism > nSM_ ) continue;
+
+    header_[ism-1] = &(*dcchItr);
+
+    runType_[ism-1] = dcchItr->getRunType();
+    runClass_[ism-1] = runClass(dcchItr->getRunType());
+
+    rtHalf_[ism-1] = dcchItr->getRtHalf();
+    waveLength_[ism-1] = dcchItr->getEventSettings().wavelength;
+    mgpaGain_[ism-1] = dcchItr->getMgpaGain();
+
+    bx_[ism-1] = dcchItr->getBX();
+    l1a_[ism-1] = dcchItr->getLV1();
+
+  }
+
+  for ( int i = 0; i < nSM_; i++ ) classes_ |= runClass_[i];
+
+}
+
+bool EEDccHeaderSummary::found(const int ism) const {
+
+  return header(ism) != 0;
+
+}
+
+const EcalDCCHeaderBlock* EEDccHeaderSummary::header(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return 0;
+
+  return header_[ism-1];
+
+}
+
+int EEDccHeaderSummary::runType(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return -1;
+
+  return runType_[ism-1];
+
+}
+
+unsigned int EEDccHeaderSummary::classes(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return 0;
+
+  return runClass_[ism-1];
+
+}
+
+unsigned int EEDccHeaderSummary::classes(void) const {
+
+  return classes_;
+
+}
+
+unsigned int EEDccHeaderSummary::firstClasses(void) const {
+
+  return firstClasses_;
+
+}
+
+int EEDccHeaderSummary::rtHalf(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return -1;
+
+  return rtHalf_[ism-1];
+
+}
+
+int EEDccHeaderSummary::waveLength(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return -1;
+
+  return waveLength_[ism-1];
+
+}
+
+int EEDccHeaderSummary::mgpaGain(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return -1;
+
+  return mgpaGain_[ism-1];
+
+}
+
+int EEDccHeaderSummary::bx(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return -1;
+
+  return bx_[ism-1];
+
+}
+
+int EEDccHeaderSummary::l1a(const int ism) const {
+
+  if ( ism < 1 || ism > nSM_ ) return -1;
+
+  return l1a_[ism-1];
+
+}
+
+const std::vector<short>& EEDccHeaderSummary::feStatus(const int ism) const {
+
+  const EcalDCCHeaderBlock* h = header(ism);
+
+  return h ? h->getFEStatus() : empty_;
+
+}
@@ -0,0 +1,106 @@
+/*
+ * \file EEDccTowerMap.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+
+#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccTowerMap.h"
+
+EEDccTowerMap::EEDccTowerMap() {
+
+  init_ = false;
+
+  cacheId_ = 0;
+
+}
+
+EEDccTowerMap::~EEDccTowerMap() {
+
+}
+
+EEDccTowerMap& EEDccTowerMap::shared(void) {
+
+  static EEDccTowerMap table;
+
+  return table;
+
+}
+
+bool EEDccTowerMap::update(const edm::EventSetup& c) {
+
+  unsigned long long cacheId = c.get< EcalMappingRcd >().cacheIdentifier();
+
+  if ( init_ && cacheId == cacheId_ ) return true;
+
+  edm::ESHandle< EcalElectronicsMapping > handle;
+  c.get< EcalMappingRcd >().get(handle);
+  if ( ! handle.isValid() ) return false;
+  const EcalElectronicsMapping *map = handle.product();
+  if ( ! map ) return false;
+
+  for ( int i = 0; i < nDCC_; i++ ) {
+
+    int idcc = ( i < 9 ) ? i + 1 : i + 37;
+
+    for ( int t = 1; t <= nTowerMax; t++ ) {
+
+      std::vector<Sc>& list = scs_[i][t-1];
+
+      list.clear();
+
+      std::vector<DetId> crystals = map->dccTowerConstituents(idcc, t);
+      if ( ! crystals.size() ) continue; // getEcalScDetId throws an exception when no crystal is found
+
+      std::vector<EcalScDetId> scs = map->getEcalScDetId(idcc, t, false);
+
+      for ( unsigned u = 0; u < scs.size(); u++ ) {
+
+        Sc sc;
+
+        sc.id = scs[u];
+        sc.jx = scs[u].ix() - 1 + (scs[u].zside()<0 ? 0 : 20);
+        sc.jy = scs[u].iy() - 1;
+        sc.ncrystals = 0;
+
+        for ( std::vector<DetId>::const_iterator it = crystals.begin(); it != crystals.end(); ++it ) {
+          EEDetId id(*it);
+          if ( id.zside() == scs[u].zside() && (id.ix()-1)/5+1 == scs[u].ix() && (id.iy()-1)/5+1 == scs[u].iy() ) sc.ncrystals++;
+        }
+
+        list.push_back(sc);
+
+      }
+
+    }
+
+  }
+
+  cacheId_ = cacheId;
+  init_ = true;
+
+  return true;
+
+}
+
+const std::vector<EEDccTowerMap::Sc>& EEDccTowerMap::scs(const int idcc, const int itt) const {
+
+  static const std::vector<Sc> empty;
+
+  int i = -1;
+  if ( idcc >=  1 && idcc <=  9 ) i = idcc - 1;
+  if ( idcc >= 46 && idcc <= 54 ) i = idcc - 37;
+
+  if ( ! init_ || i < 0 || itt < 1 || itt > nTowerMax ) return empty;
+
+  return scs_[i][itt-1];
+
+}
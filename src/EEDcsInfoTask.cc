@@ -19,8 +19,6 @@
 #include "CondFormats/EcalObjects/interface/EcalDCSTowerStatus.h"
 #include "CondFormats/DataRecord/interface/EcalDCSTowerStatusRcd.h"
 
-#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
-
 #include "DQMServices/Core/interface/MonitorElement.h"
 #include "DQMServices/Core/interface/DQMStore.h"
 
@@ -28,7 +26,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEDcsInfoTask.h"
 
-EEDcsInfoTask::EEDcsInfoTask(const edm::ParameterSet& ps) {
+EEDcsInfoTask::EEDcsInfoTask(const edm::ParameterSet& ps) : towerMap_(EEDccTowerMap::shared()) {
 
   dqmStore_ = edm::Service<DQMStore>().operator->();
 
@@ -105,34 +103,25 @@ void EEDcsInfoTask::beginLuminosityBlock(const edm::LuminosityBlock& lumiBlock,
   }
   const EcalDCSTowerStatus* dcsStatus = pDCSStatus.product();
 
-  edm::ESHandle< EcalElectronicsMapping > pElecMapping;
-  iSetup.get< EcalMappingRcd >().get(pElecMapping);
-  if( !pElecMapping.isValid() ) {
+  if ( ! towerMap_.update(iSetup) ) {
     edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
     return;
   }
-  const EcalElectronicsMapping *map = pElecMapping.product();
-
-  std::vector<DetId> crystals;
-  std::vector<EcalScDetId> scs;
 
   for(unsigned i=0 ; i<sizeof(DccId_)/sizeof(int) ; i++){
     for(int t=1 ; t<=nTowerMax_ ; t++){
 
-      crystals = map->dccTowerConstituents(DccId_[i], t);
-      if(!crystals.size()) continue;
-
-      scs = map->getEcalScDetId(DccId_[i], t, false);
+      const std::vector<EEDccTowerMap::Sc>& scs = towerMap_.scs(DccId_[i], t);
 
       for(unsigned u=0 ; u<scs.size() ; u++){
 
 	uint16_t dbStatus = 0; // 0 = good
-	EcalDCSTowerStatus::const_iterator dcsStatusIt = dcsStatus->find( scs[u].rawId() );
+	EcalDCSTowerStatus::const_iterator dcsStatusIt = dcsStatus->find( scs[u].id.rawId() );
 	if ( dcsStatusIt != dcsStatus->end() ) dbStatus = dcsStatusIt->getStatusCode();
 	
 	if ( dbStatus > 0 ) {
-	  int jx = scs[u].ix() - 1 + (scs[u].zside()<0 ? 0 : 20);
-	  int jy = scs[u].iy() - 1;
+	  int jx = scs[u].jx;
+	  int jy = scs[u].jy;
 	  readyRun[jx][jy] = 0;
 	  readyLumi[jx][jy] = 0;
 	}
@@ -166,11 +155,8 @@ void EEDcsInfoTask::beginLuminosityBlock(const edm::LuminosityBlock& lumiBlock,
 
 void EEDcsInfoTask::endLuminosityBlock(const edm::LuminosityBlock&  lumiBlock, const  edm::EventSetup& iSetup) {
 
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  iSetup.get< EcalMappingRcd >().get(handle);
-  const EcalElectronicsMapping *map = handle.product();
-  if( ! map ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
-  else this->fillMonitorElements(readyLumi, map);
+  if( ! towerMap_.update(iSetup) ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
+  else this->fillMonitorElements(readyLumi);
 
 }
 
@@ -188,11 +174,8 @@ void EEDcsInfoTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
 void EEDcsInfoTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  c.get< EcalMappingRcd >().get(handle);
-  const EcalElectronicsMapping *map = handle.product();
-  if( ! map ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
-  else this->fillMonitorElements(readyRun, map);
+  if( ! towerMap_.update(c) ) edm::LogWarning("EEDaqInfoTask") << "EcalElectronicsMapping not available";
+  else this->fillMonitorElements(readyRun);
 
 }
 
@@ -229,7 +212,7 @@ void EEDcsInfoTask::cleanup(void){
 
 }
 
-void EEDcsInfoTask::fillMonitorElements(int ready[40][20], const EcalElectronicsMapping *map) {
+void EEDcsInfoTask::fillMonitorElements(int ready[40][20]) {
 
   float readySum[18];
   int nValidChannels[18];
@@ -248,30 +231,19 @@ void EEDcsInfoTask::fillMonitorElements(int ready[40][20], const EcalElectronics
     }
   }
 
-  std::vector<DetId> crystals;
-  std::vector<EcalScDetId> scs;
-
   for ( unsigned iDcc = 0; iDcc < sizeof(DccId_)/sizeof(int); iDcc++) {
     for ( int t = 1; t<=nTowerMax_; t++ ) {
 
-      crystals = map->dccTowerConstituents(DccId_[iDcc], t);
-      if(!crystals.size()) continue;
-
-      scs = map->getEcalScDetId(DccId_[iDcc], t, false);
+      const std::vector<EEDccTowerMap::Sc>& scs = towerMap_.scs(DccId_[iDcc], t);
 
       for(unsigned u=0 ; u<scs.size() ; u++){ // most of the time one DCC tower = one SC
 
-	int jx = scs[u].ix() - 1 + (scs[u].zside()<0 ? 0 : 20);
-	int jy = scs[u].iy() - 1;
+	int jx = scs[u].jx;
+	int jy = scs[u].jy;
 
 	if(meEEDcsActiveMap_) meEEDcsActiveMap_->setBinContent( jx+1, jy+1, ready[jx][jy] );
 
-	int ncrystals = 0;
-
-	for(std::vector<DetId>::const_iterator it=crystals.begin() ; it!=crystals.end() ; ++it){
-	  EEDetId id(*it);
-	  if( id.zside() == scs[u].zside() && (id.ix()-1)/5+1 == scs[u].ix() && (id.iy()-1)/5+1 == scs[u].iy() ) ncrystals++;
-	}
+	int ncrystals = scs[u].ncrystals;
 
 	if(ready[jx][jy]) {
 	  readySum[iDcc] += ncrystals;
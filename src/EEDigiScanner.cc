@@ -0,0 +1,172 @@
+/*
+ * \file EEDigiScanner.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalDetId/interface/EcalElectronicsId.h"
+
+#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
+
+#include "DQM/EcalCommon/interface/Numbers.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiScanner.h"
+
+EEDigiScanner::EEDigiScanner() : view_(EEDigiView::shared()) {
+
+  init_ = false;
+
+  cacheId_ = 0;
+
+  headers_ = false;
+
+}
+
+EEDigiScanner::~EEDigiScanner() {
+
+}
+
+EEDigiScanner& EEDigiScanner::shared(void) {
+
+  static EEDigiScanner scanner;
+
+  return scanner;
+
+}
+
+bool EEDigiScanner::initTables(const edm::EventSetup& c) {
+
+  unsigned long long cacheId = c.get< EcalMappingRcd >().cacheIdentifier();
+
+  if ( init_ && cacheId == cacheId_ ) return true;
+
+  edm::ESHandle< EcalElectronicsMapping > handle;
+  c.get< EcalMappingRcd >().get(handle);
+  if ( ! handle.isValid() ) return false;
+  const EcalElectronicsMapping* map = handle.product();
+  if ( ! map ) return false;
+
+  ism_.resize(EEDetId::kSizeForDenseIndexing);
+  ix_.resize(EEDetId::kSizeForDenseIndexing);
+  iy_.resize(EEDetId::kSizeForDenseIndexing);
+  ic_.resize(EEDetId::kSizeForDenseIndexing);
+  rtHalf_.resize(EEDetId::kSizeForDenseIndexing);
+
+  for ( int hi = 0; hi < EEDetId::kSizeForDenseIndexing; hi++ ) {
+
+    EEDetId id = EEDetId::unhashIndex(hi);
+
+    int ism = Numbers::iSM( map->getElectronicsId(id) );
+
+    ism_[hi] = ism;
+    ix_[hi] = id.ix();
+    iy_[hi] = id.iy();
+    ic_[hi] = Numbers::icEE(ism, id.ix(), id.iy());
+    rtHalf_[hi] = Numbers::RtHalf(id);
+
+  }
+
+  // decode again with the new tables
+  eventId_ = edm::EventID();
+
+  cacheId_ = cacheId;
+  init_ = true;
+
+  return true;
+
+}
+
+void EEDigiScanner::update(const edm::Event& e, const edm::EventSetup& c, const edm::Handle<EEDigiCollection>& digis, const EEDccHeaderSummary* headers) {
+
+  if ( ! initTables(c) ) {
+    frames_.clear();
+    return;
+  }
+
+  bool hasHeaders = ( headers != 0 );
+
+  if ( e.id() == eventId_ && digis.id() == digisId_ && hasHeaders == headers_ ) return;
+
+  eventId_ = e.id();
+  digisId_ = digis.id();
+  headers_ = hasHeaders;
+
+  int runType[nSM_];
+  for ( int i = 0; i < nSM_; i++ ) runType[i] = -1;
+
+  if ( headers ) {
+    for ( int ism = 1; ism <= nSM_; ism++ ) runType[ism-1] = headers->runType(ism);
+  }
+
+  view_.update(e, digis);
+
+  int n = view_.size();
+
+  frames_.resize(n);
+
+  if ( n == 0 ) return;
+
+  const int* hashedIndex = view_.hashedIndex();
+
+  const uint16_t* adc[EEDigiView::nSamples];
+  for ( int i = 0; i < EEDigiView::nSamples; i++ ) adc[i] = view_.adc(i);
+
+  for ( int k = 0; k < n; k++ ) {
+
+    int hi = hashedIndex[k];
+
+    Frame& f = frames_[k];
+
+    f.index = k;
+    f.hi = hi;
+    f.ism = ism_[hi];
+    f.ix = ix_[hi];
+    f.iy = iy_[hi];
+    f.ic = ic_[hi];
+    f.rtHalf = rtHalf_[hi];
+    f.runType = ( f.ism >= 1 && f.ism <= nSM_ ) ? runType[f.ism-1] : -1;
+
+    int imax = -1;
+    int max = 0;
+    int min = 4096;
+    for ( int i = 0; i < EEDigiView::nSamples; i++ ) {
+      int a = adc[i][k];
+      if ( a > max ) {
+        max = a;
+        imax = i;
+      }
+      if ( a < min ) min = a;
+    }
+
+    f.imax = imax;
+    f.span = max - min;
+
+  }
+
+}
+
+const EEDigiView& EEDigiScanner::view(void) const {
+
+  return view_;
+
+}
+
+const std::vector<EEDigiScanner::Frame>& EEDigiScanner::frames(void) const {
+
+  return frames_;
+
+}
+
+size_t EEDigiScanner::bytes(void) const {
+
+  return sizeof(*this) +
+    ( ism_.capacity() + ix_.capacity() + iy_.capacity() + ic_.capacity() + rtHalf_.capacity() ) * sizeof(int) +
+    frames_.capacity() * sizeof(Frame);
+
+}
@@ -0,0 +1,102 @@
+/*
+ * \file EEDigiView.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalDigi/interface/EEDataFrame.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDigiView.h"
+
+EEDigiView::EEDigiView() {
+
+  size_ = 0;
+
+}
+
+EEDigiView::~EEDigiView() {
+
+}
+
+EEDigiView& EEDigiView::shared(void) {
+
+  static EEDigiView view;
+
+  return view;
+
+}
+
+void EEDigiView::update(const edm::Event& e, const edm::Handle<EEDigiCollection>& digis) {
+
+  if ( e.id() == eventId_ && digis.id() == productId_ ) return;
+
+  eventId_ = e.id();
+  productId_ = digis.id();
+
+  int n = digis->size();
+
+  size_ = n;
+
+  if ( n == 0 ) return;
+
+  if ( int(hashedIndex_.size()) < n ) {
+    hashedIndex_.resize(n);
+    adc_.resize(nSamples * n);
+    gain_.resize(nSamples * n);
+  }
+
+  // split the 14 bit words into 12 bit ADC counts and 2 bit gain ids,
+  // sample-major: adc_[i*n+k] is sample i of frame k
+
+  for ( int k = 0; k < n; k++ ) {
+
+    EEDataFrame dataframe = (*digis)[k];
+
+    const uint16_t* samples = dataframe.frame().begin();
+
+    hashedIndex_[k] = EEDetId(dataframe.id()).hashedIndex();
+
+    for ( int i = 0; i < nSamples; i++ ) {
+      adc_[i * n + k] = samples[i] & 0xFFF;
+      gain_[i * n + k] = ( samples[i] >> 12 ) & 0x3;
+    }
+
+  }
+
+}
+
+int EEDigiView::size(void) const {
+
+  return size_;
+
+}
+
+const int* EEDigiView::hashedIndex(void) const {
+
+  return size_ ? &hashedIndex_[0] : 0;
+
+}
+
+const uint16_t* EEDigiView::adc(const int i) const {
+
+  return size_ ? &adc_[i * size_] : 0;
+
+}
+
+const uint8_t* EEDigiView::gain(const int i) const {
+
+  return size_ ? &gain_[i * size_] : 0;
+
+}
+
+size_t EEDigiView::bytes(void) const {
+
+  return sizeof(*this) +
+    hashedIndex_.capacity() * sizeof(int) +
+    adc_.capacity() * sizeof(uint16_t) +
+    gain_.capacity() * sizeof(uint8_t);
+
+}
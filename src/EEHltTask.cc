@@ -9,11 +9,10 @@
 
 #include <iostream>
 #include <fstream>
+#include <math.h>
 
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
-#include "FWCore/Framework/interface/ESHandle.h"
-#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
 
 #include "DQMServices/Core/interface/MonitorElement.h"
 
@@ -27,14 +26,14 @@
 #include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
 #include "DataFormats/EcalDetId/interface/EcalDetIdCollections.h"
 
+#include "DQM/EcalCommon/interface/Numbers.h"
+
 #include "DQM/EcalEndcapMonitorTasks/interface/EEHltTask.h"
 
-EEHltTask::EEHltTask(const edm::ParameterSet& ps){
+EEHltTask::EEHltTask(const edm::ParameterSet& ps) : integritySummary_(EEIntegritySummary::shared()) {
 
   init_ = false;
 
-  initGeometry_ = false;
-
   dqmStore_ = edm::Service<DQMStore>().operator->();
 
   prefixME_ = ps.getUntrackedParameter<std::string>("prefixME", "");
@@ -45,6 +44,12 @@ EEHltTask::EEHltTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
+  hltMode_ = ps.getUntrackedParameter<bool>("hltMode", false);
+
   EEDetIdCollection0_ =  ps.getParameter<edm::InputTag>("EEDetIdCollection0");
   EEDetIdCollection1_ =  ps.getParameter<edm::InputTag>("EEDetIdCollection1");
   EEDetIdCollection2_ =  ps.getParameter<edm::InputTag>("EEDetIdCollection2");
@@ -55,13 +60,28 @@ EEHltTask::EEHltTask(const edm::ParameterSet& ps){
   EcalElectronicsIdCollection4_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection4");
   EcalElectronicsIdCollection5_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection5");
   EcalElectronicsIdCollection6_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection6");
+
+  integrityCollections_[EEIntegritySummary::DCCSize] = EEDetIdCollection0_;
+  integrityCollections_[EEIntegritySummary::Gain] = EEDetIdCollection1_;
+  integrityCollections_[EEIntegritySummary::ChId] = EEDetIdCollection2_;
+  integrityCollections_[EEIntegritySummary::GainSwitch] = EEDetIdCollection3_;
+  integrityCollections_[EEIntegritySummary::TTId] = EcalElectronicsIdCollection1_;
+  integrityCollections_[EEIntegritySummary::BlockSize] = EcalElectronicsIdCollection2_;
+  integrityCollections_[EEIntegritySummary::MemTTId] = EcalElectronicsIdCollection3_;
+  integrityCollections_[EEIntegritySummary::MemBlockSize] = EcalElectronicsIdCollection4_;
+  integrityCollections_[EEIntegritySummary::MemChId] = EcalElectronicsIdCollection5_;
+  integrityCollections_[EEIntegritySummary::MemGain] = EcalElectronicsIdCollection6_;
   FEDRawDataCollection_ = ps.getParameter<edm::InputTag>("FEDRawDataCollection");
 
   meEEFedsOccupancy_ = 0;
   meEEFedsSizeErrors_ = 0;
   meEEFedsIntegrityErrors_ = 0;
 
-  map = 0;
+  for ( int i = 0; i < 54; i++ ) {
+    nFedsOccupancy_[i].entries = nFedsOccupancy_[i].sumw = nFedsOccupancy_[i].sumw2 = 0.;
+    nFedsSizeErrors_[i].entries = nFedsSizeErrors_[i].sumw = nFedsSizeErrors_[i].sumw2 = 0.;
+    nFedsIntegrityErrors_[i].entries = nFedsIntegrityErrors_[i].sumw = nFedsIntegrityErrors_[i].sumw2 = 0.;
+  }
 
 }
 
@@ -82,7 +102,7 @@ void EEHltTask::beginJob(void){
 
 void EEHltTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
-  initGeometry(c);
+  Numbers::initGeometry(c, false);
 
   if ( ! mergeRuns_ ) this->reset();
 
@@ -90,20 +110,40 @@ void EEHltTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
 void EEHltTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
+  if ( hltMode_ ) this->flush();
+
+}
+
+void EEHltTask::endLuminosityBlock(const edm::LuminosityBlock& lumiBlock, const edm::EventSetup& iSetup) {
+
+  if ( hltMode_ ) this->flush();
+
+  instrumentation_.endLumi();
+
 }
 
 void EEHltTask::reset(void) {
 
+  instrumentation_.reset();
+
   if ( meEEFedsOccupancy_ ) meEEFedsOccupancy_->Reset();
   if ( meEEFedsSizeErrors_ ) meEEFedsSizeErrors_->Reset();
   if ( meEEFedsIntegrityErrors_ ) meEEFedsIntegrityErrors_->Reset();
 
+  for ( int i = 0; i < 54; i++ ) {
+    nFedsOccupancy_[i].entries = nFedsOccupancy_[i].sumw = nFedsOccupancy_[i].sumw2 = 0.;
+    nFedsSizeErrors_[i].entries = nFedsSizeErrors_[i].sumw = nFedsSizeErrors_[i].sumw2 = 0.;
+    nFedsIntegrityErrors_[i].entries = nFedsIntegrityErrors_[i].sumw = nFedsIntegrityErrors_[i].sumw2 = 0.;
+  }
+
 }
 
 void EEHltTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEHltTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -120,12 +160,17 @@ void EEHltTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEHltTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/" + folderName_);
 
@@ -148,322 +193,186 @@ void EEHltTask::endJob(void){
 
   edm::LogInfo("EEHltTask") << "analyzed " << ievt_ << " events";
 
-  if ( enableCleanup_ ) this->cleanup();
-
-}
-
-void EEHltTask::analyze(const edm::Event& e, const edm::EventSetup& c){
+  if ( hltMode_ ) this->flush();
 
-  if ( ! init_ ) this->setup();
-
-  ievt_++;
-
-  // ECAL endcap FEDs
-  int EEFirstFED[2];
-  EEFirstFED[0] = 601; // EE-
-  EEFirstFED[1] = 646; // EE+
-
-  int FedsSizeErrors[18];
-  for ( int i=0; i<18; i++ ) FedsSizeErrors[i]=0;
-
-  edm::Handle<EEDetIdCollection> ids0;
-
-  if ( e.getByLabel(EEDetIdCollection0_, ids0) ) {
-
-    for ( EEDetIdCollection::const_iterator idItr = ids0->begin(); idItr != ids0->end(); ++idItr ) {
-
-      int ism = iSM( *idItr );
-
-      if ( ism > -1 ) FedsSizeErrors[ism-1]++;
-
-    }
-
-  } else {
-
-//    edm::LogWarning("EEHltTask") << EEDetIdCollection0_ << " not available";
-
-  }
+  this->reportMemory("endJob");
 
-  edm::Handle<FEDRawDataCollection> allFedRawData;
-
-  if ( e.getByLabel(FEDRawDataCollection_, allFedRawData) ) {
-
-    for(int zside=0; zside<2; zside++) {
-
-      int firstFedOnSide=EEFirstFED[zside];
-
-      for ( int ism=1; ism<=9; ism++ ) {
-
-	const FEDRawData& fedData = allFedRawData->FEDData( firstFedOnSide + ism - 1 );
-
-	int length = fedData.size()/sizeof(uint64_t);
-
-	if ( length > 0 ) {
-
-	  if ( meEEFedsOccupancy_ ) meEEFedsOccupancy_->Fill( firstFedOnSide + ism - 1 );
-
-	  uint64_t * pData = (uint64_t *)(fedData.data());
-	  uint64_t * fedTrailer = pData + (length - 1);
-	  bool crcError = (*fedTrailer >> 2 ) & 0x1;
-
-	  if (crcError) FedsSizeErrors[zside * 9 + ism-1]++;
-
-	}
+  if ( enableCleanup_ ) this->cleanup();
 
-      }
+}
 
-    }
+void EEHltTask::reportMemory(const std::string& when) {
 
-  } else {
-    edm::LogWarning("EEHltTask") << FEDRawDataCollection_ << " not available";
-  }
+  if ( ! memoryReport_.enabled() ) return;
 
+  memoryReport_.clear();
 
-  for( int ism=1; ism<=18; ism++ ) {
+  memoryReport_.add("nFedsOccupancy_", sizeof(nFedsOccupancy_));
+  memoryReport_.add("nFedsSizeErrors_", sizeof(nFedsSizeErrors_));
+  memoryReport_.add("nFedsIntegrityErrors_", sizeof(nFedsIntegrityErrors_));
+  memoryReport_.add("integritySummary_ (shared)", &integritySummary_, 1);
 
-    if ( FedsSizeErrors[ism-1] != 0 ) {
+  memoryReport_.report(dqmStore_, prefixME_, folderName_, "EEHltTask", when);
 
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+}
 
-      if ( meEEFedsSizeErrors_ ) meEEFedsSizeErrors_->Fill( fednumber );
+void EEHltTask::fillFed(MonitorElement* me, FedCounts* counts, int fednumber, double w, int n) {
 
+  if ( hltMode_ ) {
+    if ( fednumber >= 601 && fednumber <= 654 ) {
+      FedCounts& c = counts[fednumber - 601];
+      c.entries += n;
+      c.sumw += n * w;
+      c.sumw2 += n * w * w;
     }
-
+    return;
   }
 
-
-  // Integrity errors
-  edm::Handle<EEDetIdCollection> ids1;
-
-  if ( e.getByLabel(EEDetIdCollection1_, ids1) ) {
-
-    for ( EEDetIdCollection::const_iterator idItr = ids1->begin(); idItr != ids1->end(); ++idItr ) {
-
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
-
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
-
-    }
-
-  } else {
-
-    edm::LogWarning("EEHltTask") << EEDetIdCollection1_ << " not available";
-
+  if ( me ) {
+    for ( int i = 0; i < n; i++ ) me->Fill( fednumber, w );
   }
 
-  edm::Handle<EEDetIdCollection> ids2;
+}
 
-  if ( e.getByLabel(EEDetIdCollection2_, ids2) ) {
+void EEHltTask::flush(void) {
 
-    for ( EEDetIdCollection::const_iterator idItr = ids2->begin(); idItr != ids2->end(); ++idItr ) {
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Flush);
 
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+  this->flushFeds( meEEFedsOccupancy_, nFedsOccupancy_, false );
+  this->flushFeds( meEEFedsSizeErrors_, nFedsSizeErrors_, false );
+  this->flushFeds( meEEFedsIntegrityErrors_, nFedsIntegrityErrors_, true );
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
+}
 
-    }
+void EEHltTask::flushFeds(MonitorElement* me, FedCounts* counts, bool weighted) {
 
-  } else {
+  double total = 0.;
 
-    edm::LogWarning("EEHltTask") << EEDetIdCollection2_ << " not available";
+  for ( int i = 0; i < 54; i++ ) total += counts[i].entries;
 
-  }
+  if ( me && total > 0. ) {
 
-  edm::Handle<EEDetIdCollection> ids3;
+    // setBinContent() counts an entry per call
+    double entries = me->getEntries();
 
-  if ( e.getByLabel(EEDetIdCollection3_, ids3) ) {
+    for ( int i = 0; i < 54; i++ ) {
 
-    for ( EEDetIdCollection::const_iterator idItr = ids3->begin(); idItr != ids3->end(); ++idItr ) {
+      if ( counts[i].entries == 0. ) continue;
 
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+      int bin = i + 1;
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
+      if ( weighted ) {
+        double error = me->getBinError(bin);
+        me->setBinContent( bin, me->getBinContent(bin) + counts[i].sumw );
+        me->setBinError( bin, sqrt( error * error + counts[i].sumw2 ) );
+      } else {
+        me->setBinContent( bin, me->getBinContent(bin) + counts[i].sumw );
+      }
 
     }
 
-  } else {
-
-    edm::LogWarning("EEHltTask") << EEDetIdCollection3_ << " not available";
+    me->setEntries( entries + total );
 
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids4;
+  for ( int i = 0; i < 54; i++ ) counts[i].entries = counts[i].sumw = counts[i].sumw2 = 0.;
 
-  if ( e.getByLabel(EcalElectronicsIdCollection1_, ids4) ) {
+}
 
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids4->begin(); idItr != ids4->end(); ++idItr ) {
+void EEHltTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
-      if ( subDet( *idItr ) != EcalEndcap ) continue;
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
 
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+  if ( ! init_ ) this->setup();
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./34.);
+  ievt_++;
 
-    }
+  // ECAL endcap FEDs
+  int EEFirstFED[2];
+  EEFirstFED[0] = 601; // EE-
+  EEFirstFED[1] = 646; // EE+
 
-  } else {
+  int FedsSizeErrors[18];
+  for ( int i=0; i<18; i++ ) FedsSizeErrors[i]=0;
 
-    edm::LogWarning("EEHltTask") << EcalElectronicsIdCollection1_ << " not available";
+  integritySummary_.update(e, c, integrityCollections_);
 
+  for ( int ism=1; ism<=18; ism++ ) {
+    FedsSizeErrors[ism-1] += integritySummary_.nIds(EEIntegritySummary::DCCSize, ism);
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids5;
-
-  if ( e.getByLabel(EcalElectronicsIdCollection2_, ids5) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids5->begin(); idItr != ids5->end(); ++idItr ) {
-
-      if ( subDet( *idItr ) != EcalEndcap ) continue;
+  edm::Handle<FEDRawDataCollection> allFedRawData;
 
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+  if ( instrumentation_.getByLabel(e, FEDRawDataCollection_, allFedRawData) ) {
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
+    for(int zside=0; zside<2; zside++) {
 
-    }
+      int firstFedOnSide=EEFirstFED[zside];
 
-  } else {
+      for ( int ism=1; ism<=9; ism++ ) {
 
-    edm::LogWarning("EEHltTask") << EcalElectronicsIdCollection2_ << " not available";
+	const FEDRawData& fedData = allFedRawData->FEDData( firstFedOnSide + ism - 1 );
 
-  }
+	int length = fedData.size()/sizeof(uint64_t);
 
-  edm::Handle<EcalElectronicsIdCollection> ids6;
+	if ( length > 0 ) {
 
-  if ( e.getByLabel(EcalElectronicsIdCollection3_, ids6) ) {
+	  this->fillFed( meEEFedsOccupancy_, nFedsOccupancy_, firstFedOnSide + ism - 1 );
 
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids6->begin(); idItr != ids6->end(); ++idItr ) {
+	  uint64_t * pData = (uint64_t *)(fedData.data());
+	  uint64_t * fedTrailer = pData + (length - 1);
+	  bool crcError = (*fedTrailer >> 2 ) & 0x1;
 
-      if ( subDet( *idItr ) != EcalEndcap ) continue;
+	  if (crcError) FedsSizeErrors[zside * 9 + ism-1]++;
 
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+	}
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./34.);
+      }
 
     }
 
   } else {
-
-    edm::LogWarning("EEHltTask") << EcalElectronicsIdCollection3_ << " not available";
-
+    if ( ! hltMode_ ) edm::LogWarning("EEHltTask") << FEDRawDataCollection_ << " not available";
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids7;
 
-  if ( e.getByLabel(EcalElectronicsIdCollection4_, ids7) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids7->begin(); idItr != ids7->end(); ++idItr ) {
+  for( int ism=1; ism<=18; ism++ ) {
 
-      if ( subDet( *idItr ) != EcalEndcap ) continue;
+    if ( FedsSizeErrors[ism-1] != 0 ) {
 
-      int ism = iSM( *idItr );
       int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
+      this->fillFed( meEEFedsSizeErrors_, nFedsSizeErrors_, fednumber );
 
     }
 
-  } else {
-
-    edm::LogWarning("EEHltTask") << EcalElectronicsIdCollection4_ << " not available";
-
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids8;
-
-  if ( e.getByLabel(EcalElectronicsIdCollection5_, ids8) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids8->begin(); idItr != ids8->end(); ++idItr ) {
-
-      if ( subDet( *idItr ) != EcalEndcap ) continue;
-
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
-
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
 
+  // Integrity errors
+  if ( ! hltMode_ ) {
+    for ( int t = EEIntegritySummary::Gain; t <= EEIntegritySummary::MemGain; t++ ) {
+      if ( ! integritySummary_.found(t) ) edm::LogWarning("EEHltTask") << integrityCollections_[t] << " not available";
     }
-
-  } else {
-
-    edm::LogWarning("EEHltTask") << EcalElectronicsIdCollection5_ << " not available";
-
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids9;
+  // fraction of the FED in error per id
+  static const double weight[EEIntegritySummary::nTypes] = {
+    0., 1./850., 1./850., 1./850., 1./34., 1./850., 1./34., 1./850., 1./850., 1./850.
+  };
 
-  if ( e.getByLabel(EcalElectronicsIdCollection6_, ids9) ) {
+  for( int ism=1; ism<=18; ism++ ) {
 
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids9->begin(); idItr != ids9->end(); ++idItr ) {
+    int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
 
-      if ( subDet( *idItr ) != EcalEndcap ) continue;
+    for ( int t = EEIntegritySummary::Gain; t <= EEIntegritySummary::MemGain; t++ ) {
 
-      int ism = iSM( *idItr );
-      int fednumber = ( ism < 10 ) ? 600 + ism : 636 + ism;
+      int nIds = integritySummary_.nIds(t, ism);
 
-      if ( ism > -1 ) meEEFedsIntegrityErrors_->Fill( fednumber, 1./850.);
+      if ( nIds > 0 ) this->fillFed( meEEFedsIntegrityErrors_, nFedsIntegrityErrors_, fednumber, weight[t], nIds );
 
     }
 
-  } else {
-
-    edm::LogWarning("EEHltTask") << EcalElectronicsIdCollection6_ << " not available";
-
   }
 
 }
-
-//-------------------------------------------------------------------------
-
-void EEHltTask::initGeometry( const edm::EventSetup& setup ) {
-
-  if( initGeometry_ ) return;
-
-  initGeometry_ = true;
-
-  edm::ESHandle< EcalElectronicsMapping > handle;
-  setup.get< EcalMappingRcd >().get(handle);
-  map = handle.product();
-
-  if( ! map ) edm::LogWarning("EEHltTask") << "EcalElectronicsMapping not available";
-
-}
-
-int EEHltTask::iSM( const EEDetId& id ) {
-
-  if( ! map ) return -1;
-
-  EcalElectronicsId eid = map->getElectronicsId(id);
-  int idcc = eid.dccId();
-
-  // EE-
-  if( idcc >=  1 && idcc <=  9 ) return( idcc );
-
-  // EE+
-  if( idcc >= 46 && idcc <= 54 ) return( idcc - 45 + 9 );
-
-  edm::LogWarning("EEHltTask") << "Wrong DCC id: dcc = " << idcc;
-  return -1;
-
-}
-
-int EEHltTask::iSM( const EcalElectronicsId& id ) {
-
-  int idcc = id.dccId();
-
-  // EE-
-  if( idcc >=  1 && idcc <=  9 ) return( idcc );
-
-  // EE+
-  if( idcc >= 46 && idcc <= 54 ) return( idcc - 45 + 9 );
-
-  edm::LogWarning("EEHltTask") << "Wrong DCC id: dcc = " << idcc;
-  return -1;
-
-}
-
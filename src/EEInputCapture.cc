@@ -0,0 +1,415 @@
+/*
+ * \file EEInputCapture.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include <string.h>
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/EcalDetId/interface/EcalDetIdCollections.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputCapture.h"
+
+EEInputCapture::EEInputCapture(const edm::ParameterSet& ps){
+
+  ievt_ = 0;
+
+  fileName_ = ps.getUntrackedParameter<std::string>("fileName", "EEInput.bin");
+
+  EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
+  EcalTrigPrimDigiCollection_ = ps.getParameter<edm::InputTag>("EcalTrigPrimDigiCollection");
+  EESRFlagCollection_ = ps.getParameter<edm::InputTag>("EESRFlagCollection");
+  EcalUncalibratedRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalUncalibratedRecHitCollection");
+  EcalRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalRecHitCollection");
+  EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
+  EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
+  EEDetIdCollection_[0] = ps.getParameter<edm::InputTag>("EEDetIdCollection0");
+  EEDetIdCollection_[1] = ps.getParameter<edm::InputTag>("EEDetIdCollection1");
+  EEDetIdCollection_[2] = ps.getParameter<edm::InputTag>("EEDetIdCollection2");
+  EEDetIdCollection_[3] = ps.getParameter<edm::InputTag>("EEDetIdCollection3");
+  EcalElectronicsIdCollection_[0] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection1");
+  EcalElectronicsIdCollection_[1] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection2");
+  EcalElectronicsIdCollection_[2] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection3");
+  EcalElectronicsIdCollection_[3] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection4");
+  EcalElectronicsIdCollection_[4] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection5");
+  EcalElectronicsIdCollection_[5] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection6");
+  FEDRawDataCollection_ = ps.getParameter<edm::InputTag>("FEDRawDataCollection");
+
+  section_ = 0;
+  nSections_ = 0;
+
+}
+
+EEInputCapture::~EEInputCapture(){
+
+}
+
+void EEInputCapture::beginJob(void){
+
+  ievt_ = 0;
+
+  file_.open(fileName_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if ( ! file_ ) {
+    throw cms::Exception("EEInputCapture") << "cannot open " << fileName_;
+  }
+
+  uint32_t header[EEInputFormat::fileHeaderSize] = { EEInputFormat::magic, EEInputFormat::version };
+
+  file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+}
+
+void EEInputCapture::endJob(void){
+
+  if ( file_.is_open() ) file_.close();
+
+  edm::LogInfo("EEInputCapture") << ievt_ << " events written to " << fileName_;
+
+}
+
+void EEInputCapture::beginSection(int type, int index) {
+
+  section_ = buffer_.size();
+
+  put( uint32_t(type) );
+  put( uint32_t(index) );
+  put( uint32_t(0) );
+  put( uint32_t(0) );
+
+}
+
+void EEInputCapture::endSection(int count) {
+
+  buffer_[section_+2] = count;
+  buffer_[section_+3] = buffer_.size() - section_ - EEInputFormat::sectionHeaderSize;
+
+  nSections_++;
+
+}
+
+void EEInputCapture::put(uint32_t word) {
+
+  buffer_.push_back(word);
+
+}
+
+void EEInputCapture::put(float value) {
+
+  uint32_t word;
+  memcpy(&word, &value, sizeof(word));
+
+  buffer_.push_back(word);
+
+}
+
+void EEInputCapture::put(const uint16_t* data, int n) {
+
+  for ( int i = 0; i < n; i += 2 ) {
+    uint32_t word = data[i];
+    if ( i+1 < n ) word |= uint32_t(data[i+1]) << 16;
+    buffer_.push_back(word);
+  }
+
+}
+
+void EEInputCapture::put(const std::vector<short>& data) {
+
+  put( uint32_t(data.size()) );
+
+  for ( unsigned int i = 0; i < data.size(); i += 2 ) {
+    uint32_t word = uint16_t(data[i]);
+    if ( i+1 < data.size() ) word |= uint32_t(uint16_t(data[i+1])) << 16;
+    buffer_.push_back(word);
+  }
+
+}
+
+void EEInputCapture::analyze(const edm::Event& e, const edm::EventSetup& c){
+
+  ievt_++;
+
+  buffer_.clear();
+  nSections_ = 0;
+
+  put( uint32_t(0) );
+  put( uint32_t(e.id().run()) );
+  put( uint32_t(e.id().luminosityBlock()) );
+  put( uint32_t(e.id().event()) );
+  put( uint32_t(0) );
+
+  edm::Handle<EEDigiCollection> digis;
+
+  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+
+    beginSection(EEInputFormat::Digis, 0);
+
+    for ( unsigned int n = 0; n < digis->size(); n++ ) {
+
+      EEDataFrame dataframe = (*digis)[n];
+
+      put( uint32_t(dataframe.id().rawId()) );
+      put( dataframe.frame().begin(), EEDataFrame::MAXSAMPLES );
+
+    }
+
+    endSection(digis->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EEDigiCollection_ << " not available";
+
+  }
+
+  edm::Handle<EcalTrigPrimDigiCollection> tps;
+
+  if ( e.getByLabel(EcalTrigPrimDigiCollection_, tps) ) {
+
+    beginSection(EEInputFormat::TrigPrims, 0);
+
+    for ( EcalTrigPrimDigiCollection::const_iterator tpItr = tps->begin(); tpItr != tps->end(); ++tpItr ) {
+
+      put( uint32_t(tpItr->id().rawId()) );
+      put( uint32_t(tpItr->size()) );
+
+      std::vector<uint16_t> samples(tpItr->size());
+      for ( int i = 0; i < tpItr->size(); i++ ) samples[i] = tpItr->sample(i).raw();
+      if ( samples.size() ) put( &samples[0], samples.size() );
+
+    }
+
+    endSection(tps->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EcalTrigPrimDigiCollection_ << " not available";
+
+  }
+
+  edm::Handle<EESrFlagCollection> srFlags;
+
+  if ( e.getByLabel(EESRFlagCollection_, srFlags) ) {
+
+    beginSection(EEInputFormat::SrFlags, 0);
+
+    for ( EESrFlagCollection::const_iterator srItr = srFlags->begin(); srItr != srFlags->end(); ++srItr ) {
+
+      put( uint32_t(srItr->id().rawId()) );
+      put( uint32_t(srItr->value()) );
+
+    }
+
+    endSection(srFlags->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EESRFlagCollection_ << " not available";
+
+  }
+
+  edm::Handle<EcalUncalibratedRecHitCollection> uhits;
+
+  if ( e.getByLabel(EcalUncalibratedRecHitCollection_, uhits) ) {
+
+    beginSection(EEInputFormat::UncalibRecHits, 0);
+
+    for ( EcalUncalibratedRecHitCollection::const_iterator hitItr = uhits->begin(); hitItr != uhits->end(); ++hitItr ) {
+
+      put( uint32_t(hitItr->id().rawId()) );
+      put( hitItr->amplitude() );
+      put( hitItr->pedestal() );
+      put( hitItr->jitter() );
+      put( hitItr->chi2() );
+      put( hitItr->flags() );
+      put( hitItr->aux() );
+
+    }
+
+    endSection(uhits->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EcalUncalibratedRecHitCollection_ << " not available";
+
+  }
+
+  edm::Handle<EcalRecHitCollection> hits;
+
+  if ( e.getByLabel(EcalRecHitCollection_, hits) ) {
+
+    beginSection(EEInputFormat::RecHits, 0);
+
+    for ( EcalRecHitCollection::const_iterator hitItr = hits->begin(); hitItr != hits->end(); ++hitItr ) {
+
+      put( uint32_t(hitItr->id().rawId()) );
+      put( hitItr->energy() );
+      put( hitItr->time() );
+      put( hitItr->flags() );
+      put( hitItr->flagBits() );
+      put( hitItr->aux() );
+
+    }
+
+    endSection(hits->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EcalRecHitCollection_ << " not available";
+
+  }
+
+  edm::Handle<EcalPnDiodeDigiCollection> pns;
+
+  if ( e.getByLabel(EcalPnDiodeDigiCollection_, pns) ) {
+
+    beginSection(EEInputFormat::PnDigis, 0);
+
+    for ( EcalPnDiodeDigiCollection::const_iterator pnItr = pns->begin(); pnItr != pns->end(); ++pnItr ) {
+
+      put( uint32_t(pnItr->id().rawId()) );
+      put( uint32_t(pnItr->size()) );
+
+      std::vector<uint16_t> samples(pnItr->size());
+      for ( int i = 0; i < pnItr->size(); i++ ) samples[i] = pnItr->sample(i).raw();
+      if ( samples.size() ) put( &samples[0], samples.size() );
+
+    }
+
+    endSection(pns->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EcalPnDiodeDigiCollection_ << " not available";
+
+  }
+
+  edm::Handle<EcalRawDataCollection> dcchs;
+
+  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
+
+    beginSection(EEInputFormat::DccHeaders, 0);
+
+    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+
+      put( uint32_t(dcchItr->id()) );
+      put( uint32_t(dcchItr->fedId()) );
+      put( uint32_t(dcchItr->getRunNumber()) );
+      put( uint32_t(dcchItr->getLV1()) );
+      put( uint32_t(dcchItr->getBX()) );
+      put( uint32_t(dcchItr->getOrbit()) );
+      put( uint32_t(dcchItr->getBasicTriggerType()) );
+      put( uint32_t(dcchItr->getRunType()) );
+      put( uint32_t(dcchItr->getRtHalf()) );
+      put( uint32_t(dcchItr->getMgpaGain()) );
+      put( uint32_t(dcchItr->getMemGain()) );
+      put( uint32_t(dcchItr->getSRPBx()) );
+      put( uint32_t(dcchItr->getSRPLv1()) );
+
+      EcalDCCHeaderBlock::EcalDCCEventSettings settings = dcchItr->getEventSettings();
+      put( uint32_t(settings.LaserPower) );
+      put( uint32_t(settings.LaserFilter) );
+      put( uint32_t(settings.wavelength) );
+      put( uint32_t(settings.delay) );
+      put( uint32_t(settings.MEMVinj) );
+      put( uint32_t(settings.mgpa_content) );
+      put( uint32_t(settings.ped_offset) );
+
+      put( dcchItr->getFEStatus() );
+      put( dcchItr->getFEBxs() );
+      put( dcchItr->getFELv1() );
+      put( dcchItr->getTCCBx() );
+      put( dcchItr->getTCCLv1() );
+
+    }
+
+    endSection(dcchs->size());
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << EcalRawDataCollection_ << " not available";
+
+  }
+
+  for ( int i = 0; i < EEInputFormat::nDetIdErrors; i++ ) {
+
+    edm::Handle<EEDetIdCollection> ids;
+
+    if ( e.getByLabel(EEDetIdCollection_[i], ids) ) {
+
+      beginSection(EEInputFormat::DetIdErrors, i);
+
+      for ( EEDetIdCollection::const_iterator idItr = ids->begin(); idItr != ids->end(); ++idItr ) put( uint32_t(idItr->rawId()) );
+
+      endSection(ids->size());
+
+    } else {
+
+      edm::LogWarning("EEInputCapture") << EEDetIdCollection_[i] << " not available";
+
+    }
+
+  }
+
+  for ( int i = 0; i < EEInputFormat::nElectronicsIdErrors; i++ ) {
+
+    edm::Handle<EcalElectronicsIdCollection> ids;
+
+    if ( e.getByLabel(EcalElectronicsIdCollection_[i], ids) ) {
+
+      beginSection(EEInputFormat::ElectronicsIdErrors, i);
+
+      for ( EcalElectronicsIdCollection::const_iterator idItr = ids->begin(); idItr != ids->end(); ++idItr ) put( uint32_t(idItr->rawId()) );
+
+      endSection(ids->size());
+
+    } else {
+
+      edm::LogWarning("EEInputCapture") << EcalElectronicsIdCollection_[i] << " not available";
+
+    }
+
+  }
+
+  edm::Handle<FEDRawDataCollection> raw;
+
+  if ( e.getByLabel(FEDRawDataCollection_, raw) ) {
+
+    for ( int i = 0; i < EEInputFormat::nFeds; i++ ) {
+
+      int fedId = EEInputFormat::fedId(i);
+
+      const FEDRawData& fedData = raw->FEDData(fedId);
+
+      beginSection(EEInputFormat::FedBuffers, fedId);
+
+      // the byte count is the item count, padded to whole words
+      buffer_.resize(buffer_.size() + (fedData.size()+3)/4, 0);
+      if ( fedData.size() ) memcpy(&buffer_[section_+EEInputFormat::sectionHeaderSize], fedData.data(), fedData.size());
+
+      endSection(fedData.size());
+
+    }
+
+  } else {
+
+    edm::LogWarning("EEInputCapture") << FEDRawDataCollection_ << " not available";
+
+  }
+
+  buffer_[0] = buffer_.size();
+  buffer_[4] = nSections_;
+
+  file_.write(reinterpret_cast<const char*>(&buffer_[0]), buffer_.size()*sizeof(uint32_t));
+
+}
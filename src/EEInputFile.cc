@@ -0,0 +1,88 @@
+/*
+ * \file EEInputFile.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFormat.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFile.h"
+
+EEInputFile::EEInputFile(const std::string& fileName) {
+
+  file_ = 0;
+  size_ = 0;
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+
+  if ( fd < 0 ) {
+    throw cms::Exception("EEInputFile") << "cannot open " << fileName;
+  }
+
+  struct stat st;
+
+  if ( fstat(fd, &st) != 0 || st.st_size < off_t(EEInputFormat::fileHeaderSize*sizeof(uint32_t)) ) {
+    close(fd);
+    throw cms::Exception("EEInputFile") << fileName << " is not an EEInputCapture file";
+  }
+
+  void* map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  close(fd);
+
+  if ( map == MAP_FAILED ) {
+    throw cms::Exception("EEInputFile") << "cannot map " << fileName;
+  }
+
+  file_ = static_cast<const uint32_t*>(map);
+  size_ = st.st_size/sizeof(uint32_t);
+
+  if ( file_[0] != EEInputFormat::magic || file_[1] != EEInputFormat::version ) {
+    munmap(const_cast<uint32_t*>(file_), size_*sizeof(uint32_t));
+    throw cms::Exception("EEInputFile") << fileName << " is not an EEInputCapture file, version " << EEInputFormat::version;
+  }
+
+}
+
+EEInputFile::~EEInputFile() {
+
+  if ( file_ ) munmap(const_cast<uint32_t*>(file_), size_*sizeof(uint32_t));
+
+}
+
+size_t EEInputFile::first(void) const {
+
+  return EEInputFormat::fileHeaderSize;
+
+}
+
+size_t EEInputFile::next(size_t event) const {
+
+  return event + file_[event];
+
+}
+
+bool EEInputFile::valid(size_t event) const {
+
+  if ( event + EEInputFormat::eventHeaderSize > size_ ) return false;
+
+  if ( file_[event] < uint32_t(EEInputFormat::eventHeaderSize) ) return false;
+
+  return event + file_[event] <= size_;
+
+}
+
+edm::EventID EEInputFile::id(size_t event) const {
+
+  return edm::EventID(file_[event+1], file_[event+2], file_[event+3]);
+
+}
@@ -0,0 +1,496 @@
+/*
+ * \file EEInputReplay.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include <memory>
+#include <string.h>
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/EcalDetId/interface/EcalDetIdCollections.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputReplay.h"
+
+static bool fits(const uint32_t* p, const uint32_t* end, size_t n) {
+
+  return p <= end && n <= size_t(end - p);
+
+}
+
+static float getFloat(const uint32_t* p) {
+
+  float value;
+  memcpy(&value, p, sizeof(value));
+
+  return value;
+
+}
+
+static const uint32_t* getShorts(const uint32_t* p, uint16_t* data, int n) {
+
+  for ( int i = 0; i < n; i++ ) data[i] = ( p[i/2] >> (16*(i%2)) ) & 0xffff;
+
+  return p + (n+1)/2;
+
+}
+
+static const uint32_t* getShorts(const uint32_t* p, const uint32_t* end, std::vector<short>& data) {
+
+  if ( ! p || p >= end || (size_t(*p)+1)/2 > size_t(end - p - 1) ) return 0;
+
+  data.resize(*p++);
+
+  for ( unsigned int i = 0; i < data.size(); i++ ) data[i] = short( ( p[i/2] >> (16*(i%2)) ) & 0xffff );
+
+  return p + (data.size()+1)/2;
+
+}
+
+EEInputReplay::EEInputReplay(const edm::ParameterSet& ps){
+
+  ievt_ = 0;
+
+  fileName_ = ps.getUntrackedParameter<std::string>("fileName", "EEInput.bin");
+
+  label_ = ps.getParameter<std::string>("@module_label");
+
+  EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
+  EcalTrigPrimDigiCollection_ = ps.getParameter<edm::InputTag>("EcalTrigPrimDigiCollection");
+  EESRFlagCollection_ = ps.getParameter<edm::InputTag>("EESRFlagCollection");
+  EcalUncalibratedRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalUncalibratedRecHitCollection");
+  EcalRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalRecHitCollection");
+  EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
+  EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
+  EEDetIdCollection_[0] = ps.getParameter<edm::InputTag>("EEDetIdCollection0");
+  EEDetIdCollection_[1] = ps.getParameter<edm::InputTag>("EEDetIdCollection1");
+  EEDetIdCollection_[2] = ps.getParameter<edm::InputTag>("EEDetIdCollection2");
+  EEDetIdCollection_[3] = ps.getParameter<edm::InputTag>("EEDetIdCollection3");
+  EcalElectronicsIdCollection_[0] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection1");
+  EcalElectronicsIdCollection_[1] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection2");
+  EcalElectronicsIdCollection_[2] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection3");
+  EcalElectronicsIdCollection_[3] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection4");
+  EcalElectronicsIdCollection_[4] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection5");
+  EcalElectronicsIdCollection_[5] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection6");
+  FEDRawDataCollection_ = ps.getParameter<edm::InputTag>("FEDRawDataCollection");
+
+  produceDigis_ = EEDigiCollection_.label() == label_;
+  if ( produceDigis_ ) produces<EEDigiCollection>(EEDigiCollection_.instance());
+
+  produceTrigPrims_ = EcalTrigPrimDigiCollection_.label() == label_;
+  if ( produceTrigPrims_ ) produces<EcalTrigPrimDigiCollection>(EcalTrigPrimDigiCollection_.instance());
+
+  produceSrFlags_ = EESRFlagCollection_.label() == label_;
+  if ( produceSrFlags_ ) produces<EESrFlagCollection>(EESRFlagCollection_.instance());
+
+  produceUncalibRecHits_ = EcalUncalibratedRecHitCollection_.label() == label_;
+  if ( produceUncalibRecHits_ ) produces<EcalUncalibratedRecHitCollection>(EcalUncalibratedRecHitCollection_.instance());
+
+  produceRecHits_ = EcalRecHitCollection_.label() == label_;
+  if ( produceRecHits_ ) produces<EcalRecHitCollection>(EcalRecHitCollection_.instance());
+
+  producePnDigis_ = EcalPnDiodeDigiCollection_.label() == label_;
+  if ( producePnDigis_ ) produces<EcalPnDiodeDigiCollection>(EcalPnDiodeDigiCollection_.instance());
+
+  produceDccHeaders_ = EcalRawDataCollection_.label() == label_;
+  if ( produceDccHeaders_ ) produces<EcalRawDataCollection>(EcalRawDataCollection_.instance());
+
+  for ( int i = 0; i < EEInputFormat::nDetIdErrors; i++ ) {
+    produceDetIdErrors_[i] = EEDetIdCollection_[i].label() == label_;
+    if ( produceDetIdErrors_[i] ) produces<EEDetIdCollection>(EEDetIdCollection_[i].instance());
+  }
+
+  for ( int i = 0; i < EEInputFormat::nElectronicsIdErrors; i++ ) {
+    produceElectronicsIdErrors_[i] = EcalElectronicsIdCollection_[i].label() == label_;
+    if ( produceElectronicsIdErrors_[i] ) produces<EcalElectronicsIdCollection>(EcalElectronicsIdCollection_[i].instance());
+  }
+
+  produceFedBuffers_ = FEDRawDataCollection_.label() == label_;
+  if ( produceFedBuffers_ ) produces<FEDRawDataCollection>(FEDRawDataCollection_.instance());
+
+  file_ = 0;
+  event_ = 0;
+
+}
+
+EEInputReplay::~EEInputReplay(){
+
+  delete file_;
+
+}
+
+void EEInputReplay::beginJob(void){
+
+  ievt_ = 0;
+
+  if ( ! file_ ) file_ = new EEInputFile(fileName_);
+
+  index_.clear();
+
+  size_t event = file_->first();
+
+  for ( ; file_->valid(event); event = file_->next(event) ) index_.insert(std::make_pair(file_->id(event), event));
+
+  if ( event != file_->end() ) {
+    edm::LogWarning("EEInputReplay") << fileName_ << " is truncated or corrupt at word " << event << ", the events after it are not replayed";
+  }
+
+  if ( index_.empty() ) {
+    throw cms::Exception("EEInputReplay") << fileName_ << " has no valid events";
+  }
+
+}
+
+void EEInputReplay::endJob(void){
+
+  edm::LogInfo("EEInputReplay") << ievt_ << " events replayed from " << fileName_;
+
+}
+
+const uint32_t* EEInputReplay::section(int type, int index, int& count, const uint32_t*& end) const {
+
+  const uint32_t* file = file_->data();
+
+  const uint32_t* p = file + event_ + EEInputFormat::eventHeaderSize;
+  const uint32_t* last = file + event_ + file[event_];
+
+  uint32_t nSections = file[event_+4];
+
+  count = 0;
+  end = 0;
+
+  for ( uint32_t i = 0; i < nSections; i++ ) {
+
+    if ( ! fits(p, last, EEInputFormat::sectionHeaderSize) || ! fits(p + EEInputFormat::sectionHeaderSize, last, p[3]) ) {
+      edm::LogWarning("EEInputReplay") << "section " << i << " of event " << file[event_+3] << " runs past the end of the event";
+      return 0;
+    }
+
+    if ( int(p[0]) == type && int(p[1]) == index ) {
+      // every item takes at least one word, or one byte for the FED buffers
+      if ( size_t(p[2]) > size_t(p[3])*sizeof(uint32_t) ) {
+        edm::LogWarning("EEInputReplay") << "section " << i << " of event " << file[event_+3] << " has " << p[2] << " items in " << p[3] << " words";
+        return 0;
+      }
+      count = p[2];
+      end = p + EEInputFormat::sectionHeaderSize + p[3];
+      return p + EEInputFormat::sectionHeaderSize;
+    }
+
+    p += EEInputFormat::sectionHeaderSize + p[3];
+
+  }
+
+  return 0;
+
+}
+
+int EEInputReplay::checked(int count, size_t words, const uint32_t* p, const uint32_t* end) const {
+
+  if ( size_t(count) <= size_t(end - p)/words ) return count;
+
+  edm::LogWarning("EEInputReplay") << "section of " << count << " items truncated to " << size_t(end - p)/words;
+
+  return int(size_t(end - p)/words);
+
+}
+
+void EEInputReplay::produce(edm::Event& e, const edm::EventSetup& c){
+
+  std::map<edm::EventID, size_t>::const_iterator it = index_.find(e.id());
+
+  if ( it == index_.end() ) {
+    throw cms::Exception("EEInputReplay") << "event " << e.id() << " is not in " << fileName_ << ", replay it with EEInputReplaySource";
+  }
+
+  event_ = it->second;
+
+  ievt_++;
+
+  int count;
+  const uint32_t* p;
+  const uint32_t* end;
+
+  if ( produceDigis_ && (p = section(EEInputFormat::Digis, 0, count, end)) ) {
+
+    std::auto_ptr<EEDigiCollection> digis(new EEDigiCollection);
+
+    uint16_t samples[EEDataFrame::MAXSAMPLES];
+
+    count = this->checked(count, 1 + (EEDataFrame::MAXSAMPLES+1)/2, p, end);
+    digis->reserve(count);
+
+    for ( int n = 0; n < count; n++ ) {
+
+      uint32_t id = *p++;
+      p = getShorts(p, samples, EEDataFrame::MAXSAMPLES);
+
+      digis->push_back(id, samples);
+
+    }
+
+    digis->sort();
+
+    e.put(digis, EEDigiCollection_.instance());
+
+  }
+
+  if ( produceTrigPrims_ && (p = section(EEInputFormat::TrigPrims, 0, count, end)) ) {
+
+    std::auto_ptr<EcalTrigPrimDigiCollection> tps(new EcalTrigPrimDigiCollection);
+    tps->reserve(count);
+
+    std::vector<uint16_t> samples;
+
+    for ( int n = 0; n < count; n++ ) {
+
+      if ( ! fits(p, end, 2) || ! fits(p + 2, end, (size_t(p[1])+1)/2) ) {
+        edm::LogWarning("EEInputReplay") << "truncated trigger primitive section";
+        break;
+      }
+
+      EcalTrigTowerDetId id(p[0]);
+
+      EcalTriggerPrimitiveDigi tp(id);
+
+      samples.resize(p[1]);
+      p += 2;
+      if ( samples.size() ) p = getShorts(p, &samples[0], samples.size());
+
+      tp.setSize(samples.size());
+      for ( unsigned int i = 0; i < samples.size(); i++ ) tp.setSample(i, EcalTriggerPrimitiveSample(samples[i]));
+
+      tps->push_back(tp);
+
+    }
+
+    tps->sort();
+
+    e.put(tps, EcalTrigPrimDigiCollection_.instance());
+
+  }
+
+  if ( produceSrFlags_ && (p = section(EEInputFormat::SrFlags, 0, count, end)) ) {
+
+    std::auto_ptr<EESrFlagCollection> srFlags(new EESrFlagCollection);
+
+    count = this->checked(count, 2, p, end);
+    srFlags->reserve(count);
+
+    for ( int n = 0; n < count; n++, p += 2 ) srFlags->push_back( EESrFlag( EcalScDetId(p[0]), p[1] ) );
+
+    srFlags->sort();
+
+    e.put(srFlags, EESRFlagCollection_.instance());
+
+  }
+
+  if ( produceUncalibRecHits_ && (p = section(EEInputFormat::UncalibRecHits, 0, count, end)) ) {
+
+    std::auto_ptr<EcalUncalibratedRecHitCollection> uhits(new EcalUncalibratedRecHitCollection);
+
+    count = this->checked(count, 7, p, end);
+    uhits->reserve(count);
+
+    for ( int n = 0; n < count; n++, p += 7 ) {
+      uhits->push_back( EcalUncalibratedRecHit( DetId(p[0]), getFloat(p+1), getFloat(p+2), getFloat(p+3), getFloat(p+4), p[5], p[6] ) );
+    }
+
+    uhits->sort();
+
+    e.put(uhits, EcalUncalibratedRecHitCollection_.instance());
+
+  }
+
+  if ( produceRecHits_ && (p = section(EEInputFormat::RecHits, 0, count, end)) ) {
+
+    std::auto_ptr<EcalRecHitCollection> hits(new EcalRecHitCollection);
+
+    count = this->checked(count, 6, p, end);
+    hits->reserve(count);
+
+    for ( int n = 0; n < count; n++, p += 6 ) {
+      EcalRecHit hit( DetId(p[0]), getFloat(p+1), getFloat(p+2), p[3], p[4] );
+      hit.setAux(p[5]);
+      hits->push_back(hit);
+    }
+
+    hits->sort();
+
+    e.put(hits, EcalRecHitCollection_.instance());
+
+  }
+
+  if ( producePnDigis_ && (p = section(EEInputFormat::PnDigis, 0, count, end)) ) {
+
+    std::auto_ptr<EcalPnDiodeDigiCollection> pns(new EcalPnDiodeDigiCollection);
+    pns->reserve(count);
+
+    std::vector<uint16_t> samples;
+
+    for ( int n = 0; n < count; n++ ) {
+
+      if ( ! fits(p, end, 2) || ! fits(p + 2, end, (size_t(p[1])+1)/2) ) {
+        edm::LogWarning("EEInputReplay") << "truncated PN diode section";
+        break;
+      }
+
+      EcalPnDiodeDetId id(p[0]);
+
+      EcalPnDiodeDigi pn(id);
+
+      samples.resize(p[1]);
+      p += 2;
+      if ( samples.size() ) p = getShorts(p, &samples[0], samples.size());
+
+      pn.setSize(samples.size());
+      for ( unsigned int i = 0; i < samples.size(); i++ ) pn.setSample(i, EcalFEMSample(samples[i]));
+
+      pns->push_back(pn);
+
+    }
+
+    pns->sort();
+
+    e.put(pns, EcalPnDiodeDigiCollection_.instance());
+
+  }
+
+  if ( produceDccHeaders_ && (p = section(EEInputFormat::DccHeaders, 0, count, end)) ) {
+
+    std::auto_ptr<EcalRawDataCollection> dcchs(new EcalRawDataCollection);
+    dcchs->reserve(count);
+
+    std::vector<short> data;
+
+    for ( int n = 0; n < count; n++ ) {
+
+      const uint32_t* q = fits(p, end, 20) ? p + 20 : 0;
+      for ( int i = 0; i < 5; i++ ) q = getShorts(q, end, data);
+
+      if ( ! q ) {
+        edm::LogWarning("EEInputReplay") << "truncated DCC header section";
+        break;
+      }
+
+      EcalDCCHeaderBlock dcch;
+
+      dcch.setId(p[0]);
+      dcch.setFedId(p[1]);
+      dcch.setRunNumber(p[2]);
+      dcch.setLV1(p[3]);
+      dcch.setBX(p[4]);
+      dcch.setOrbit(p[5]);
+      dcch.setBasicTriggerType(p[6]);
+      dcch.setRunType(p[7]);
+      dcch.setRtHalf(p[8]);
+      dcch.setMgpaGain(p[9]);
+      dcch.setMemGain(p[10]);
+      dcch.setSRPBx(p[11]);
+      dcch.setSRPLv1(p[12]);
+
+      EcalDCCHeaderBlock::EcalDCCEventSettings settings;
+      settings.LaserPower = p[13];
+      settings.LaserFilter = p[14];
+      settings.wavelength = p[15];
+      settings.delay = p[16];
+      settings.MEMVinj = p[17];
+      settings.mgpa_content = p[18];
+      settings.ped_offset = p[19];
+      dcch.setEventSettings(settings);
+
+      p += 20;
+
+      p = getShorts(p, end, data);
+      dcch.setFEStatus(data);
+      p = getShorts(p, end, data);
+      dcch.setFEBxs(data);
+      p = getShorts(p, end, data);
+      dcch.setFELv1(data);
+      p = getShorts(p, end, data);
+      dcch.setTCCBx(data);
+      p = getShorts(p, end, data);
+      dcch.setTCCLv1(data);
+
+      dcchs->push_back(dcch);
+
+    }
+
+    dcchs->sort();
+
+    e.put(dcchs, EcalRawDataCollection_.instance());
+
+  }
+
+  for ( int i = 0; i < EEInputFormat::nDetIdErrors; i++ ) {
+
+    if ( produceDetIdErrors_[i] && (p = section(EEInputFormat::DetIdErrors, i, count, end)) ) {
+
+      std::auto_ptr<EEDetIdCollection> ids(new EEDetIdCollection);
+
+      count = this->checked(count, 1, p, end);
+
+      for ( int n = 0; n < count; n++ ) ids->push_back( EEDetId(p[n]) );
+
+      e.put(ids, EEDetIdCollection_[i].instance());
+
+    }
+
+  }
+
+  for ( int i = 0; i < EEInputFormat::nElectronicsIdErrors; i++ ) {
+
+    if ( produceElectronicsIdErrors_[i] && (p = section(EEInputFormat::ElectronicsIdErrors, i, count, end)) ) {
+
+      std::auto_ptr<EcalElectronicsIdCollection> ids(new EcalElectronicsIdCollection);
+
+      count = this->checked(count, 1, p, end);
+
+      for ( int n = 0; n < count; n++ ) ids->push_back( EcalElectronicsId(p[n]) );
+
+      e.put(ids, EcalElectronicsIdCollection_[i].instance());
+
+    }
+
+  }
+
+  if ( produceFedBuffers_ ) {
+
+    std::auto_ptr<FEDRawDataCollection> raw(new FEDRawDataCollection);
+
+    bool found = false;
+
+    for ( int i = 0; i < EEInputFormat::nFeds; i++ ) {
+
+      int fedId = EEInputFormat::fedId(i);
+
+      if ( ! (p = section(EEInputFormat::FedBuffers, fedId, count, end)) ) continue;
+
+      if ( size_t(count) > size_t(end - p)*sizeof(uint32_t) ) {
+        edm::LogWarning("EEInputReplay") << "truncated buffer of FED " << fedId;
+        continue;
+      }
+
+      found = true;
+
+      FEDRawData& fedData = raw->FEDData(fedId);
+      fedData.resize(count);
+      if ( count ) memcpy(fedData.data(), p, count);
+
+    }
+
+    if ( found ) e.put(raw, FEDRawDataCollection_.instance());
+
+  }
+
+}
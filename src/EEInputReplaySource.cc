@@ -0,0 +1,46 @@
+/*
+ * \file EEInputReplaySource.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "DataFormats/Provenance/interface/Timestamp.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputReplaySource.h"
+
+EEInputReplaySource::EEInputReplaySource(const edm::ParameterSet& ps, const edm::InputSourceDescription& desc) :
+  edm::RawInputSource(ps, desc),
+  fileName_(ps.getUntrackedParameter<std::string>("fileName", "EEInput.bin")),
+  file_(fileName_) {
+
+  ievt_ = 0;
+
+  event_ = file_.first();
+
+}
+
+EEInputReplaySource::~EEInputReplaySource(){
+
+  edm::LogInfo("EEInputReplaySource") << ievt_ << " events read from " << fileName_;
+
+}
+
+std::auto_ptr<edm::Event> EEInputReplaySource::readOneEvent(){
+
+  if ( ! file_.valid(event_) ) {
+    if ( event_ != file_.end() ) edm::LogWarning("EEInputReplaySource") << fileName_ << " is truncated or corrupt at word " << event_ << ", the events after it are not read";
+    return std::auto_ptr<edm::Event>();
+  }
+
+  edm::EventID id = file_.id(event_);
+
+  event_ = file_.next(event_);
+
+  ievt_++;
+
+  return makeEvent(id.run(), id.luminosityBlock(), id.event(), edm::Timestamp::invalidTimestamp());
+
+}
@@ -0,0 +1,291 @@
+/*
+ * \file EEInstrumentation.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include <time.h>
+
+#include "DQMServices/Core/interface/MonitorElement.h"
+
+#include "DQMServices/Core/interface/DQMStore.h"
+
+#include "DQM/EcalCommon/interface/UtilFunctions.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInstrumentation.h"
+
+namespace {
+
+  const char* stageNames[EEInstrumentation::nStages] = { "product fetch", "digi loop", "rec hit loop", "ME flush", "event" };
+
+  uint64_t nanoseconds(clockid_t clock) {
+
+    timespec t;
+    clock_gettime(clock, &t);
+
+    return uint64_t(t.tv_sec) * 1000000000ULL + t.tv_nsec;
+
+  }
+
+}
+
+double EEInstrumentation::ticksPerSecond_ = 0.;
+
+EEInstrumentation::Timer::Timer(EEInstrumentation& instrumentation, Stage stage, int items) {
+
+  instrumentation_ = instrumentation.enabled_ ? &instrumentation : 0;
+
+  stage_ = stage;
+  items_ = items;
+
+  ticks_ = 0;
+  cpu_ = 0;
+
+  if ( ! instrumentation_ ) return;
+
+  // the CPU clock is a system call, read it only for the stages that
+  // are long enough to carry it: the whole event and the flush
+  if ( stage_ == Total || stage_ == Flush ) cpu_ = EEInstrumentation::cpu();
+  ticks_ = EEInstrumentation::ticks();
+
+}
+
+EEInstrumentation::Timer::~Timer() {
+
+  if ( ! instrumentation_ ) return;
+
+  uint64_t ticks = EEInstrumentation::ticks();
+  uint64_t cpu = ( stage_ == Total || stage_ == Flush ) ? EEInstrumentation::cpu() : cpu_;
+
+  instrumentation_->add(stage_, ticks - ticks_, cpu - cpu_, items_);
+
+}
+
+EEInstrumentation::EEInstrumentation() {
+
+  enabled_ = false;
+
+  meWall_ = 0;
+  meCpu_ = 0;
+  meItems_ = 0;
+  meWallHistory_ = 0;
+  meCpuHistory_ = 0;
+  meRateHistory_ = 0;
+
+  this->reset();
+
+}
+
+EEInstrumentation::~EEInstrumentation() {
+
+}
+
+void EEInstrumentation::enable(bool enabled) {
+
+  enabled_ = enabled;
+
+}
+
+bool EEInstrumentation::enabled(void) const {
+
+  return enabled_;
+
+}
+
+uint64_t EEInstrumentation::ticks(void) {
+
+#if defined(__i386__) || defined(__x86_64__)
+  uint32_t lo, hi;
+  __asm__ __volatile__ ( "rdtsc" : "=a" (lo), "=d" (hi) );
+  return ( uint64_t(hi) << 32 ) | lo;
+#else
+  return nanoseconds(CLOCK_MONOTONIC);
+#endif
+
+}
+
+double EEInstrumentation::ticksPerSecond(void) {
+
+  if ( ticksPerSecond_ > 0. ) return ticksPerSecond_;
+
+  // 10 ms against the monotonic clock
+  uint64_t t0 = nanoseconds(CLOCK_MONOTONIC);
+  uint64_t c0 = ticks();
+
+  timespec d = { 0, 10000000 };
+  nanosleep(&d, 0);
+
+  uint64_t t1 = nanoseconds(CLOCK_MONOTONIC);
+  uint64_t c1 = ticks();
+
+  ticksPerSecond_ = ( t1 > t0 && c1 > c0 ) ? double(c1 - c0) / ( double(t1 - t0) * 1.e-9 ) : 1.e9;
+
+  return ticksPerSecond_;
+
+}
+
+uint64_t EEInstrumentation::cpu(void) {
+
+  return nanoseconds(CLOCK_THREAD_CPUTIME_ID);
+
+}
+
+void EEInstrumentation::setup(DQMStore* dqmStore, const std::string& folder, const std::string& task) {
+
+  if ( ! enabled_ ) return;
+
+  ticksPerSecond();
+
+  this->reset();
+
+  folder_ = folder;
+
+  std::string name;
+
+  if ( dqmStore ) {
+
+    dqmStore->setCurrentFolder(folder_);
+
+    name = "EEIN " + task + " wall time";
+    meWall_ = dqmStore->bookProfile(name, name, nStages, 0., nStages, 100, 0., 1.0e9, "s");
+    for (int i = 0; i < nStages; i++) meWall_->setBinLabel(i+1, stageNames[i], 1);
+    meWall_->setAxisTitle("wall time per event (us)", 2);
+
+    name = "EEIN " + task + " CPU time";
+    meCpu_ = dqmStore->bookProfile(name, name, nStages, 0., nStages, 100, 0., 1.0e9, "s");
+    for (int i = 0; i < nStages; i++) meCpu_->setBinLabel(i+1, stageNames[i], 1);
+    meCpu_->setAxisTitle("CPU time per event (us)", 2);
+
+    name = "EEIN " + task + " collection size";
+    meItems_ = dqmStore->bookProfile(name, name, nStages, 0., nStages, 100, 0., 1.0e6, "s");
+    for (int i = 0; i < nStages; i++) meItems_->setBinLabel(i+1, stageNames[i], 1);
+    meItems_->setAxisTitle("items looped over per event", 2);
+
+    name = "EEIN " + task + " wall time history";
+    meWallHistory_ = dqmStore->bookProfile(name, name, nHistory, 0., nHistory, 100, 0., 1.0e9, "s");
+    meWallHistory_->setAxisTitle("lumi sections ago", 1);
+    meWallHistory_->setAxisTitle("wall time per event (us)", 2);
+
+    name = "EEIN " + task + " CPU time history";
+    meCpuHistory_ = dqmStore->bookProfile(name, name, nHistory, 0., nHistory, 100, 0., 1.0e9, "s");
+    meCpuHistory_->setAxisTitle("lumi sections ago", 1);
+    meCpuHistory_->setAxisTitle("CPU time per event (us)", 2);
+
+    name = "EEIN " + task + " event rate history";
+    meRateHistory_ = dqmStore->bookProfile(name, name, nHistory, 0., nHistory, 100, 0., 1.0e9, "s");
+    meRateHistory_->setAxisTitle("lumi sections ago", 1);
+    meRateHistory_->setAxisTitle("events per second", 2);
+
+  }
+
+}
+
+void EEInstrumentation::cleanup(DQMStore* dqmStore) {
+
+  if ( dqmStore && meWall_ ) {
+
+    dqmStore->setCurrentFolder(folder_);
+
+    if ( meWall_ ) dqmStore->removeElement( meWall_->getName() );
+    if ( meCpu_ ) dqmStore->removeElement( meCpu_->getName() );
+    if ( meItems_ ) dqmStore->removeElement( meItems_->getName() );
+    if ( meWallHistory_ ) dqmStore->removeElement( meWallHistory_->getName() );
+    if ( meCpuHistory_ ) dqmStore->removeElement( meCpuHistory_->getName() );
+    if ( meRateHistory_ ) dqmStore->removeElement( meRateHistory_->getName() );
+
+  }
+
+  meWall_ = 0;
+  meCpu_ = 0;
+  meItems_ = 0;
+  meWallHistory_ = 0;
+  meCpuHistory_ = 0;
+  meRateHistory_ = 0;
+
+}
+
+void EEInstrumentation::reset(void) {
+
+  for (int i = 0; i < nStages; i++) {
+    eventTicks_[i] = 0;
+    eventCpu_[i] = 0;
+    eventItems_[i] = 0;
+    eventUsed_[i] = false;
+  }
+
+  lumiEvents_ = 0;
+  lumiWall_ = 0.;
+  lumiCpu_ = 0.;
+  lumiStart_ = enabled_ ? ticks() : 0;
+
+  if ( meWall_ ) meWall_->Reset();
+  if ( meCpu_ ) meCpu_->Reset();
+  if ( meItems_ ) meItems_->Reset();
+  if ( meWallHistory_ ) meWallHistory_->Reset();
+  if ( meCpuHistory_ ) meCpuHistory_->Reset();
+  if ( meRateHistory_ ) meRateHistory_->Reset();
+
+}
+
+void EEInstrumentation::add(Stage stage, uint64_t ticks, uint64_t cpu, int items) {
+
+  eventTicks_[stage] += ticks;
+  eventCpu_[stage] += cpu;
+  eventItems_[stage] += items;
+  eventUsed_[stage] = true;
+
+  // the flush runs outside of the events, the end of an event closes it
+  if ( stage != Flush && stage != Total ) return;
+
+  double usPerTick = 1.e6 / ticksPerSecond();
+
+  for (int i = 0; i < nStages; i++) {
+
+    if ( ! eventUsed_[i] ) continue;
+    if ( ( i == Flush ) != ( stage == Flush ) ) continue;
+
+    if ( meWall_ ) meWall_->Fill(i+0.5, eventTicks_[i] * usPerTick);
+    if ( meCpu_ && ( i == Total || i == Flush ) ) meCpu_->Fill(i+0.5, eventCpu_[i] * 1.e-3);
+    if ( meItems_ && ( i == Digis || i == RecHits ) ) meItems_->Fill(i+0.5, eventItems_[i]);
+
+    eventTicks_[i] = 0;
+    eventCpu_[i] = 0;
+    eventItems_[i] = 0;
+    eventUsed_[i] = false;
+
+  }
+
+  if ( stage == Total ) {
+    lumiEvents_++;
+    lumiWall_ += ticks * usPerTick;
+    lumiCpu_ += cpu * 1.e-3;
+  }
+
+}
+
+void EEInstrumentation::endLumi(void) {
+
+  if ( ! enabled_ ) return;
+
+  uint64_t now = ticks();
+
+  double seconds = double(now - lumiStart_) / ticksPerSecond();
+
+  if ( meWallHistory_ ) ecaldqm::shift2Right(meWallHistory_->getTProfile(), 1);
+  if ( meCpuHistory_ ) ecaldqm::shift2Right(meCpuHistory_->getTProfile(), 1);
+  if ( meRateHistory_ ) ecaldqm::shift2Right(meRateHistory_->getTProfile(), 1);
+
+  if ( lumiEvents_ ) {
+    if ( meWallHistory_ ) meWallHistory_->Fill(0.5, lumiWall_ / lumiEvents_);
+    if ( meCpuHistory_ ) meCpuHistory_->Fill(0.5, lumiCpu_ / lumiEvents_);
+    if ( meRateHistory_ && seconds > 0. ) meRateHistory_->Fill(0.5, lumiEvents_ / seconds);
+  }
+
+  lumiEvents_ = 0;
+  lumiWall_ = 0.;
+  lumiCpu_ = 0.;
+  lumiStart_ = now;
+
+}
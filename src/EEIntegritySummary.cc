@@ -0,0 +1,282 @@
+/*
+ * \file EEIntegritySummary.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalDetId/interface/EcalElectronicsId.h"
+#include "DataFormats/EcalDetId/interface/EcalDetIdCollections.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
+
+#include "DQM/EcalCommon/interface/Numbers.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEIntegritySummary.h"
+
+EEIntegritySummary::EEIntegritySummary(bool countsOnly) {
+
+  countsOnly_ = countsOnly;
+
+  init_ = false;
+
+  cacheId_ = 0;
+
+  for ( int t = 0; t < nTypes; t++ ) {
+    found_[t] = false;
+    size_[t] = 0;
+    for ( int i = 0; i < nSM_; i++ ) nIds_[t][i] = 0;
+  }
+
+}
+
+EEIntegritySummary::~EEIntegritySummary() {
+
+}
+
+EEIntegritySummary& EEIntegritySummary::shared(void) {
+
+  static EEIntegritySummary summary(true);
+
+  return summary;
+
+}
+
+void EEIntegritySummary::enableCrystals(void) {
+
+  if ( ! countsOnly_ ) return;
+
+  countsOnly_ = false;
+
+  // rebuild the tables, and decode again the current event
+  init_ = false;
+
+}
+
+bool EEIntegritySummary::initTables(const edm::EventSetup& c) {
+
+  unsigned long long cacheId = c.get< EcalMappingRcd >().cacheIdentifier();
+
+  if ( init_ && cacheId == cacheId_ ) return true;
+
+  edm::ESHandle< EcalElectronicsMapping > handle;
+  c.get< EcalMappingRcd >().get(handle);
+  if ( ! handle.isValid() ) return false;
+  const EcalElectronicsMapping* map = handle.product();
+  if ( ! map ) return false;
+
+  ism_.resize(EEDetId::kSizeForDenseIndexing);
+
+  if ( ! countsOnly_ ) {
+    ix_.resize(EEDetId::kSizeForDenseIndexing);
+    iy_.resize(EEDetId::kSizeForDenseIndexing);
+  }
+
+  for ( int hi = 0; hi < EEDetId::kSizeForDenseIndexing; hi++ ) {
+
+    EEDetId id = EEDetId::unhashIndex(hi);
+
+    ism_[hi] = Numbers::iSM( map->getElectronicsId(id) );
+
+    if ( countsOnly_ ) continue;
+
+    ix_[hi] = id.ix();
+    iy_[hi] = id.iy();
+
+  }
+
+  if ( ! countsOnly_ ) {
+    usedCrystals_.clear();
+    mask_.assign(EEDetId::kSizeForDenseIndexing, 0);
+  }
+
+  // decode again with the new tables
+  eventId_ = edm::EventID();
+
+  cacheId_ = cacheId;
+  init_ = true;
+
+  return true;
+
+}
+
+void EEIntegritySummary::clear(void) {
+
+  for ( unsigned int i = 0; i < usedCrystals_.size(); i++ ) mask_[usedCrystals_[i]] = 0;
+  usedCrystals_.clear();
+
+  for ( int t = 0; t < nTypes; t++ ) {
+    found_[t] = false;
+    size_[t] = 0;
+    for ( int i = 0; i < nSM_; i++ ) nIds_[t][i] = 0;
+    crystals_[t].clear();
+    mems_[t].clear();
+  }
+
+}
+
+void EEIntegritySummary::addCrystal(int type, int hi, int ism, int n) {
+
+  Crystal c;
+  c.ism = ism;
+  c.ix = ( ism >= 1 && ism <= 9 ) ? 101 - ix_[hi] : ix_[hi];
+  c.iy = iy_[hi];
+  c.n = n;
+
+  crystals_[type].push_back(c);
+
+  if ( mask_[hi] == 0 ) usedCrystals_.push_back(hi);
+  mask_[hi] |= (1 << type);
+
+}
+
+void EEIntegritySummary::update(const edm::Event& e, const edm::EventSetup& c, const edm::InputTag* tags) {
+
+  if ( ! initTables(c) ) {
+    this->clear();
+    eventId_ = edm::EventID();
+    return;
+  }
+
+  bool done = ( e.id() == eventId_ );
+  for ( int t = 0; t < nTypes; t++ ) {
+    if ( ! ( tags[t] == tags_[t] ) ) done = false;
+  }
+
+  if ( done ) return;
+
+  eventId_ = e.id();
+  for ( int t = 0; t < nTypes; t++ ) tags_[t] = tags[t];
+
+  this->clear();
+
+  for ( int t = DCCSize; t <= GainSwitch; t++ ) {
+
+    edm::Handle<EEDetIdCollection> ids;
+
+    if ( ! e.getByLabel(tags[t], ids) ) continue;
+
+    found_[t] = true;
+    size_[t] = ids->size();
+
+    for ( EEDetIdCollection::const_iterator idItr = ids->begin(); idItr != ids->end(); ++idItr ) {
+
+      int hi = idItr->hashedIndex();
+
+      int ism = ism_[hi];
+      if ( ism >= 1 && ism <= nSM_ ) nIds_[t][ism-1]++;
+
+      if ( countsOnly_ ) continue;
+
+      addCrystal(t, hi, ism, 1);
+
+    }
+
+  }
+
+  for ( int t = TTId; t <= MemGain; t++ ) {
+
+    edm::Handle<EcalElectronicsIdCollection> ids;
+
+    if ( ! e.getByLabel(tags[t], ids) ) continue;
+
+    found_[t] = true;
+    size_[t] = ids->size();
+
+    for ( EcalElectronicsIdCollection::const_iterator idItr = ids->begin(); idItr != ids->end(); ++idItr ) {
+
+      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
+
+      int ism = Numbers::iSM( *idItr );
+      if ( ism >= 1 && ism <= nSM_ ) nIds_[t][ism-1]++;
+
+      if ( countsOnly_ ) continue;
+
+      if ( t == TTId || t == BlockSize ) {
+
+        std::vector<DetId>* crystals = Numbers::crystals( *idItr );
+
+        for ( unsigned int i = 0; i < crystals->size(); i++ ) {
+          addCrystal(t, EEDetId((*crystals)[i]).hashedIndex(), ism, crystals->size());
+        }
+
+      } else {
+
+        Mem m;
+        m.ism = ism;
+        m.itt = idItr->towerId();
+        m.ich = idItr->channelId();
+
+        mems_[t].push_back(m);
+
+      }
+
+    }
+
+  }
+
+}
+
+bool EEIntegritySummary::found(int type) const {
+
+  if ( type < 0 || type >= nTypes ) return false;
+
+  return found_[type];
+
+}
+
+int EEIntegritySummary::size(int type) const {
+
+  if ( type < 0 || type >= nTypes ) return 0;
+
+  return size_[type];
+
+}
+
+int EEIntegritySummary::nIds(int type, int ism) const {
+
+  if ( type < 0 || type >= nTypes || ism < 1 || ism > nSM_ ) return 0;
+
+  return nIds_[type][ism-1];
+
+}
+
+const std::vector<EEIntegritySummary::Crystal>& EEIntegritySummary::crystals(int type) const {
+
+  return crystals_[type];
+
+}
+
+const std::vector<EEIntegritySummary::Mem>& EEIntegritySummary::mems(int type) const {
+
+  return mems_[type];
+
+}
+
+unsigned int EEIntegritySummary::errors(int hi) const {
+
+  if ( ! init_ || countsOnly_ || hi < 0 || hi >= EEDetId::kSizeForDenseIndexing ) return 0;
+
+  return mask_[hi];
+
+}
+
+size_t EEIntegritySummary::bytes(void) const {
+
+  size_t bytes = sizeof(*this) +
+    ( ism_.capacity() + ix_.capacity() + iy_.capacity() + usedCrystals_.capacity() ) * sizeof(int) +
+    mask_.capacity() * sizeof(uint16_t);
+
+  for ( int t = 0; t < nTypes; t++ ) {
+    bytes += crystals_[t].capacity() * sizeof(Crystal);
+    bytes += mems_[t].capacity() * sizeof(Mem);
+  }
+
+  return bytes;
+
+}
@@ -26,7 +26,9 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEIntegrityTask.h"
 
-EEIntegrityTask::EEIntegrityTask(const edm::ParameterSet& ps){
+EEIntegrityTask::EEIntegrityTask(const edm::ParameterSet& ps) : integritySummary_(EEIntegritySummary::shared()) {
+
+  integritySummary_.enableCrystals();
 
   init_ = false;
 
@@ -40,6 +42,10 @@ EEIntegrityTask::EEIntegrityTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   EEDetIdCollection0_ =  ps.getParameter<edm::InputTag>("EEDetIdCollection0");
   EEDetIdCollection1_ =  ps.getParameter<edm::InputTag>("EEDetIdCollection1");
   EEDetIdCollection2_ =  ps.getParameter<edm::InputTag>("EEDetIdCollection2");
@@ -51,6 +57,17 @@ EEIntegrityTask::EEIntegrityTask(const edm::ParameterSet& ps){
   EcalElectronicsIdCollection5_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection5");
   EcalElectronicsIdCollection6_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection6");
 
+  integrityCollections_[EEIntegritySummary::DCCSize] = EEDetIdCollection0_;
+  integrityCollections_[EEIntegritySummary::Gain] = EEDetIdCollection1_;
+  integrityCollections_[EEIntegritySummary::ChId] = EEDetIdCollection2_;
+  integrityCollections_[EEIntegritySummary::GainSwitch] = EEDetIdCollection3_;
+  integrityCollections_[EEIntegritySummary::TTId] = EcalElectronicsIdCollection1_;
+  integrityCollections_[EEIntegritySummary::BlockSize] = EcalElectronicsIdCollection2_;
+  integrityCollections_[EEIntegritySummary::MemTTId] = EcalElectronicsIdCollection3_;
+  integrityCollections_[EEIntegritySummary::MemBlockSize] = EcalElectronicsIdCollection4_;
+  integrityCollections_[EEIntegritySummary::MemChId] = EcalElectronicsIdCollection5_;
+  integrityCollections_[EEIntegritySummary::MemGain] = EcalElectronicsIdCollection6_;
+
   meIntegrityDCCSize = 0;
   for (int i = 0; i < 18; i++) {
     meIntegrityGain[i] = 0;
@@ -109,10 +126,13 @@ EEIntegrityTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EEIntegrityTask::reset(void) {
 
+  instrumentation_.reset();
+
   if ( meIntegrityDCCSize ) meIntegrityDCCSize->Reset();
   for (int i = 0; i < 18; i++) {
     if ( meIntegrityGain[i] ) meIntegrityGain[i]->Reset();
@@ -133,6 +153,8 @@ void EEIntegrityTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEIntegrityTask");
+
   std::string name;
   std::string dir;
 
@@ -261,12 +283,17 @@ void EEIntegrityTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEIntegrityTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
 
     std::string dir;
@@ -347,312 +374,120 @@ void EEIntegrityTask::endJob(void){
 
   edm::LogInfo("EEIntegrityTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
-void EEIntegrityTask::analyze(const edm::Event& e, const edm::EventSetup& c){
-
-  if ( ! init_ ) this->setup();
-
-  ievt_++;
-
-  // fill bin 0 with number of events in the lumi
-  if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(0.);
-
-  edm::Handle<EEDetIdCollection> ids0;
-
-  if ( e.getByLabel(EEDetIdCollection0_, ids0) ) {
-
-    for ( EEDetIdCollection::const_iterator idItr = ids0->begin(); idItr != ids0->end(); ++idItr ) {
-
-      int ism = Numbers::iSM( *idItr );
-
-      float xism = ism + 0.5;
-
-      if ( meIntegrityDCCSize ) meIntegrityDCCSize->Fill(xism);
-
-    }
-
-  } else {
-
-//    edm::LogWarning("EEIntegrityTask") << EEDetIdCollection0_ << " not available";
-
-  }
-
-  edm::Handle<EEDetIdCollection> ids1;
-
-  if ( e.getByLabel(EEDetIdCollection1_, ids1) ) {
-
-    for ( EEDetIdCollection::const_iterator idItr = ids1->begin(); idItr != ids1->end(); ++idItr ) {
-
-      EEDetId id = (*idItr);
+void EEIntegrityTask::reportMemory(const std::string& when) {
 
-      int ix = id.ix();
-      int iy = id.iy();
+  if ( ! memoryReport_.enabled() ) return;
 
-      int ism = Numbers::iSM( id );
-      float xism = ism + 0.5;
+  memoryReport_.clear();
 
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
+  memoryReport_.add("integritySummary_ (shared)", &integritySummary_, 1);
 
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
+  memoryReport_.report(dqmStore_, prefixME_, "EEIntegrityTask", "EEIntegrityTask", when);
 
-      if ( meIntegrityGain[ism-1] ) meIntegrityGain[ism-1]->Fill(xix, xiy);
-      if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(xism, 1./850.);
-
-    }
-
-  } else {
-
-    edm::LogWarning("EEIntegrityTask") << EEDetIdCollection1_ << " not available";
-
-  }
-
-  edm::Handle<EEDetIdCollection> ids2;
-
-  if ( e.getByLabel(EEDetIdCollection2_, ids2) ) {
-
-    for ( EEDetIdCollection::const_iterator idItr = ids2->begin(); idItr != ids2->end(); ++idItr ) {
-
-      EEDetId id = (*idItr);
-
-      int ix = id.ix();
-      int iy = id.iy();
-
-      int ism = Numbers::iSM( id );
-      float xism = ism + 0.5;
-
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
-
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
-
-      if ( meIntegrityChId[ism-1] ) meIntegrityChId[ism-1]->Fill(xix, xiy);
-      if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(xism, 1./850.);
-
-    }
-
-  } else {
-
-    edm::LogWarning("EEIntegrityTask") << EEDetIdCollection2_ << " not available";
-
-  }
-
-  edm::Handle<EEDetIdCollection> ids3;
-
-  if ( e.getByLabel(EEDetIdCollection3_, ids3) ) {
-
-    for ( EEDetIdCollection::const_iterator idItr = ids3->begin(); idItr != ids3->end(); ++idItr ) {
-
-      EEDetId id = (*idItr);
-
-      int ix = id.ix();
-      int iy = id.iy();
-
-      int ism = Numbers::iSM( id );
-      float xism = ism + 0.5;
-
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
-
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
-
-      if ( meIntegrityGainSwitch[ism-1] ) meIntegrityGainSwitch[ism-1]->Fill(xix, xiy);
-      if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(xism, 1./850.);
-
-    }
-
-  } else {
-
-    edm::LogWarning("EEIntegrityTask") << EEDetIdCollection3_ << " not available";
-
-  }
-
-  edm::Handle<EcalElectronicsIdCollection> ids4;
-
-  if ( e.getByLabel(EcalElectronicsIdCollection1_, ids4) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids4->begin(); idItr != ids4->end(); ++idItr ) {
-
-      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *idItr );
-      float xism = ism + 0.5;
-
-      std::vector<DetId>* crystals = Numbers::crystals( *idItr );
-
-      for ( unsigned int i=0; i<crystals->size(); i++ ) {
-
-      EEDetId id = (*crystals)[i];
-
-      int ix = id.ix();
-      int iy = id.iy();
-
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
-
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
-
-      if ( meIntegrityTTId[ism-1] ) meIntegrityTTId[ism-1]->Fill(xix, xiy);
-      if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(xism, 1./34./crystals->size());
-
-      }
-
-    }
-
-  } else {
-
-    edm::LogWarning("EEIntegrityTask") << EcalElectronicsIdCollection1_ << " not available";
-
-  }
-
-  edm::Handle<EcalElectronicsIdCollection> ids5;
-
-  if ( e.getByLabel(EcalElectronicsIdCollection2_, ids5) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids5->begin(); idItr != ids5->end(); ++idItr ) {
-
-      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *idItr );
-      float xism = ism + 0.5;
-
-      std::vector<DetId>* crystals = Numbers::crystals( *idItr );
-
-      for ( unsigned int i=0; i<crystals->size(); i++ ) {
-
-      EEDetId id = (*crystals)[i];
-
-      int ix = id.ix();
-      int iy = id.iy();
-
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
+}
 
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
+void EEIntegrityTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
-      if ( meIntegrityTTBlockSize[ism-1] ) meIntegrityTTBlockSize[ism-1]->Fill(xix, xiy);
-      if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(xism, 1./34./crystals->size());
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
 
-      }
+  if ( ! init_ ) this->setup();
 
-    }
+  ievt_++;
 
-  } else {
+  // fill bin 0 with number of events in the lumi
+  if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(0.);
 
-    edm::LogWarning("EEIntegrityTask") << EcalElectronicsIdCollection2_ << " not available";
+  integritySummary_.update(e, c, integrityCollections_);
 
+  for ( int t = EEIntegritySummary::Gain; t <= EEIntegritySummary::MemGain; t++ ) {
+    if ( ! integritySummary_.found(t) ) edm::LogWarning("EEIntegrityTask") << integrityCollections_[t] << " not available";
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids6;
+  for ( int ism = 1; ism <= 18; ism++ ) {
 
-  if ( e.getByLabel(EcalElectronicsIdCollection3_, ids6) ) {
+    float xism = ism + 0.5;
 
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids6->begin(); idItr != ids6->end(); ++idItr ) {
-
-      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *idItr );
-
-      int itt   = idItr->towerId();
-      float iTt = itt + 0.5 - 69;
-
-      if ( meIntegrityMemTTId[ism-1] ) meIntegrityMemTTId[ism-1]->Fill(iTt,0);
+    int nDCCSize = integritySummary_.nIds(EEIntegritySummary::DCCSize, ism);
 
+    if ( meIntegrityDCCSize ) {
+      for ( int i = 0; i < nDCCSize; i++ ) meIntegrityDCCSize->Fill(xism);
     }
 
-  } else {
-
-    edm::LogWarning("EEIntegrityTask") << EcalElectronicsIdCollection3_ << " not available";
-
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids7;
+  // crystal errors count 1/850, tower errors 1/34 of the SM
 
-  if ( e.getByLabel(EcalElectronicsIdCollection4_, ids7) ) {
+  fillCrystals(integritySummary_.crystals(EEIntegritySummary::Gain), meIntegrityGain, 1./850.);
+  fillCrystals(integritySummary_.crystals(EEIntegritySummary::ChId), meIntegrityChId, 1./850.);
+  fillCrystals(integritySummary_.crystals(EEIntegritySummary::GainSwitch), meIntegrityGainSwitch, 1./850.);
+  fillCrystals(integritySummary_.crystals(EEIntegritySummary::TTId), meIntegrityTTId, 1./34.);
+  fillCrystals(integritySummary_.crystals(EEIntegritySummary::BlockSize), meIntegrityTTBlockSize, 1./34.);
 
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids7->begin(); idItr != ids7->end(); ++idItr ) {
+  fillMemTowers(integritySummary_.mems(EEIntegritySummary::MemTTId), meIntegrityMemTTId);
+  fillMemTowers(integritySummary_.mems(EEIntegritySummary::MemBlockSize), meIntegrityMemTTBlockSize);
 
-      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
+  fillMemChannels(integritySummary_.mems(EEIntegritySummary::MemChId), meIntegrityMemChId);
+  fillMemChannels(integritySummary_.mems(EEIntegritySummary::MemGain), meIntegrityMemGain);
 
-      int ism = Numbers::iSM( *idItr );
+}//  end analyze
 
-      int itt   = idItr->towerId();
-      float iTt = itt + 0.5 - 69;
+void EEIntegrityTask::fillCrystals(const std::vector<EEIntegritySummary::Crystal>& crystals, MonitorElement** me, double weight) {
 
-      if ( meIntegrityMemTTBlockSize[ism-1] ) meIntegrityMemTTBlockSize[ism-1]->Fill(iTt,0);
+  for ( unsigned int i = 0; i < crystals.size(); i++ ) {
 
-    }
+    int ism = crystals[i].ism;
+    float xism = ism + 0.5;
 
-  } else {
+    float xix = crystals[i].ix - 0.5;
+    float xiy = crystals[i].iy - 0.5;
 
-    edm::LogWarning("EEIntegrityTask") << EcalElectronicsIdCollection4_ << " not available";
+    if ( me[ism-1] ) me[ism-1]->Fill(xix, xiy);
+    if ( meIntegrityErrorsByLumi ) meIntegrityErrorsByLumi->Fill(xism, weight/crystals[i].n);
 
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids8;
-
-  if (  e.getByLabel(EcalElectronicsIdCollection5_, ids8) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids8->begin(); idItr != ids8->end(); ++idItr ) {
-
-      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *idItr );
-
-      int chid = idItr->channelId();
-      int ie = EEIntegrityTask::chMemAbscissa[chid-1];
-      int ip = EEIntegrityTask::chMemOrdinate[chid-1];
-
-      int itt = idItr->towerId();
-      ie += (itt-69)*5;
+}
 
-      float xix = ie - 0.5;
-      float xiy = ip - 0.5;
+void EEIntegrityTask::fillMemTowers(const std::vector<EEIntegritySummary::Mem>& mems, MonitorElement** me) {
 
-      if ( meIntegrityMemChId[ism-1] ) meIntegrityMemChId[ism-1]->Fill(xix,xiy);
+  for ( unsigned int i = 0; i < mems.size(); i++ ) {
 
-    }
+    int ism = mems[i].ism;
 
-  } else {
+    float iTt = mems[i].itt + 0.5 - 69;
 
-    edm::LogWarning("EEIntegrityTask") << EcalElectronicsIdCollection5_ << " not available";
+    if ( me[ism-1] ) me[ism-1]->Fill(iTt,0);
 
   }
 
-  edm::Handle<EcalElectronicsIdCollection> ids9;
-
-  if ( e.getByLabel(EcalElectronicsIdCollection6_, ids9) ) {
-
-    for ( EcalElectronicsIdCollection::const_iterator idItr = ids9->begin(); idItr != ids9->end(); ++idItr ) {
-
-      if ( Numbers::subDet( *idItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *idItr );
+}
 
-      int chid = idItr->channelId();
-      int ie = EEIntegrityTask::chMemAbscissa[chid-1];
-      int ip = EEIntegrityTask::chMemOrdinate[chid-1];
+void EEIntegrityTask::fillMemChannels(const std::vector<EEIntegritySummary::Mem>& mems, MonitorElement** me) {
 
-      int itt = idItr->towerId();
-      ie += (itt-69)*5;
+  for ( unsigned int i = 0; i < mems.size(); i++ ) {
 
-      float xix = ie - 0.5;
-      float xiy = ip - 0.5;
+    int ism = mems[i].ism;
 
-      if ( meIntegrityMemGain[ism-1] ) meIntegrityMemGain[ism-1]->Fill(xix,xiy);
+    int chid = mems[i].ich;
+    int ie = EEIntegrityTask::chMemAbscissa[chid-1];
+    int ip = EEIntegrityTask::chMemOrdinate[chid-1];
 
-    }
+    ie += (mems[i].itt-69)*5;
 
-  } else {
+    float xix = ie - 0.5;
+    float xiy = ip - 0.5;
 
-    edm::LogWarning("EEIntegrityTask") << EcalElectronicsIdCollection6_ << " not available";
+    if ( me[ism-1] ) me[ism-1]->Fill(xix,xiy);
 
   }
 
-}//  end analyze
+}
 
 const int  EEIntegrityTask::chMemAbscissa [25] = {
     1, 1, 1, 1, 1,
@@ -20,7 +20,6 @@
 
 #include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
-#include "DataFormats/EcalDigi/interface/EEDataFrame.h"
 #include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
 #include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
 #include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
@@ -30,7 +29,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EELaserTask.h"
 
-EELaserTask::EELaserTask(const edm::ParameterSet& ps){
+EELaserTask::EELaserTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()), digiScanner_(EEDigiScanner::shared()) {
 
   init_ = false;
 
@@ -42,6 +41,10 @@ EELaserTask::EELaserTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
   EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
@@ -136,10 +139,13 @@ EELaserTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup con
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EELaserTask::reset(void) {
 
+  instrumentation_.reset();
+
   for (int i = 0; i < 18; i++) {
     if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), 1) != laserWavelengths_.end() ) {
       if ( meShapeMapL1_[i] )  meShapeMapL1_[i]->Reset();
@@ -217,344 +223,199 @@ void EELaserTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EELaserTask");
+
   std::string name;
   std::stringstream LaserN, LN;
 
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask");
 
-    if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), 1) != laserWavelengths_.end() ) {
+    // the maps of each SM are booked on first use, in bookMaps() and bookPnMaps()
+
+    for ( int wl = 1; wl <= 4; wl++ ) {
+
+      if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), wl) == laserWavelengths_.end() ) continue;
+
+      MonitorElement** meAmplSummaryMap = 0;
+
+      if ( wl == 1 ) meAmplSummaryMap = meAmplSummaryMapL1_;
+      if ( wl == 2 ) meAmplSummaryMap = meAmplSummaryMapL2_;
+      if ( wl == 3 ) meAmplSummaryMap = meAmplSummaryMapL3_;
+      if ( wl == 4 ) meAmplSummaryMap = meAmplSummaryMapL4_;
 
       LaserN.str("");
-      LaserN << "Laser" << 1;
+      LaserN << "Laser" << wl;
       LN.str("");
-      LN << "L" << 1;
+      LN << "L" << wl;
 
       dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EELT shape " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meShapeMapL1_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapL1_[i]->setAxisTitle("channel", 1);
-        meShapeMapL1_[i]->setAxisTitle("sample", 2);
-        meShapeMapL1_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapL1_[i], i+1);
-
-	name = "EELT amplitude " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplMapL1_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapL1_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapL1_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapL1_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapL1_[i], i+1);
-
-	name = "EELT timing " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meTimeMapL1_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
-        meTimeMapL1_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meTimeMapL1_[i]->setAxisTitle("101-ix", 1);
-        meTimeMapL1_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meTimeMapL1_[i], i+1);
-
-	name = "EELT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str();
-        meAmplPNMapL1_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplPNMapL1_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMapL1_[i]->setAxisTitle("101-ix", 1);
-        meAmplPNMapL1_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplPNMapL1_[i], i+1);
-      }
 
       name = "EELT amplitude map " + LN.str() + " EE -";
-      meAmplSummaryMapL1_[0] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL1_[0]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL1_[0]->setAxisTitle("iy", 2);
+      meAmplSummaryMap[0] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
+      meAmplSummaryMap[0]->setAxisTitle("ix", 1);
+      meAmplSummaryMap[0]->setAxisTitle("iy", 2);
 
       name = "EELT amplitude map " + LN.str() + " EE +";
-      meAmplSummaryMapL1_[1] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL1_[1]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL1_[1]->setAxisTitle("iy", 2);
-
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN");
-
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN/Gain01");
-
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnAmplMapG01L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01L1_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01L1_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01L1_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnPedMapG01L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01L1_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01L1_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01L1_[i], i+1);
-      }
-
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN/Gain16");
-
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnAmplMapG16L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16L1_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16L1_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16L1_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnPedMapG16L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16L1_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16L1_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16L1_[i], i+1);
-      }
+      meAmplSummaryMap[1] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
+      meAmplSummaryMap[1]->setAxisTitle("ix", 1);
+      meAmplSummaryMap[1]->setAxisTitle("iy", 2);
 
     }
 
-    if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), 2) != laserWavelengths_.end() ) {
+  }
 
-      LaserN.str("");
-      LaserN << "Laser" << 2;
-      LN.str("");
-      LN << "L" << 2;
+  this->reportMemory("setup");
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EELT shape " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meShapeMapL2_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapL2_[i]->setAxisTitle("channel", 1);
-        meShapeMapL2_[i]->setAxisTitle("sample", 2);
-        meShapeMapL2_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapL2_[i], i+1);
-
-	name = "EELT amplitude " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplMapL2_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapL2_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapL2_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapL2_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapL2_[i], i+1);
-
-	name = "EELT timing " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meTimeMapL2_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
-        meTimeMapL2_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meTimeMapL2_[i]->setAxisTitle("101-ix", 1);
-        meTimeMapL2_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meTimeMapL2_[i], i+1);
-
-	name = "EELT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str();
-        meAmplPNMapL2_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplPNMapL2_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMapL2_[i]->setAxisTitle("101-ix", 1);
-        meAmplPNMapL2_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplPNMapL2_[i], i+1);
-      }
+}
 
-      name = "EELT amplitude map " + LN.str() + " EE -";
-      meAmplSummaryMapL2_[0] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL2_[0]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL2_[0]->setAxisTitle("iy", 2);
+void EELaserTask::bookMaps(int ism, int wl){
 
-      name = "EELT amplitude map " + LN.str() + " EE +";
-      meAmplSummaryMapL2_[1] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL2_[1]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL2_[1]->setAxisTitle("iy", 2);
+  if ( ism < 1 || ism > 18 ) return;
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnAmplMapG01L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01L2_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01L2_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01L2_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnPedMapG01L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01L2_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01L2_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01L2_[i], i+1);
-      }
+  MonitorElement** meShapeMap = 0;
+  MonitorElement** meAmplMap = 0;
+  MonitorElement** meTimeMap = 0;
+  MonitorElement** meAmplPNMap = 0;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN/Gain16");
+  if ( wl == 1 ) {
+    meShapeMap = meShapeMapL1_;
+    meAmplMap = meAmplMapL1_;
+    meTimeMap = meTimeMapL1_;
+    meAmplPNMap = meAmplPNMapL1_;
+  }
+  if ( wl == 2 ) {
+    meShapeMap = meShapeMapL2_;
+    meAmplMap = meAmplMapL2_;
+    meTimeMap = meTimeMapL2_;
+    meAmplPNMap = meAmplPNMapL2_;
+  }
+  if ( wl == 3 ) {
+    meShapeMap = meShapeMapL3_;
+    meAmplMap = meAmplMapL3_;
+    meTimeMap = meTimeMapL3_;
+    meAmplPNMap = meAmplPNMapL3_;
+  }
+  if ( wl == 4 ) {
+    meShapeMap = meShapeMapL4_;
+    meAmplMap = meAmplMapL4_;
+    meTimeMap = meTimeMapL4_;
+    meAmplPNMap = meAmplPNMapL4_;
+  }
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnAmplMapG16L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16L2_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16L2_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16L2_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnPedMapG16L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16L2_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16L2_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16L2_[i], i+1);
-      }
+  if ( ! meShapeMap ) return;
 
-    }
+  int i = ism-1;
 
-    if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), 3) != laserWavelengths_.end() ) {
+  if ( meShapeMap[i] ) return;
 
-      LaserN.str("");
-      LaserN << "Laser" << 3;
-      LN.str("");
-      LN << "L" << 3;
+  if ( ! init_ || ! dqmStore_ ) return;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EELT shape " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meShapeMapL3_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapL3_[i]->setAxisTitle("channel", 1);
-        meShapeMapL3_[i]->setAxisTitle("sample", 2);
-        meShapeMapL3_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapL3_[i], i+1);
-
-	name = "EELT amplitude " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplMapL3_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapL3_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapL3_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapL3_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapL3_[i], i+1);
-
-	name = "EELT timing " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meTimeMapL3_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
-        meTimeMapL3_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meTimeMapL3_[i]->setAxisTitle("101-ix", 1);
-        meTimeMapL3_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meTimeMapL3_[i], i+1);
-
-	name = "EELT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str();
-        meAmplPNMapL3_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplPNMapL3_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMapL3_[i]->setAxisTitle("101-ix", 1);
-        meAmplPNMapL3_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplPNMapL3_[i], i+1);
-      }
+  if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), wl) == laserWavelengths_.end() ) return;
 
-      name = "EELT amplitude map " + LN.str() + " EE -";
-      meAmplSummaryMapL3_[0] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL3_[0]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL3_[0]->setAxisTitle("iy", 2);
+  std::string name;
+  std::stringstream LaserN, LN;
 
-      name = "EELT amplitude map " + LN.str() + " EE +";
-      meAmplSummaryMapL3_[1] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL3_[1]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL3_[1]->setAxisTitle("iy", 2);
+  LaserN << "Laser" << wl;
+  LN << "L" << wl;
+
+  dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str());
+
+  name = "EELT shape " + Numbers::sEE(i+1) + " " + LN.str();
+  meShapeMap[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
+  meShapeMap[i]->setAxisTitle("channel", 1);
+  meShapeMap[i]->setAxisTitle("sample", 2);
+  meShapeMap[i]->setAxisTitle("amplitude", 3);
+  dqmStore_->tag(meShapeMap[i], i+1);
+
+  name = "EELT amplitude " + Numbers::sEE(i+1) + " " + LN.str();
+  meAmplMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
+  meAmplMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meAmplMap[i]->setAxisTitle("101-ix", 1);
+  meAmplMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meAmplMap[i], i+1);
+
+  name = "EELT timing " + Numbers::sEE(i+1) + " " + LN.str();
+  meTimeMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
+  meTimeMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meTimeMap[i]->setAxisTitle("101-ix", 1);
+  meTimeMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meTimeMap[i], i+1);
+
+  name = "EELT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str();
+  meAmplPNMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
+  meAmplPNMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMap[i]->setAxisTitle("101-ix", 1);
+  meAmplPNMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meAmplPNMap[i], i+1);
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnAmplMapG01L3_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01L3_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01L3_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01L3_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnPedMapG01L3_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01L3_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01L3_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01L3_[i], i+1);
-      }
+}
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN/Gain16");
+void EELaserTask::bookPnMaps(int ism, int wl, int gainId){
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnAmplMapG16L3_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16L3_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16L3_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16L3_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnPedMapG16L3_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16L3_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16L3_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16L3_[i], i+1);
-      }
+  if ( ism < 1 || ism > 18 ) return;
 
-    }
+  MonitorElement** mePnAmplMap = 0;
+  MonitorElement** mePnPedMap = 0;
 
-    if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), 4) != laserWavelengths_.end() ) {
-
-      LaserN.str("");
-      LaserN << "Laser" << 4;
-      LN.str("");
-      LN << "L" << 4;
+  if ( gainId == 0 ) {
+    if ( wl == 1 ) { mePnAmplMap = mePnAmplMapG01L1_; mePnPedMap = mePnPedMapG01L1_; }
+    if ( wl == 2 ) { mePnAmplMap = mePnAmplMapG01L2_; mePnPedMap = mePnPedMapG01L2_; }
+    if ( wl == 3 ) { mePnAmplMap = mePnAmplMapG01L3_; mePnPedMap = mePnPedMapG01L3_; }
+    if ( wl == 4 ) { mePnAmplMap = mePnAmplMapG01L4_; mePnPedMap = mePnPedMapG01L4_; }
+  }
+  if ( gainId == 1 ) {
+    if ( wl == 1 ) { mePnAmplMap = mePnAmplMapG16L1_; mePnPedMap = mePnPedMapG16L1_; }
+    if ( wl == 2 ) { mePnAmplMap = mePnAmplMapG16L2_; mePnPedMap = mePnPedMapG16L2_; }
+    if ( wl == 3 ) { mePnAmplMap = mePnAmplMapG16L3_; mePnPedMap = mePnPedMapG16L3_; }
+    if ( wl == 4 ) { mePnAmplMap = mePnAmplMapG16L4_; mePnPedMap = mePnPedMapG16L4_; }
+  }
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EELT shape " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meShapeMapL4_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapL4_[i]->setAxisTitle("channel", 1);
-        meShapeMapL4_[i]->setAxisTitle("sample", 2);
-        meShapeMapL4_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapL4_[i], i+1);
-
-	name = "EELT amplitude " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplMapL4_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapL4_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapL4_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapL4_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapL4_[i], i+1);
-
-	name = "EELT timing " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meTimeMapL4_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
-        meTimeMapL4_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meTimeMapL4_[i]->setAxisTitle("101-ix", 1);
-        meTimeMapL4_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meTimeMapL4_[i], i+1);
-
-	name = "EELT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str();
-        meAmplPNMapL4_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplPNMapL4_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMapL4_[i]->setAxisTitle("101-ix", 1);
-        meAmplPNMapL4_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplPNMapL4_[i], i+1);
-      }
+  if ( ! mePnAmplMap ) return;
 
-      name = "EELT amplitude map " + LN.str() + " EE -";
-      meAmplSummaryMapL4_[0] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL4_[0]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL4_[0]->setAxisTitle("iy", 2);
+  int i = ism-1;
 
-      name = "EELT amplitude map " + LN.str() + " EE +";
-      meAmplSummaryMapL4_[1] = dqmStore_->bookProfile2D(name, name, 20, 0., 100., 20, 0., 100., 0., 4096.);
-      meAmplSummaryMapL4_[1]->setAxisTitle("ix", 1);
-      meAmplSummaryMapL4_[1]->setAxisTitle("iy", 2);
+  if ( mePnAmplMap[i] ) return;
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnAmplMapG01L4_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01L4_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01L4_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01L4_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G01 " + LN.str(); 
-        mePnPedMapG01L4_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01L4_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01L4_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01L4_[i], i+1);
-      }
+  if ( ! init_ || ! dqmStore_ ) return;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN/Gain16");
+  if ( find(laserWavelengths_.begin(), laserWavelengths_.end(), wl) == laserWavelengths_.end() ) return;
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnAmplMapG16L4_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16L4_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16L4_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16L4_[i], i+1);
-
-	name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnPedMapG16L4_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16L4_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16L4_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16L4_[i], i+1);
-      }
+  std::string name;
+  std::stringstream LaserN, LN, GN;
 
-    }
+  LaserN << "Laser" << wl;
+  LN << "L" << wl;
+  GN << ( gainId == 0 ? "01" : "16" );
 
+  // the G01 maps of L2-L4 have always lived in the LaserN folder
+  if ( gainId == 0 && wl != 1 ) {
+    dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str());
+  } else {
+    dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask/" + LaserN.str() + "/PN/Gain" + GN.str());
   }
 
+  name = "EELT PNs amplitude " + Numbers::sEE(i+1) + " G" + GN.str() + " " + LN.str();
+  mePnAmplMap[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
+  mePnAmplMap[i]->setAxisTitle("channel", 1);
+  mePnAmplMap[i]->setAxisTitle("amplitude", 2);
+  dqmStore_->tag(mePnAmplMap[i], i+1);
+
+  name = "EELT PNs pedestal " + Numbers::sEE(i+1) + " G" + GN.str() + " " + LN.str();
+  mePnPedMap[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
+  mePnPedMap[i]->setAxisTitle("channel", 1);
+  mePnPedMap[i]->setAxisTitle("pedestal", 2);
+  dqmStore_->tag(mePnPedMap[i], i+1);
+
 }
 
 void EELaserTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EELaserTask");
 
@@ -731,12 +592,30 @@ void EELaserTask::endJob(void){
 
   edm::LogInfo("EELaserTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EELaserTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+  memoryReport_.add("digiScanner_ (shared)", &digiScanner_, 1);
+  memoryReport_.add("digiScanner_.view() (shared)", &digiScanner_.view(), 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EELaserTask", "EELaserTask", when);
+
+}
+
 void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   bool enable = false;
   int runType[18];
   for (int i=0; i<18; i++) runType[i] = -1;
@@ -747,23 +626,18 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
-
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
-
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-      runType[ism-1] = dcchItr->getRunType();
-      rtHalf[ism-1] = dcchItr->getRtHalf();
-      waveLength[ism-1] = dcchItr->getEventSettings().wavelength;
-
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::LASER_STD ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::LASER_GAP ) enable = true;
+    dccHeaders_.update(e, dcchs);
 
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      runType[ism-1] = dccHeaders_.runType(ism);
+      rtHalf[ism-1] = dccHeaders_.rtHalf(ism);
+      waveLength[ism-1] = dccHeaders_.waveLength(ism);
     }
 
+    if ( dccHeaders_.classes() & EEDccHeaderSummary::Laser ) enable = true;
+
   } else {
 
     edm::LogWarning("EELaserTask") << EcalRawDataCollection_ << " not available";
@@ -776,6 +650,13 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   ievt_++;
 
+  // book the maps of the SMs in laser mode here, once per event, not per frame or hit
+  for ( int ism = 1; ism <= 18; ism++ ) {
+    if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::LASER_STD ||
+             runType[ism-1] == EcalDCCHeaderBlock::LASER_GAP ) ) continue;
+    if ( rtHalf[ism-1] == 0 || rtHalf[ism-1] == 1 ) this->bookMaps(ism, waveLength[ism-1]+1);
+  }
+
   bool numPN[80];
   float adcPN[80];
   for ( int i = 0; i < 80; i++ ) {
@@ -788,42 +669,33 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EEDigiCollection> digis;
 
-  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, digis->size());
 
     int maxpos[10];
     for(int i(0); i < 10; i++)
       maxpos[i] = 0;
     int nReadouts(0);
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    digiScanner_.update(e, c, digis, dcchs.isValid() ? &dccHeaders_ : 0);
 
-      EEDetId id = digiItr->id();
+    const std::vector<EEDigiScanner::Frame>& frames = digiScanner_.frames();
+    const EEDigiView& view = digiScanner_.view();
 
-      int ism = Numbers::iSM( id );
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-      if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::LASER_STD ||
-               runType[ism-1] == EcalDCCHeaderBlock::LASER_GAP ) ) continue;
+      const EEDigiScanner::Frame& f = frames[n];
 
-      if ( rtHalf[ism-1] != Numbers::RtHalf(id) ) continue;
+      if ( ! ( f.runType == EcalDCCHeaderBlock::LASER_STD ||
+               f.runType == EcalDCCHeaderBlock::LASER_GAP ) ) continue;
 
-      nReadouts++;
+      if ( rtHalf[f.ism-1] != f.rtHalf ) continue;
 
-      EEDataFrame dataframe = (*digiItr);
+      nReadouts++;
 
-      int iMax(-1);
-      float max(0.);
-      float min(4096.);
-      for (int i = 0; i < 10; i++) {
-        int adc = dataframe.sample(i).adc();
-	if(adc > max){
-	  max = adc;
-	  iMax = i;
-	}
-	if(adc < min)
-	  min = adc;
-      }
-      if(iMax >= 0 && max - min > 20.)
-	maxpos[iMax] += 1;
+      if(f.imax >= 0 && f.span > 20)
+	maxpos[f.imax] += 1;
 
     }
 
@@ -841,27 +713,25 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
     int need = digis->size();
     LogDebug("EELaserTask") << "event " << ievt_ << " digi collection size " << need;
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-      EEDetId id = digiItr->id();
+      const EEDigiScanner::Frame& f = frames[n];
 
-      int ix = id.ix();
-      int iy = id.iy();
+      if ( ! ( f.runType == EcalDCCHeaderBlock::LASER_STD ||
+               f.runType == EcalDCCHeaderBlock::LASER_GAP ) ) continue;
 
-      int ism = Numbers::iSM( id );
+      int ism = f.ism;
 
-      if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::LASER_STD ||
-               runType[ism-1] == EcalDCCHeaderBlock::LASER_GAP ) ) continue;
-
-      if ( rtHalf[ism-1] != Numbers::RtHalf(id) ) continue;
+      int ix = f.ix;
+      int iy = f.iy;
 
-      int ic = Numbers::icEE(ism, ix, iy);
+      if ( rtHalf[ism-1] != f.rtHalf ) continue;
 
-      EEDataFrame dataframe = (*digiItr);
+      int ic = f.ic;
 
       for (int i = 0; i < 10; i++) {
 
-        int adc = dataframe.sample(i).adc();
+        int adc = view.adc(i)[f.index];
 
         MonitorElement* meShapeMap = 0;
 
@@ -901,7 +771,7 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalPnDiodeDigiCollection> pns;
 
-  if ( e.getByLabel(EcalPnDiodeDigiCollection_, pns) ) {
+  if ( instrumentation_.getByLabel(e, EcalPnDiodeDigiCollection_, pns) ) {
 
     int nep = pns->size();
     LogDebug("EELaserTask") << "event " << ievt_ << " pns collection size " << nep;
@@ -929,6 +799,8 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
         MonitorElement* mePNPed = 0;
 
+        this->bookPnMaps(ism, waveLength[ism-1]+1, pnItr->sample(i).gainId());
+
         if ( pnItr->sample(i).gainId() == 0 ) {
           if ( waveLength[ism-1] == 0 ) mePNPed = mePnPedMapG01L1_[ism-1];
           if ( waveLength[ism-1] == 1 ) mePNPed = mePnPedMapG01L2_[ism-1];
@@ -968,6 +840,8 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
       xvalmax = xvalmax - xvalped;
 
+      this->bookPnMaps(ism, waveLength[ism-1]+1, pnItr->sample(0).gainId());
+
       if ( pnItr->sample(0).gainId() == 0 ) {
         if ( waveLength[ism-1] == 0 ) mePN = mePnAmplMapG01L1_[ism-1];
         if ( waveLength[ism-1] == 1 ) mePN = mePnAmplMapG01L2_[ism-1];
@@ -995,7 +869,9 @@ void EELaserTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalUncalibratedRecHitCollection> hits;
 
-  if ( e.getByLabel(EcalUncalibratedRecHitCollection_, hits) ) {
+  if ( instrumentation_.getByLabel(e, EcalUncalibratedRecHitCollection_, hits) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::RecHits, hits->size());
 
     int neh = hits->size();
     LogDebug("EELaserTask") << "event " << ievt_ << " hits collection size " << neh;
@@ -23,7 +23,6 @@
 #include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
 #include "DataFormats/EcalDetId/interface/EcalElectronicsId.h"
-#include "DataFormats/EcalDigi/interface/EEDataFrame.h"
 #include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
 #include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
 #include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
@@ -33,7 +32,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EELedTask.h"
 
-EELedTask::EELedTask(const edm::ParameterSet& ps){
+EELedTask::EELedTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()), digiScanner_(EEDigiScanner::shared()) {
 
   init_ = false;
 
@@ -45,6 +44,10 @@ EELedTask::EELedTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
   EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
@@ -144,169 +147,158 @@ EELedTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EELedTask::reset(void) {
 
+  instrumentation_.reset();
+
 }
 
 void EELedTask::setup(void){
 
   init_ = true;
 
-  std::string name;
-  std::stringstream LedN, LN;
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EELedTask");
 
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask");
 
-    if ( find(ledWavelengths_.begin(), ledWavelengths_.end(), 1) != ledWavelengths_.end() ) {
+    // the maps of each SM are booked on first use, in bookMaps() and bookPnMaps()
 
-      LedN.str("");
-      LedN << "Led" << 1;
-      LN.str("");
-      LN << "L" << 1;
+  }
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EELDT shape " + Numbers::sEE(i+1) + " " + LN.str();
-        meShapeMapL1_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapL1_[i]->setAxisTitle("channel", 1);
-        meShapeMapL1_[i]->setAxisTitle("sample", 2);
-        meShapeMapL1_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapL1_[i], i+1);
-
-	name = "EELDT amplitude " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplMapL1_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapL1_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapL1_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapL1_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapL1_[i], i+1);
-
-	name = "EELDT timing " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meTimeMapL1_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
-        meTimeMapL1_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meTimeMapL1_[i]->setAxisTitle("101-ix", 1);
-        meTimeMapL1_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meTimeMapL1_[i], i+1);
-
-	name = "EELDT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplPNMapL1_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplPNMapL1_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMapL1_[i]->setAxisTitle("101-ix", 1);
-        meAmplPNMapL1_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplPNMapL1_[i], i+1);
-      }
+  this->reportMemory("setup");
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN");
+}
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN/Gain01");
-      for (int i = 0; i < 18; i++) {
-	name = "EELDT PNs amplitude " + Numbers::sEE(i+1) + " G01 " + LN.str();
-        mePnAmplMapG01L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01L1_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01L1_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01L1_[i], i+1);
-
-	name = "EELDT PNs pedestal " + Numbers::sEE(i+1) + " G01 " + LN.str();
-        mePnPedMapG01L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01L1_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01L1_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01L1_[i], i+1);
-      }
+void EELedTask::bookMaps(int ism, int waveLength){
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN/Gain16");
+  if ( ism < 1 || ism > 18 ) return;
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELDT PNs amplitude " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnAmplMapG16L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16L1_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16L1_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16L1_[i], i+1);
-
-	name = "EELDT PNs pedestal " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnPedMapG16L1_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16L1_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16L1_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16L1_[i], i+1);
-      }
+  int led = 0;
 
-    }
+  if ( waveLength == 0 ) led = 1;
+  if ( waveLength == 2 ) led = 2;
 
-    if ( find(ledWavelengths_.begin(), ledWavelengths_.end(), 2) != ledWavelengths_.end() ) {
+  MonitorElement** meShapeMap = 0;
+  MonitorElement** meAmplMap = 0;
+  MonitorElement** meTimeMap = 0;
+  MonitorElement** meAmplPNMap = 0;
 
-      LedN.str("");
-      LedN << "Led" << 2;
-      LN.str("");
-      LN << "L" << 2;
+  if ( led == 1 ) {
+    meShapeMap = meShapeMapL1_;
+    meAmplMap = meAmplMapL1_;
+    meTimeMap = meTimeMapL1_;
+    meAmplPNMap = meAmplPNMapL1_;
+  }
+  if ( led == 2 ) {
+    meShapeMap = meShapeMapL2_;
+    meAmplMap = meAmplMapL2_;
+    meTimeMap = meTimeMapL2_;
+    meAmplPNMap = meAmplPNMapL2_;
+  }
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EELDT shape " + Numbers::sEE(i+1) + " " + LN.str();
-        meShapeMapL2_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapL2_[i]->setAxisTitle("channel", 1);
-        meShapeMapL2_[i]->setAxisTitle("sample", 2);
-        meShapeMapL2_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapL2_[i], i+1);
-
-	name = "EELDT amplitude " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplMapL2_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapL2_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapL2_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapL2_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapL2_[i], i+1);
-
-	name = "EELDT timing " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meTimeMapL2_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
-        meTimeMapL2_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meTimeMapL2_[i]->setAxisTitle("101-ix", 1);
-        meTimeMapL2_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meTimeMapL2_[i], i+1);
-
-	name = "EELDT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str(); 
-        meAmplPNMapL2_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplPNMapL2_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMapL2_[i]->setAxisTitle("101-ix", 1);
-        meAmplPNMapL2_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplPNMapL2_[i], i+1);
-      }
+  if ( ! meShapeMap ) return;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN");
+  int i = ism-1;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN/Gain01");
-      for (int i = 0; i < 18; i++) {
-	name = "EELDT PNs amplitude " + Numbers::sEE(i+1) + " G01 " + LN.str();
-        mePnAmplMapG01L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01L2_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01L2_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01L2_[i], i+1);
-
-	name = "EELDT PNs pedestal " + Numbers::sEE(i+1) + " G01 " + LN.str();
-        mePnPedMapG01L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01L2_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01L2_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01L2_[i], i+1);
-      }
+  if ( meShapeMap[i] ) return;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN/Gain16");
+  if ( ! init_ || ! dqmStore_ ) return;
 
-      for (int i = 0; i < 18; i++) {
-	name = "EELDT PNs amplitude " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnAmplMapG16L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16L2_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16L2_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16L2_[i], i+1);
-
-	name = "EELDT PNs pedestal " + Numbers::sEE(i+1) + " G16 " + LN.str();
-        mePnPedMapG16L2_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16L2_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16L2_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16L2_[i], i+1);
-      }
+  if ( find(ledWavelengths_.begin(), ledWavelengths_.end(), led) == ledWavelengths_.end() ) return;
 
-    }
+  std::string name;
+  std::stringstream LedN, LN;
+
+  LedN << "Led" << led;
+  LN << "L" << led;
+
+  dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str());
+
+  name = "EELDT shape " + Numbers::sEE(i+1) + " " + LN.str();
+  meShapeMap[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
+  meShapeMap[i]->setAxisTitle("channel", 1);
+  meShapeMap[i]->setAxisTitle("sample", 2);
+  meShapeMap[i]->setAxisTitle("amplitude", 3);
+  dqmStore_->tag(meShapeMap[i], i+1);
+
+  name = "EELDT amplitude " + Numbers::sEE(i+1) + " " + LN.str();
+  meAmplMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
+  meAmplMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meAmplMap[i]->setAxisTitle("101-ix", 1);
+  meAmplMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meAmplMap[i], i+1);
+
+  name = "EELDT timing " + Numbers::sEE(i+1) + " " + LN.str();
+  meTimeMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 250, 0., 10., "s");
+  meTimeMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meTimeMap[i]->setAxisTitle("101-ix", 1);
+  meTimeMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meTimeMap[i], i+1);
+
+  name = "EELDT amplitude over PN " + Numbers::sEE(i+1) + " " + LN.str();
+  meAmplPNMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
+  meAmplPNMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meAmplPNMap[i]->setAxisTitle("101-ix", 1);
+  meAmplPNMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meAmplPNMap[i], i+1);
+
+}
+
+void EELedTask::bookPnMaps(int ism, int waveLength, int gainId){
+
+  if ( ism < 1 || ism > 18 ) return;
 
+  int led = 0;
+
+  if ( waveLength == 0 ) led = 1;
+  if ( waveLength == 2 ) led = 2;
+
+  MonitorElement** mePnAmplMap = 0;
+  MonitorElement** mePnPedMap = 0;
+
+  if ( gainId == 0 ) {
+    if ( led == 1 ) { mePnAmplMap = mePnAmplMapG01L1_; mePnPedMap = mePnPedMapG01L1_; }
+    if ( led == 2 ) { mePnAmplMap = mePnAmplMapG01L2_; mePnPedMap = mePnPedMapG01L2_; }
   }
+  if ( gainId == 1 ) {
+    if ( led == 1 ) { mePnAmplMap = mePnAmplMapG16L1_; mePnPedMap = mePnPedMapG16L1_; }
+    if ( led == 2 ) { mePnAmplMap = mePnAmplMapG16L2_; mePnPedMap = mePnPedMapG16L2_; }
+  }
+
+  if ( ! mePnAmplMap ) return;
+
+  int i = ism-1;
+
+  if ( mePnAmplMap[i] ) return;
+
+  if ( ! init_ || ! dqmStore_ ) return;
+
+  if ( find(ledWavelengths_.begin(), ledWavelengths_.end(), led) == ledWavelengths_.end() ) return;
+
+  std::string name;
+  std::stringstream LedN, LN, GN;
+
+  LedN << "Led" << led;
+  LN << "L" << led;
+  GN << ( gainId == 0 ? "01" : "16" );
+
+  dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask/" + LedN.str() + "/PN/Gain" + GN.str());
+
+  name = "EELDT PNs amplitude " + Numbers::sEE(i+1) + " G" + GN.str() + " " + LN.str();
+  mePnAmplMap[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
+  mePnAmplMap[i]->setAxisTitle("channel", 1);
+  mePnAmplMap[i]->setAxisTitle("amplitude", 2);
+  dqmStore_->tag(mePnAmplMap[i], i+1);
+
+  name = "EELDT PNs pedestal " + Numbers::sEE(i+1) + " G" + GN.str() + " " + LN.str();
+  mePnPedMap[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
+  mePnPedMap[i]->setAxisTitle("channel", 1);
+  mePnPedMap[i]->setAxisTitle("pedestal", 2);
+  dqmStore_->tag(mePnPedMap[i], i+1);
 
 }
 
@@ -314,6 +306,9 @@ void EELedTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EELedTask");
 
@@ -403,12 +398,30 @@ void EELedTask::endJob(void){
 
   edm::LogInfo("EELedTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EELedTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+  memoryReport_.add("digiScanner_ (shared)", &digiScanner_, 1);
+  memoryReport_.add("digiScanner_.view() (shared)", &digiScanner_.view(), 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EELedTask", "EELedTask", when);
+
+}
+
 void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   bool enable = false;
   int runType[18];
   for (int i=0; i<18; i++) runType[i] = -1;
@@ -419,23 +432,18 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
-
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
-
-      runType[ism-1] = dcchItr->getRunType();
-      rtHalf[ism-1] = dcchItr->getRtHalf();
-      waveLength[ism-1] = dcchItr->getEventSettings().wavelength;
-
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::LED_STD ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::LED_GAP ) enable = true;
+    dccHeaders_.update(e, dcchs);
 
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      runType[ism-1] = dccHeaders_.runType(ism);
+      rtHalf[ism-1] = dccHeaders_.rtHalf(ism);
+      waveLength[ism-1] = dccHeaders_.waveLength(ism);
     }
 
+    if ( dccHeaders_.classes() & EEDccHeaderSummary::Led ) enable = true;
+
   } else {
 
     edm::LogWarning("EELedTask") << EcalRawDataCollection_ << " not available";
@@ -448,6 +456,13 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   ievt_++;
 
+  // book the maps of the SMs in LED mode here, once per event, not per frame or hit
+  for ( int ism = 1; ism <= 18; ism++ ) {
+    if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::LED_STD ||
+             runType[ism-1] == EcalDCCHeaderBlock::LED_GAP ) ) continue;
+    this->bookMaps(ism, waveLength[ism-1]);
+  }
+
   bool numPN[80];
   float adcPN[80];
   for ( int i = 0; i < 80; i++ ) {
@@ -460,42 +475,33 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EEDigiCollection> digis;
 
-  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, digis->size());
 
     int maxpos[10];
     for(int i(0); i < 10; i++)
       maxpos[i] = 0;
     int nReadouts(0);
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    digiScanner_.update(e, c, digis, dcchs.isValid() ? &dccHeaders_ : 0);
 
-      EEDetId id = digiItr->id();
+    const std::vector<EEDigiScanner::Frame>& frames = digiScanner_.frames();
+    const EEDigiView& view = digiScanner_.view();
 
-      int ism = Numbers::iSM( id );
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-      if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::LED_STD ||
-               runType[ism-1] == EcalDCCHeaderBlock::LED_GAP ) ) continue;
+      const EEDigiScanner::Frame& f = frames[n];
 
-      if ( rtHalf[ism-1] != Numbers::RtHalf(id) ) continue;
+      if ( ! ( f.runType == EcalDCCHeaderBlock::LED_STD ||
+               f.runType == EcalDCCHeaderBlock::LED_GAP ) ) continue;
 
-      nReadouts++;
+      if ( rtHalf[f.ism-1] != f.rtHalf ) continue;
 
-      EEDataFrame dataframe = (*digiItr);
+      nReadouts++;
 
-      int iMax(-1);
-      float max(0.);
-      float min(4096.);
-      for (int i = 0; i < 10; i++) {
-        int adc = dataframe.sample(i).adc();
-	if(adc > max){
-	  max = adc;
-	  iMax = i;
-	}
-	if(adc < min)
-	  min = adc;
-      }
-      if(iMax >= 0 && max - min > 10.)
-	maxpos[iMax] += 1;
+      if(f.imax >= 0 && f.span > 10)
+	maxpos[f.imax] += 1;
 
     }
 
@@ -513,39 +519,37 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
     int need = digis->size();
     LogDebug("EELedTask") << "event " << ievt_ << " digi collection size " << need;
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-      EEDetId id = digiItr->id();
+      const EEDigiScanner::Frame& f = frames[n];
 
-      int ix = id.ix();
-      int iy = id.iy();
+      if ( ! ( f.runType == EcalDCCHeaderBlock::LED_STD ||
+               f.runType == EcalDCCHeaderBlock::LED_GAP ) ) continue;
 
-      int ism = Numbers::iSM( id );
+      int ism = f.ism;
 
-      if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::LED_STD ||
-               runType[ism-1] == EcalDCCHeaderBlock::LED_GAP ) ) continue;
+      int ix = f.ix;
+      int iy = f.iy;
 
       if ( runType[ism-1] == EcalDCCHeaderBlock::LED_GAP &&
-           rtHalf[ism-1] != Numbers::RtHalf(id) ) continue;
-
-      int ic = Numbers::icEE(ism, ix, iy);
+           rtHalf[ism-1] != f.rtHalf ) continue;
 
-      EEDataFrame dataframe = (*digiItr);
+      int ic = f.ic;
 
       for (int i = 0; i < 10; i++) {
 
-        int adc = dataframe.sample(i).adc();
+        int adc = view.adc(i)[f.index];
 
         MonitorElement* meShapeMap = 0;
 
-        if ( Numbers::RtHalf(id) == 0 || Numbers::RtHalf(id) == 1 ) {
+        if ( f.rtHalf == 0 || f.rtHalf == 1 ) {
 
           if ( waveLength[ism-1] == 0 ) meShapeMap = meShapeMapL1_[ism-1];
           if ( waveLength[ism-1] == 2 ) meShapeMap = meShapeMapL2_[ism-1];
 
         } else {
 
-          edm::LogWarning("EELedTask") << " RtHalf = " << Numbers::RtHalf(id);
+          edm::LogWarning("EELedTask") << " RtHalf = " << f.rtHalf;
 
         }
 
@@ -572,7 +576,7 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalPnDiodeDigiCollection> pns;
 
-  if ( e.getByLabel(EcalPnDiodeDigiCollection_, pns) ) {
+  if ( instrumentation_.getByLabel(e, EcalPnDiodeDigiCollection_, pns) ) {
 
     int nep = pns->size();
     LogDebug("EELedTask") << "event " << ievt_ << " pns collection size " << nep;
@@ -600,6 +604,8 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
         MonitorElement* mePNPed = 0;
 
+        this->bookPnMaps(ism, waveLength[ism-1], pnItr->sample(i).gainId());
+
         if ( pnItr->sample(i).gainId() == 0 ) {
           if ( waveLength[ism-1] == 0 ) mePNPed = mePnPedMapG01L1_[ism-1];
           if ( waveLength[ism-1] == 2 ) mePNPed = mePnPedMapG01L2_[ism-1];
@@ -635,6 +641,8 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
       xvalmax = xvalmax - xvalped;
 
+      this->bookPnMaps(ism, waveLength[ism-1], pnItr->sample(0).gainId());
+
       if ( pnItr->sample(0).gainId() == 0 ) {
         if ( waveLength[ism-1] == 0 ) mePN = mePnAmplMapG01L1_[ism-1];
         if ( waveLength[ism-1] == 2 ) mePN = mePnAmplMapG01L2_[ism-1];
@@ -658,7 +666,9 @@ void EELedTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalUncalibratedRecHitCollection> hits;
 
-  if ( e.getByLabel(EcalUncalibratedRecHitCollection_, hits) ) {
+  if ( instrumentation_.getByLabel(e, EcalUncalibratedRecHitCollection_, hits) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::RecHits, hits->size());
 
     int neh = hits->size();
     LogDebug("EELedTask") << "event " << ievt_ << " hits collection size " << neh;
@@ -0,0 +1,205 @@
+/*
+ * \file EEMemoryReport.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include <map>
+#include <sstream>
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DQMServices/Core/interface/MonitorElement.h"
+
+#include "DQMServices/Core/interface/DQMStore.h"
+
+#include "TH1.h"
+#include "TClass.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEMemoryReport.h"
+
+EEMemoryReport::EEMemoryReport() {
+
+  enabled_ = false;
+
+  meMemory_ = 0;
+
+}
+
+EEMemoryReport::~EEMemoryReport() {
+
+}
+
+void EEMemoryReport::enable(bool enabled) {
+
+  enabled_ = enabled;
+
+}
+
+bool EEMemoryReport::enabled(void) const {
+
+  return enabled_;
+
+}
+
+void EEMemoryReport::clear(void) {
+
+  buffers_.clear();
+
+}
+
+void EEMemoryReport::add(const std::string& name, size_t bytes) {
+
+  buffers_.push_back(std::make_pair(name, bytes));
+
+}
+
+size_t EEMemoryReport::bytes(MonitorElement* me) {
+
+  if ( ! me ) return 0;
+
+  size_t bytes = sizeof(MonitorElement) + me->getName().size();
+
+  TH1* h = me->getTH1();
+
+  if ( ! h ) return bytes;
+
+  bytes += h->IsA()->Size();
+
+  size_t cells = h->GetNbinsX() + 2;
+  if ( h->GetDimension() >= 2 ) cells *= h->GetNbinsY() + 2;
+  if ( h->GetDimension() >= 3 ) cells *= h->GetNbinsZ() + 2;
+
+  size_t perCell = 0;
+
+  switch ( me->kind() ) {
+  case MonitorElement::DQM_KIND_TH1S:
+  case MonitorElement::DQM_KIND_TH2S:
+    perCell = 2;
+    break;
+  case MonitorElement::DQM_KIND_TH1F:
+  case MonitorElement::DQM_KIND_TH2F:
+  case MonitorElement::DQM_KIND_TH3F:
+    perCell = 4;
+    break;
+  case MonitorElement::DQM_KIND_TH1D:
+  case MonitorElement::DQM_KIND_TH2D:
+    perCell = 8;
+    break;
+  case MonitorElement::DQM_KIND_TPROFILE:
+    // contents and entries
+    perCell = 16;
+    if ( me->getTProfile()->GetBinSumw2()->fN ) perCell += 8;
+    break;
+  case MonitorElement::DQM_KIND_TPROFILE2D:
+    perCell = 16;
+    if ( me->getTProfile2D()->GetBinSumw2()->fN ) perCell += 8;
+    break;
+  default:
+    break;
+  }
+
+  if ( h->GetSumw2N() ) perCell += 8;
+
+  return bytes + cells * perCell;
+
+}
+
+void EEMemoryReport::report(DQMStore* dqmStore, const std::string& prefixME, const std::string& folder, const std::string& task, const std::string& when) {
+
+  if ( ! enabled_ || ! dqmStore ) return;
+
+  // bytes and MEs per folder, below prefixME/folder
+  std::map<std::string, std::pair<size_t, int> > folders;
+
+  std::string top = prefixME + "/" + folder;
+
+  std::vector<MonitorElement*> mes = dqmStore->getAllContents(top);
+
+  size_t meBytes = 0;
+
+  for ( unsigned int i = 0; i < mes.size(); i++ ) {
+
+    std::string path = mes[i]->getPathname();
+    if ( path.compare(0, top.size(), top) == 0 ) path = folder + path.substr(top.size());
+
+    size_t bytes = EEMemoryReport::bytes(mes[i]);
+
+    folders[path].first += bytes;
+    folders[path].second++;
+
+    meBytes += bytes;
+
+  }
+
+  size_t bufferBytes = 0;
+
+  for ( unsigned int i = 0; i < buffers_.size(); i++ ) bufferBytes += buffers_[i].second;
+
+  std::stringstream s;
+
+  s << task << " memory at " << when << ": "
+    << meBytes + bufferBytes << " bytes, "
+    << meBytes << " in " << mes.size() << " MEs, "
+    << bufferBytes << " in " << buffers_.size() << " buffers";
+
+  for ( std::map<std::string, std::pair<size_t, int> >::const_iterator it = folders.begin(); it != folders.end(); ++it ) {
+    s << "\n  folder " << it->first << ": " << it->second.first << " bytes in " << it->second.second << " MEs";
+  }
+
+  for ( unsigned int i = 0; i < buffers_.size(); i++ ) {
+    s << "\n  buffer " << buffers_[i].first << ": " << buffers_[i].second << " bytes";
+  }
+
+  edm::LogInfo("EEMemoryReport") << s.str();
+
+  // the number of bins follows the folders, book again
+  this->cleanup(dqmStore);
+
+  folder_ = prefixME + "/MemoryReport";
+
+  dqmStore->setCurrentFolder(folder_);
+
+  int nbins = 2 + folders.size() + buffers_.size();
+
+  std::string name = "EEMR " + task + " memory";
+  meMemory_ = dqmStore->book1D(name, name, nbins, 0., nbins);
+  meMemory_->setAxisTitle("kB", 2);
+
+  int bin = 1;
+
+  meMemory_->setBinLabel(bin, "MEs", 1);
+  meMemory_->setBinContent(bin++, meBytes / 1024.);
+
+  meMemory_->setBinLabel(bin, "buffers", 1);
+  meMemory_->setBinContent(bin++, bufferBytes / 1024.);
+
+  for ( std::map<std::string, std::pair<size_t, int> >::const_iterator it = folders.begin(); it != folders.end(); ++it ) {
+    meMemory_->setBinLabel(bin, it->first, 1);
+    meMemory_->setBinContent(bin++, it->second.first / 1024.);
+  }
+
+  for ( unsigned int i = 0; i < buffers_.size(); i++ ) {
+    meMemory_->setBinLabel(bin, buffers_[i].first, 1);
+    meMemory_->setBinContent(bin++, buffers_[i].second / 1024.);
+  }
+
+}
+
+void EEMemoryReport::cleanup(DQMStore* dqmStore) {
+
+  if ( dqmStore && meMemory_ ) {
+
+    dqmStore->setCurrentFolder(folder_);
+
+    dqmStore->removeElement( meMemory_->getName() );
+
+  }
+
+  meMemory_ = 0;
+
+}
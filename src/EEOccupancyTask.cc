@@ -35,7 +35,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEOccupancyTask.h"
 
-EEOccupancyTask::EEOccupancyTask(const edm::ParameterSet& ps){
+EEOccupancyTask::EEOccupancyTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()), digiScanner_(EEDigiScanner::shared()) {
 
   init_ = false;
 
@@ -51,6 +51,10 @@ EEOccupancyTask::EEOccupancyTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
   EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
@@ -165,10 +169,13 @@ EEOccupancyTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EEOccupancyTask::reset(void) {
 
+  instrumentation_.reset();
+
   for (int i = 0; i < 18; i++) {
     if ( meOccupancy_[i] ) meOccupancy_[i]->Reset();
     if ( meOccupancyMem_[i] ) meOccupancyMem_[i]->Reset();
@@ -226,12 +233,15 @@ void EEOccupancyTask::reset(void) {
   if ( meEEPedestalDigiOccupancy_[0] ) meEEPedestalDigiOccupancy_[0]->Reset();
   if ( meEEPedestalDigiOccupancy_[1] ) meEEPedestalDigiOccupancy_[1]->Reset();
 
+
 }
 
 void EEOccupancyTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEOccupancyTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -447,12 +457,17 @@ void EEOccupancyTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEOccupancyTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EEOccupancyTask");
     if(subfolder_.size())
@@ -566,6 +581,7 @@ void EEOccupancyTask::cleanup(void){
 
   }
 
+
   init_ = false;
 
 }
@@ -574,12 +590,30 @@ void EEOccupancyTask::endJob(void) {
 
   edm::LogInfo("EEOccupancyTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EEOccupancyTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("geometryEE", sizeof(geometryEE));
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+  memoryReport_.add("digiScanner_ (shared)", &digiScanner_, 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EEOccupancyTask", "EEOccupancyTask", when);
+
+}
+
 void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
@@ -588,30 +622,19 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
-
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
+    dccHeaders_.update(e, dcchs);
 
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
+    for ( int ism = 1; ism <= 18; ism++ ) {
 
-      int runtype = dcchItr->getRunType();
+      unsigned int classes = dccHeaders_.classes(ism);
 
-      if ( runtype == EcalDCCHeaderBlock::COSMIC ||
-           runtype == EcalDCCHeaderBlock::MTCC ||
-           runtype == EcalDCCHeaderBlock::COSMICS_GLOBAL ||
-           runtype == EcalDCCHeaderBlock::PHYSICS_GLOBAL ||
-           runtype == EcalDCCHeaderBlock::COSMICS_LOCAL ||
-           runtype == EcalDCCHeaderBlock::PHYSICS_LOCAL ) runType[ism-1] = physics;
-      if ( runtype == EcalDCCHeaderBlock::TESTPULSE_MGPA ||
-           runtype == EcalDCCHeaderBlock::TESTPULSE_GAP ) runType[ism-1] = testpulse;
-      if ( runtype == EcalDCCHeaderBlock::LASER_STD ||
-           runtype == EcalDCCHeaderBlock::LASER_GAP ) runType[ism-1] = laser;
-      if ( runtype == EcalDCCHeaderBlock::LED_STD ||
-           runtype == EcalDCCHeaderBlock::LED_GAP ) runType[ism-1] = led;
-      if ( runtype == EcalDCCHeaderBlock::PEDESTAL_STD ||
-           runtype == EcalDCCHeaderBlock::PEDESTAL_GAP ) runType[ism-1] = pedestal;
+      if ( classes & EEDccHeaderSummary::Physics ) runType[ism-1] = physics;
+      if ( classes & EEDccHeaderSummary::TestPulse ) runType[ism-1] = testpulse;
+      if ( classes & EEDccHeaderSummary::Laser ) runType[ism-1] = laser;
+      if ( classes & EEDccHeaderSummary::Led ) runType[ism-1] = led;
+      if ( classes & EEDccHeaderSummary::Pedestal ) runType[ism-1] = pedestal;
 
     }
 
@@ -621,22 +644,28 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EEDigiCollection> digis;
 
-  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, digis->size());
 
     int need = digis->size();
     LogDebug("EEOccupancyTask") << "event " << ievt_ << " digi collection size " << need;
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    digiScanner_.update(e, c, digis, dcchs.isValid() ? &dccHeaders_ : 0);
 
-      EEDetId id = digiItr->id();
+    const std::vector<EEDigiScanner::Frame>& frames = digiScanner_.frames();
 
-      int ix = id.ix();
-      int iy = id.iy();
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-      int hi = id.hashedIndex();
+      const EEDigiScanner::Frame& f = frames[n];
+
+      int ix = f.ix;
+      int iy = f.iy;
+
+      int hi = f.hi;
 
       if ( geometryEE[hi][0] == 0 ) {
-        const GlobalPoint& pos = pGeometry_->getGeometry(id)->getPosition();
+        const GlobalPoint& pos = pGeometry_->getGeometry(EEDetId::unhashIndex(hi))->getPosition();
         geometryEE[hi][0] = pos.eta();
         geometryEE[hi][1] = pos.phi();
       }
@@ -644,7 +673,7 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
       float eta = geometryEE[hi][0];
       float phi = geometryEE[hi][1];
 
-      int ism = Numbers::iSM( id );
+      int ism = f.ism;
 
       if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
 
@@ -652,15 +681,15 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
       float xiy = iy - 0.5;
 
       if ( xix <= 0. || xix >= 100. || xiy <= 0. || xiy >= 100. ) {
-        edm::LogWarning("EEOccupancyTask") << " det id = " << id;
+        edm::LogWarning("EEOccupancyTask") << " det id = " << EEDetId::unhashIndex(hi);
         edm::LogWarning("EEOccupancyTask") << " sm, ix, iw " << ism << " " << ix << " " << iy;
         edm::LogWarning("EEOccupancyTask") << " xix, xiy " << xix << " " << xiy;
       }
 
       if ( meOccupancy_[ism-1] ) meOccupancy_[ism-1]->Fill( xix, xiy );
 
-      int eex = id.ix();
-      int eey = id.iy();
+      int eex = f.ix;
+      int eey = f.iy;
 
       float xeex = eex - 0.5;
       float xeey = eey - 0.5;
@@ -729,7 +758,7 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalPnDiodeDigiCollection> PNs;
 
-  if ( e.getByLabel(EcalPnDiodeDigiCollection_, PNs) ) {
+  if ( instrumentation_.getByLabel(e, EcalPnDiodeDigiCollection_, PNs) ) {
 
     // filling mem occupancy only for the 5 channels belonging
     // to a fully reconstructed PN's
@@ -765,7 +794,9 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRecHitCollection> rechits;
 
-  if ( e.getByLabel(EcalRecHitCollection_, rechits) ) {
+  if ( instrumentation_.getByLabel(e, EcalRecHitCollection_, rechits) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::RecHits, rechits->size());
 
     int nebrh = rechits->size();
     LogDebug("EEOccupancyTask") << "event " << ievt_ << " rec hits collection size " << nebrh;
@@ -846,7 +877,7 @@ void EEOccupancyTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalTrigPrimDigiCollection> trigPrimDigis;
 
-  if ( e.getByLabel(EcalTrigPrimDigiCollection_, trigPrimDigis) ) {
+  if ( instrumentation_.getByLabel(e, EcalTrigPrimDigiCollection_, trigPrimDigis) ) {
 
     int nebtpg = trigPrimDigis->size();
     LogDebug("EEOccupancyTask") << "event " << ievt_ << " trigger primitives digis collection size " << nebtpg;
@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
@@ -25,7 +26,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalOnlineTask.h"
 
-EEPedestalOnlineTask::EEPedestalOnlineTask(const edm::ParameterSet& ps){
+EEPedestalOnlineTask::EEPedestalOnlineTask(const edm::ParameterSet& ps) : digiView_(EEDigiView::shared()) {
 
   init_ = false;
 
@@ -39,6 +40,12 @@ EEPedestalOnlineTask::EEPedestalOnlineTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
+  updateEvents_ = ps.getUntrackedParameter<int>("updateEvents", 100);
+
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
 
   for (int i = 0; i < 18; i++) {
@@ -72,6 +79,8 @@ void EEPedestalOnlineTask::beginRun(const edm::Run& r, const edm::EventSetup& c)
 
 void EEPedestalOnlineTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
+  if ( init_ ) this->updateMaps();
+
 }
 
 void
@@ -81,10 +90,16 @@ EEPedestalOnlineTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::Event
 	cleanup();
 	setup();
   }
+  else if ( init_ ) this->updateMaps();
+  instrumentation_.endLumi();
 }
 
 void EEPedestalOnlineTask::reset(void) {
 
+  instrumentation_.reset();
+
+  stats_.reset();
+
   for (int i = 0; i < 18; i++) {
     if ( mePedMapG12_[i] ) mePedMapG12_[i]->Reset();
   }
@@ -95,6 +110,10 @@ void EEPedestalOnlineTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEPedestalOnlineTask");
+
+  stats_.reset();
+
   std::string name;
   std::string dir;
 
@@ -117,12 +136,17 @@ void EEPedestalOnlineTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEPedestalOnlineTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     std::string dir = prefixME_ + "/EEPedestalOnlineTask";
     if(subfolder_.size())
@@ -146,67 +170,114 @@ void EEPedestalOnlineTask::endJob(void){
 
   edm::LogInfo("EEPedestalOnlineTask") << "analyzed " << ievt_ << " events";
 
+  if ( init_ ) this->updateMaps();
+
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EEPedestalOnlineTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("stats_", &stats_, 1);
+  memoryReport_.add("mask_", EEMemoryReport::bytes(mask_));
+  memoryReport_.add("g12_", EEMemoryReport::bytes(g12_));
+  memoryReport_.add("digiView_ (shared)", &digiView_, 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EEPedestalOnlineTask", "EEPedestalOnlineTask", when);
+
+}
+
+void EEPedestalOnlineTask::updateMaps(void) {
+
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Flush);
+
+  stats_.write(1, mePedMapG12_);
+
+}
+
 void EEPedestalOnlineTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
 
+  // the maps are also written every updateEvents events, not only at the end of the lumi section
+  if ( updateEvents_ > 0 && ievt_ % updateEvents_ == 0 ) this->updateMaps();
+
   edm::Handle<EEDigiCollection> digis;
 
-  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, digis->size());
 
     int need = digis->size();
     LogDebug("EEPedestalOnlineTask") << "event " << ievt_ << " digi collection size " << need;
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    if ( need == 0 ) return;
 
-      EEDetId id = digiItr->id();
+    if ( int(mask_.size()) < need ) {
+      mask_.resize(need);
+      g12_.resize(need);
+    }
 
-      int ix = id.ix();
-      int iy = id.iy();
+    // samples unpacked once per event, sample-major: adc(i)[n] and
+    // gain(i)[n] are the ADC counts and gain id of sample i of frame n
 
-      int ism = Numbers::iSM( id );
+    digiView_.update(e, digis);
 
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
+    int n = digiView_.size();
 
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
+    const int* hashedIndex = digiView_.hashedIndex();
 
-      EEDataFrame dataframe = (*digiItr);
+    // select the frames with the maximum at sample 5: samples 0 to 5 in
+    // gain 12, sample 5 above samples 0 to 4, and not exceeded by the
+    // following samples as long as they stay in gain 12; every pass runs
+    // over all the frames, without branches, so it can be vectorized
 
-      int iMax(-1);
-      int maxADC(0);
-      for(int i(0); i < 10; i++){
-        if(dataframe.sample(i).gainId() != 1) break;
-        int adc(dataframe.sample(i).adc());
-        if(adc > maxADC){
-          maxADC = adc;
-          iMax = i;
-        }
-      }
+    const uint16_t* adc5 = digiView_.adc(5);
 
-      if(iMax != 5) continue;
+    uint8_t* mask = &mask_[0];
+    uint8_t* g12 = &g12_[0];
 
-      for (int i = 0; i < 3; i++) {
+    for ( int k = 0; k < n; k++ ) {
+      mask[k] = ( adc5[k] > 0 );
+      g12[k] = 1;
+    }
 
-        int adc = dataframe.sample(i).adc();
+    for (int i = 0; i < 6; i++) {
+      const uint8_t* gain = digiView_.gain(i);
+      for ( int k = 0; k < n; k++ ) mask[k] &= ( gain[k] == 1 );
+    }
 
-        MonitorElement* mePedMap = 0;
+    for (int i = 0; i < 5; i++) {
+      const uint16_t* adc = digiView_.adc(i);
+      for ( int k = 0; k < n; k++ ) mask[k] &= ( adc[k] < adc5[k] );
+    }
 
-        if ( dataframe.sample(i).gainId() == 1 ) mePedMap = mePedMapG12_[ism-1];
-        if ( dataframe.sample(i).gainId() == 2 ) mePedMap = 0;
-        if ( dataframe.sample(i).gainId() == 3 ) mePedMap = 0;
+    for (int i = 6; i < 10; i++) {
+      const uint16_t* adc = digiView_.adc(i);
+      const uint8_t* gain = digiView_.gain(i);
+      for ( int k = 0; k < n; k++ ) {
+        g12[k] &= ( gain[k] == 1 );
+        mask[k] &= ( ( g12[k] ^ 1 ) | ( adc[k] <= adc5[k] ) );
+      }
+    }
 
-        float xval = float(adc);
+    // samples 0 to 2 of the selected frames are all in gain 12
 
-        if ( mePedMap ) mePedMap->Fill(xix, xiy, xval);
+    for ( int k = 0; k < n; k++ ) {
 
-      }
+      if ( ! mask[k] ) continue;
+
+      stats_.add(hashedIndex[k], 1, digiView_.adc(0) + k, n, 3);
 
     }
 
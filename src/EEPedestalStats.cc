@@ -0,0 +1,221 @@
+/*
+ * \file EEPedestalStats.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "TProfile2D.h"
+
+#include "DQMServices/Core/interface/MonitorElement.h"
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+
+#include "DQM/EcalCommon/interface/Numbers.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalStats.h"
+
+EEPedestalStats::EEPedestalStats(){
+
+  nCry_ = EEDetId::kSizeForDenseIndexing;
+
+  sum_.assign(nGains_ * nCry_, 0);
+  sum2_.assign(nGains_ * nCry_, 0);
+  nent_.assign(nGains_ * nCry_, 0);
+
+}
+
+EEPedestalStats::~EEPedestalStats(){
+
+}
+
+void EEPedestalStats::reset(void) {
+
+  sum_.assign(nGains_ * nCry_, 0);
+  sum2_.assign(nGains_ * nCry_, 0);
+  nent_.assign(nGains_ * nCry_, 0);
+
+}
+
+void EEPedestalStats::add(int hi, const uint16_t* samples, int first, int last) {
+
+  if ( hi < 0 || hi >= nCry_ ) return;
+
+  // the gain selection is done with masks instead of branches; there are
+  // no intrinsics, whether the loop is vectorized is up to the compiler
+  // flags of the release
+
+  int64_t s12 = 0, s06 = 0, s01 = 0;
+  int64_t q12 = 0, q06 = 0, q01 = 0;
+  int64_t n12 = 0, n06 = 0, n01 = 0;
+
+  for ( int i = first; i < last; i++ ) {
+
+    int adc = samples[i] & 0xFFF;
+    int gainId = (samples[i] >> 12) & 0x3;
+    int adc2 = adc * adc;
+
+    int m12 = -(gainId == 1);
+    int m06 = -(gainId == 2);
+    int m01 = -(gainId == 3);
+
+    s12 += adc & m12;
+    s06 += adc & m06;
+    s01 += adc & m01;
+
+    q12 += adc2 & m12;
+    q06 += adc2 & m06;
+    q01 += adc2 & m01;
+
+    n12 += 1 & m12;
+    n06 += 1 & m06;
+    n01 += 1 & m01;
+
+  }
+
+  sum_[0 * nCry_ + hi] += s12;
+  sum_[1 * nCry_ + hi] += s06;
+  sum_[2 * nCry_ + hi] += s01;
+
+  sum2_[0 * nCry_ + hi] += q12;
+  sum2_[1 * nCry_ + hi] += q06;
+  sum2_[2 * nCry_ + hi] += q01;
+
+  nent_[0 * nCry_ + hi] += n12;
+  nent_[1 * nCry_ + hi] += n06;
+  nent_[2 * nCry_ + hi] += n01;
+
+}
+
+void EEPedestalStats::add(int hi, int gainId, const uint16_t* adc, int stride, int n) {
+
+  if ( hi < 0 || hi >= nCry_ ) return;
+  if ( gainId < 1 || gainId > nGains_ ) return;
+
+  int64_t s = 0, q = 0;
+
+  for ( int i = 0; i < n; i++ ) {
+    int64_t a = adc[i * stride];
+    s += a;
+    q += a * a;
+  }
+
+  int k = (gainId-1) * nCry_ + hi;
+
+  sum_[k] += s;
+  sum2_[k] += q;
+  nent_[k] += n;
+
+}
+
+int64_t EEPedestalStats::entries(int hi, int gainId) const {
+
+  if ( hi < 0 || hi >= nCry_ ) return 0;
+  if ( gainId < 1 || gainId > nGains_ ) return 0;
+
+  return nent_[(gainId-1) * nCry_ + hi];
+
+}
+
+void EEPedestalStats::initBins(void) {
+
+  ism_.assign(nCry_, 0);
+  binx_.assign(nCry_, 0);
+  biny_.assign(nCry_, 0);
+
+  for ( int hi = 0; hi < nCry_; hi++ ) {
+
+    EEDetId id = EEDetId::unhashIndex(hi);
+
+    int ix = id.ix();
+    int iy = id.iy();
+
+    int ism = Numbers::iSM( id );
+
+    if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
+
+    ism_[hi] = ism;
+    binx_[hi] = ix - Numbers::ix0EE(ism);
+    biny_[hi] = iy - Numbers::iy0EE(ism);
+
+  }
+
+}
+
+void EEPedestalStats::write(int gainId, MonitorElement* const* me) {
+
+  if ( gainId < 1 || gainId > nGains_ ) return;
+
+  if ( ism_.empty() ) this->initBins();
+
+  // global sums, in the TProfile2D::GetStats order: sumw, sumw2, sumwx,
+  // sumwx2, sumwy, sumwy2, sumwxy, sumwz, sumwz2
+  double stats[18][9];
+  double nentries[18];
+  for ( int i = 0; i < 18; i++ ) {
+    for ( int j = 0; j < 9; j++ ) stats[i][j] = 0.;
+    nentries[i] = 0.;
+  }
+
+  for ( int hi = 0; hi < nCry_; hi++ ) {
+
+    int ism = ism_[hi];
+
+    if ( ism < 1 || ism > 18 ) continue;
+
+    if ( ! me[ism-1] ) continue;
+
+    TProfile2D* h = me[ism-1]->getTProfile2D();
+
+    if ( ! h ) continue;
+
+    int k = (gainId-1) * nCry_ + hi;
+
+    int bin = h->GetBin(binx_[hi], biny_[hi]);
+
+    double n = double(nent_[k]);
+
+    // a profile keeps sum(w*z) as bin content, sum(w) as bin entries,
+    // sum(w*z*z) in Sumw2 and sum(w*w) in BinSumw2; all weights are 1
+    h->SetBinEntries(bin, n);
+    h->SetBinContent(bin, double(sum_[k]));
+    if ( h->GetSumw2()->fN ) h->GetSumw2()->fArray[bin] = double(sum2_[k]);
+    if ( h->GetBinSumw2()->fN ) h->GetBinSumw2()->fArray[bin] = n;
+
+    if ( nent_[k] == 0 ) continue;
+
+    double x = h->GetXaxis()->GetBinCenter(binx_[hi]);
+    double y = h->GetYaxis()->GetBinCenter(biny_[hi]);
+
+    double* s = stats[ism-1];
+
+    s[0] += n;
+    s[1] += n;
+    s[2] += n * x;
+    s[3] += n * x * x;
+    s[4] += n * y;
+    s[5] += n * y * y;
+    s[6] += n * x * y;
+    s[7] += double(sum_[k]);
+    s[8] += double(sum2_[k]);
+
+    nentries[ism-1] += n;
+
+  }
+
+  for ( int i = 0; i < 18; i++ ) {
+    if ( ! me[i] || ! me[i]->getTProfile2D() ) continue;
+    me[i]->getTProfile2D()->PutStats(stats[i]);
+    me[i]->getTProfile2D()->SetEntries(nentries[i]);
+  }
+
+}
+
+size_t EEPedestalStats::bytes(void) const {
+
+  return sizeof(*this) +
+    ( sum_.capacity() + sum2_.capacity() + nent_.capacity() ) * sizeof(int64_t) +
+    ( ism_.capacity() + binx_.capacity() + biny_.capacity() ) * sizeof(int);
+
+}
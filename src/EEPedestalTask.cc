@@ -28,9 +28,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalTask.h"
 
-// #define COMMON_NOISE_ANALYSIS
-
-EEPedestalTask::EEPedestalTask(const edm::ParameterSet& ps){
+EEPedestalTask::EEPedestalTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()), digiScanner_(EEDigiScanner::shared()) {
 
   init_ = false;
 
@@ -42,6 +40,14 @@ EEPedestalTask::EEPedestalTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
+  enableCommonNoise_ = ps.getUntrackedParameter<bool>("enableCommonNoise", false);
+
+  updateEvents_ = ps.getUntrackedParameter<int>("updateEvents", 100);
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
   EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
@@ -58,14 +64,12 @@ EEPedestalTask::EEPedestalTask(const edm::ParameterSet& ps){
     mePedMapG01_[i] = 0;
     mePedMapG06_[i] = 0;
     mePedMapG12_[i] = 0;
-#ifdef COMMON_NOISE_ANALYSIS
     mePed3SumMapG01_[i] = 0;
     mePed3SumMapG06_[i] = 0;
     mePed3SumMapG12_[i] = 0;
     mePed5SumMapG01_[i] = 0;
     mePed5SumMapG06_[i] = 0;
     mePed5SumMapG12_[i] = 0;
-#endif
     mePnPedMapG01_[i] = 0;
     mePnPedMapG16_[i] = 0;
   }
@@ -97,6 +101,8 @@ void EEPedestalTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
 void EEPedestalTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
+  if ( init_ ) this->updateMaps();
+
 }
 
 void
@@ -106,10 +112,16 @@ EEPedestalTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup
 	cleanup();
 	setup();
   }
+  else if ( init_ ) this->updateMaps();
+  instrumentation_.endLumi();
 }
 
 void EEPedestalTask::reset(void) {
 
+  instrumentation_.reset();
+
+  stats_.reset();
+
   for (int i = 0; i < 18; i++) {
     if (find(MGPAGains_.begin(), MGPAGains_.end(), 1) != MGPAGains_.end() ) {
       if ( mePedMapG01_[i] ) mePedMapG01_[i]->Reset();
@@ -120,14 +132,12 @@ void EEPedestalTask::reset(void) {
     if (find(MGPAGains_.begin(), MGPAGains_.end(), 12) != MGPAGains_.end() ) {
       if ( mePedMapG12_[i] ) mePedMapG12_[i]->Reset();
     }
-#ifdef COMMON_NOISE_ANALYSIS
     if ( mePed3SumMapG01_[i] ) mePed3SumMapG01_[i]->Reset();
     if ( mePed3SumMapG06_[i] ) mePed3SumMapG06_[i]->Reset();
     if ( mePed3SumMapG12_[i] ) mePed3SumMapG12_[i]->Reset();
     if ( mePed5SumMapG01_[i] ) mePed5SumMapG01_[i]->Reset();
     if ( mePed5SumMapG06_[i] ) mePed5SumMapG06_[i]->Reset();
     if ( mePed5SumMapG12_[i] ) mePed5SumMapG12_[i]->Reset();
-#endif
     if (find(MGPAGainsPN_.begin(), MGPAGainsPN_.end(), 1) != MGPAGainsPN_.end() ) {
       if ( mePnPedMapG01_[i] ) mePnPedMapG01_[i]->Reset();
     }
@@ -142,6 +152,27 @@ void EEPedestalTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEPedestalTask");
+
+  stats_.reset();
+
+  if ( enableCommonNoise_ ) {
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      for ( int ix = 1; ix <= 50; ix++ ) {
+        for ( int iy = 1; iy <= 50; iy++ ) {
+
+          int jx = ix + Numbers::ix0EE(ism);
+          int jy = iy + Numbers::iy0EE(ism);
+
+          if ( ism >= 1 && ism <= 9 ) jx = 101 - jx;
+
+          validMap_[ism-1][ix-1][iy-1] = Numbers::validEE(ism, jx, jy);
+
+        }
+      }
+    }
+  }
+
   std::string name;
   std::stringstream GainN, GN;
 
@@ -164,21 +195,21 @@ void EEPedestalTask::setup(void){
         mePedMapG01_[i]->setAxisTitle("iy", 2);
         dqmStore_->tag(mePedMapG01_[i], i+1);
 
-#ifdef COMMON_NOISE_ANALYSIS
-	name = "EEPT pedestal 3sum " + Numbers::sEE(i+1) + " " + GN.str();
-        mePed3SumMapG01_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
-        mePed3SumMapG01_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) mePed3SumMapG01_[i]->setAxisTitle("101-ix", 1);
-        mePed3SumMapG01_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(mePed3SumMapG01_[i], i+1);
-
-	name = "EEPT pedestal 5sum " + Numbers::sEE(i+1) + " " + GN.str();
-        mePed5SumMapG01_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
-        mePed5SumMapG01_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) mePed5SumMapG01_[i]->setAxisTitle("101-ix", 1);
-        mePed5SumMapG01_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(mePed5SumMapG01_[i], i+1);
-#endif
+        if ( enableCommonNoise_ ) {
+          name = "EEPT pedestal 3sum " + Numbers::sEE(i+1) + " " + GN.str();
+          mePed3SumMapG01_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
+          mePed3SumMapG01_[i]->setAxisTitle("ix", 1);
+          if ( i+1 >= 1 && i+1 <= 9 ) mePed3SumMapG01_[i]->setAxisTitle("101-ix", 1);
+          mePed3SumMapG01_[i]->setAxisTitle("iy", 2);
+          dqmStore_->tag(mePed3SumMapG01_[i], i+1);
+
+          name = "EEPT pedestal 5sum " + Numbers::sEE(i+1) + " " + GN.str();
+          mePed5SumMapG01_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
+          mePed5SumMapG01_[i]->setAxisTitle("ix", 1);
+          if ( i+1 >= 1 && i+1 <= 9 ) mePed5SumMapG01_[i]->setAxisTitle("101-ix", 1);
+          mePed5SumMapG01_[i]->setAxisTitle("iy", 2);
+          dqmStore_->tag(mePed5SumMapG01_[i], i+1);
+        }
       }
 
     }
@@ -199,21 +230,21 @@ void EEPedestalTask::setup(void){
         mePedMapG06_[i]->setAxisTitle("iy", 2);
         dqmStore_->tag(mePedMapG06_[i], i+1);
 
-#ifdef COMMON_NOISE_ANALYSIS
-	name = "EEPT pedestal 3sum " + Numbers::sEE(i+1) + " " + GN.str();
-        mePed3SumMapG06_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
-        mePed3SumMapG06_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) mePed3SumMapG06_[i]->setAxisTitle("101-ix", 1);
-        mePed3SumMapG06_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(mePed3SumMapG06_[i], i+1);
-
-	name = "EEPT pedestal 5sum " + Numbers::sEE(i+1) + " " + GN.str();
-        mePed5SumMapG06_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
-        mePed5SumMapG06_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) mePed5SumMapG06_[i]->setAxisTitle("101-ix", 1);
-        mePed5SumMapG06_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(mePed5SumMapG06_[i], i+1);
-#endif
+        if ( enableCommonNoise_ ) {
+          name = "EEPT pedestal 3sum " + Numbers::sEE(i+1) + " " + GN.str();
+          mePed3SumMapG06_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
+          mePed3SumMapG06_[i]->setAxisTitle("ix", 1);
+          if ( i+1 >= 1 && i+1 <= 9 ) mePed3SumMapG06_[i]->setAxisTitle("101-ix", 1);
+          mePed3SumMapG06_[i]->setAxisTitle("iy", 2);
+          dqmStore_->tag(mePed3SumMapG06_[i], i+1);
+
+          name = "EEPT pedestal 5sum " + Numbers::sEE(i+1) + " " + GN.str();
+          mePed5SumMapG06_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
+          mePed5SumMapG06_[i]->setAxisTitle("ix", 1);
+          if ( i+1 >= 1 && i+1 <= 9 ) mePed5SumMapG06_[i]->setAxisTitle("101-ix", 1);
+          mePed5SumMapG06_[i]->setAxisTitle("iy", 2);
+          dqmStore_->tag(mePed5SumMapG06_[i], i+1);
+        }
       }
 
     }
@@ -234,21 +265,21 @@ void EEPedestalTask::setup(void){
         mePedMapG12_[i]->setAxisTitle("iy", 2);
         dqmStore_->tag(mePedMapG12_[i], i+1);
 
-#ifdef COMMON_NOISE_ANALYSIS
-	name = "EEPT pedestal 3sum " + Numbers::sEE(i+1) + " " + GN.str();
-        mePed3SumMapG12_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
-        mePed3SumMapG12_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) mePed3SumMapG12_[i]->setAxisTitle("101-ix", 1);
-        mePed3SumMapG12_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(mePed3SumMapG12_[i], i+1);
-
-	name = "EEPT pedestal 5sum " + Numbers::sEE(i+1) + " " + GN.str();
-        mePed5SumMapG12_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
-        mePed5SumMapG12_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) mePed5SumMapG12_[i]->setAxisTitle("101-ix", 1);
-        mePed5SumMapG12_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(mePed5SumMapG12_[i], i+1);
-#endif
+        if ( enableCommonNoise_ ) {
+          name = "EEPT pedestal 3sum " + Numbers::sEE(i+1) + " " + GN.str();
+          mePed3SumMapG12_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
+          mePed3SumMapG12_[i]->setAxisTitle("ix", 1);
+          if ( i+1 >= 1 && i+1 <= 9 ) mePed3SumMapG12_[i]->setAxisTitle("101-ix", 1);
+          mePed3SumMapG12_[i]->setAxisTitle("iy", 2);
+          dqmStore_->tag(mePed3SumMapG12_[i], i+1);
+
+          name = "EEPT pedestal 5sum " + Numbers::sEE(i+1) + " " + GN.str();
+          mePed5SumMapG12_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096., "s");
+          mePed5SumMapG12_[i]->setAxisTitle("ix", 1);
+          if ( i+1 >= 1 && i+1 <= 9 ) mePed5SumMapG12_[i]->setAxisTitle("101-ix", 1);
+          mePed5SumMapG12_[i]->setAxisTitle("iy", 2);
+          dqmStore_->tag(mePed5SumMapG12_[i], i+1);
+        }
       }
 
     }
@@ -293,12 +324,17 @@ void EEPedestalTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEPedestalTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EEPedestalTask");
 
@@ -308,12 +344,10 @@ void EEPedestalTask::cleanup(void){
       for ( int i = 0; i < 18; i++ ) {
         if ( mePedMapG01_[i] ) dqmStore_->removeElement( mePedMapG01_[i]->getName() );
         mePedMapG01_[i] = 0;
-#ifdef COMMON_NOISE_ANALYSIS
         if ( mePed3SumMapG01_[i] ) dqmStore_->removeElement( mePed3SumMapG01_[i]->getName() );
         mePed3SumMapG01_[i] = 0;
         if ( mePed5SumMapG01_[i] ) dqmStore_->removeElement( mePed5SumMapG01_[i]->getName() );
         mePed5SumMapG01_[i] = 0;
-#endif
       }
 
     }
@@ -324,12 +358,10 @@ void EEPedestalTask::cleanup(void){
       for ( int i = 0; i < 18; i++ ) {
         if ( mePedMapG06_[i] ) dqmStore_->removeElement( mePedMapG06_[i]->getName() );
         mePedMapG06_[i] = 0;
-#ifdef COMMON_NOISE_ANALYSIS
         if ( mePed3SumMapG06_[i] ) dqmStore_->removeElement( mePed3SumMapG06_[i]->getName() );
         mePed3SumMapG06_[i] = 0;
         if ( mePed5SumMapG06_[i] ) dqmStore_->removeElement( mePed5SumMapG06_[i]->getName() );
         mePed5SumMapG06_[i] = 0;
-#endif
       }
 
     }
@@ -340,12 +372,10 @@ void EEPedestalTask::cleanup(void){
       for ( int i = 0; i < 18; i++ ) {
         if ( mePedMapG12_[i] ) dqmStore_->removeElement( mePedMapG12_[i]->getName() );
         mePedMapG12_[i] = 0;
-#ifdef COMMON_NOISE_ANALYSIS
         if ( mePed3SumMapG12_[i] ) dqmStore_->removeElement( mePed3SumMapG12_[i]->getName() );
         mePed3SumMapG12_[i] = 0;
         if ( mePed5SumMapG12_[i] ) dqmStore_->removeElement( mePed5SumMapG12_[i]->getName() );
         mePed5SumMapG12_[i] = 0;
-#endif
       }
 
     }
@@ -382,33 +412,50 @@ void EEPedestalTask::endJob(void){
 
   edm::LogInfo("EEPedestalTask") << "analyzed " << ievt_ << " events";
 
+  if ( init_ ) this->updateMaps();
+
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EEPedestalTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("validMap_", sizeof(validMap_));
+  memoryReport_.add("stats_", &stats_, 1);
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+  memoryReport_.add("digiScanner_ (shared)", &digiScanner_, 1);
+  memoryReport_.add("digiScanner_.view() (shared)", &digiScanner_.view(), 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EEPedestalTask", "EEPedestalTask", when);
+
+}
+
 void EEPedestalTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   bool enable = false;
   int runType[18];
   for (int i=0; i<18; i++) runType[i] = -1;
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
-
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
-
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-      runType[ism-1] = dcchItr->getRunType();
-
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::PEDESTAL_STD ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PEDESTAL_GAP ) enable = true;
+    dccHeaders_.update(e, dcchs);
 
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      runType[ism-1] = dccHeaders_.runType(ism);
     }
 
+    if ( dccHeaders_.classes() & EEDccHeaderSummary::Pedestal ) enable = true;
+
   } else {
 
     edm::LogWarning("EEPedestalTask") << EcalRawDataCollection_ << " not available";
@@ -421,149 +468,87 @@ void EEPedestalTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   ievt_++;
 
+  // the maps are also written every updateEvents events, not only at the end of the lumi section
+  if ( updateEvents_ > 0 && ievt_ % updateEvents_ == 0 ) this->updateMaps();
+
   edm::Handle<EEDigiCollection> digis;
 
-  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, digis->size());
 
     int need = digis->size();
     LogDebug("EEPedestalTask") << "event " << ievt_ << " digi collection size " << need;
 
-    float xmap01[18][50][50];
-    float xmap06[18][50][50];
-    float xmap12[18][50][50];
-
-    for ( int ism = 1; ism <= 18; ism++ ) {
-      for ( int ix = 1; ix <= 50; ix++ ) {
-        for ( int iy = 1; iy <= 50; iy++ ) {
-
-          xmap01[ism-1][ix-1][iy-1] = 0.;
-          xmap06[ism-1][ix-1][iy-1] = 0.;
-          xmap12[ism-1][ix-1][iy-1] = 0.;
-
-        }
-      }
+    if ( enableCommonNoise_ ) {
+      for ( int ism = 1; ism <= 18; ism++ ) xmapUsed_[ism-1] = false;
     }
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
-
-      EEDetId id = digiItr->id();
-
-      int ix = id.ix();
-      int iy = id.iy();
-
-      int ism = Numbers::iSM( id );
-
-      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
-
-      float xix = ix - 0.5;
-      float xiy = iy - 0.5;
-
-      if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::PEDESTAL_STD ||
-               runType[ism-1] == EcalDCCHeaderBlock::PEDESTAL_GAP ) ) continue;
-
-      EEDataFrame dataframe = (*digiItr);
+    digiScanner_.update(e, c, digis, dcchs.isValid() ? &dccHeaders_ : 0);
 
-      for (int i = 0; i < 10; i++) {
+    const std::vector<EEDigiScanner::Frame>& frames = digiScanner_.frames();
 
-        int adc = dataframe.sample(i).adc();
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-        MonitorElement* mePedMap = 0;
+      const EEDigiScanner::Frame& f = frames[n];
 
-        if ( dataframe.sample(i).gainId() == 1 ) mePedMap = mePedMapG12_[ism-1];
-        if ( dataframe.sample(i).gainId() == 2 ) mePedMap = mePedMapG06_[ism-1];
-        if ( dataframe.sample(i).gainId() == 3 ) mePedMap = mePedMapG01_[ism-1];
-
-        float xval = float(adc);
+      if ( ! ( f.runType == EcalDCCHeaderBlock::PEDESTAL_STD ||
+               f.runType == EcalDCCHeaderBlock::PEDESTAL_GAP ) ) continue;
 
-        if ( mePedMap ) mePedMap->Fill(xix, xiy, xval);
+      int ism = f.ism;
 
-        if ( dataframe.sample(i).gainId() == 1 ) xmap12[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)] = xmap12[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)] + xval;
-        if ( dataframe.sample(i).gainId() == 2 ) xmap06[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)] = xmap06[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)] + xval;
-        if ( dataframe.sample(i).gainId() == 3 ) xmap01[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)] = xmap01[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)] + xval;
+      int ix = f.ix;
+      int iy = f.iy;
 
-      }
-
-      xmap12[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)]=xmap12[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)]/10.;
-      xmap06[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)]=xmap06[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)]/10.;
-      xmap01[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)]=xmap01[ism-1][ix-1-Numbers::ix0EE(ism)][iy-1-Numbers::iy0EE(ism)]/10.;
-
-    }
-
-    // to be re-done using the 3x3 & 5x5 Selectors (if faster)
-
-#ifdef COMMON_NOISE_ANALYSIS
-    for ( int ism = 1; ism <= 18; ism++ ) {
-      for ( int ix = 1; ix <= 50; ix++ ) {
-        for ( int iy = 1; iy <= 50; iy++ ) {
+      if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
 
-          int xix = ix + Numbers::ix0EE(ism);
-          int xiy = iy + Numbers::iy0EE(ism);
+      EEDataFrame dataframe = (*digis)[f.index];
 
-          if ( ism >= 1 && ism <= 9 ) xix = 101 - xix;
+      stats_.add(f.hi, dataframe.frame().begin(), 0, 10);
 
-          if ( ! Numbers::validEE(ism, xix, xiy) ) continue;
+      if ( enableCommonNoise_ ) {
 
-          float xix = ix - 0.5;
-          float xiy = iy - 0.5;
+        float xval01 = 0.;
+        float xval06 = 0.;
+        float xval12 = 0.;
 
-          float x3val01;
-          float x3val06;
-          float x3val12;
+        for (int i = 0; i < 10; i++) {
 
-          if ( ix >= 2 && ix <= 49 && iy >= 2 && iy <= 49 ) {
+          float xval = float(dataframe.sample(i).adc());
 
-            x3val01 = 0.;
-            x3val06 = 0.;
-            x3val12 = 0.;
-            for ( int i = -1; i <= +1; i++ ) {
-              for ( int j = -1; j <= +1; j++ ) {
+          if ( dataframe.sample(i).gainId() == 1 ) xval12 = xval12 + xval;
+          if ( dataframe.sample(i).gainId() == 2 ) xval06 = xval06 + xval;
+          if ( dataframe.sample(i).gainId() == 3 ) xval01 = xval01 + xval;
 
-                x3val01 = x3val01 + xmap01[ism-1][ix-1+i][iy-1+j];
-                x3val06 = x3val06 + xmap06[ism-1][ix-1+i][iy-1+j];
-                x3val12 = x3val12 + xmap12[ism-1][ix-1+i][iy-1+j];
+        }
 
-              }
+        if ( ! xmapUsed_[ism-1] ) {
+          for ( int jx = 0; jx < 50; jx++ ) {
+            for ( int jy = 0; jy < 50; jy++ ) {
+              xmap01_[ism-1][jx][jy] = 0.;
+              xmap06_[ism-1][jx][jy] = 0.;
+              xmap12_[ism-1][jx][jy] = 0.;
             }
-            x3val01 = x3val01 / 9.;
-            x3val06 = x3val06 / 9.;
-            x3val12 = x3val12 / 9.;
-            if ( mePed3SumMapG01_[ism-1] && x3val01 != 0. ) mePed3SumMapG01_[ism-1]->Fill(xix+Numbers::ix0EE(ism), xiy+Numbers::iy0EE(ism), x3val01);
-            if ( mePed3SumMapG06_[ism-1] && x3val06 != 0. ) mePed3SumMapG06_[ism-1]->Fill(xix+Numbers::ix0EE(ism), xiy+Numbers::iy0EE(ism), x3val06);
-            if ( mePed3SumMapG12_[ism-1] && x3val12 != 0. ) mePed3SumMapG12_[ism-1]->Fill(xix+Numbers::ix0EE(ism), xiy+Numbers::iy0EE(ism), x3val12);
-
           }
+          xmapUsed_[ism-1] = true;
+        }
 
-          float x5val01;
-          float x5val06;
-          float x5val12;
-
-          if ( ix >= 3 && ix <= 48 && iy >= 3 && iy <= 48 ) {
-
-            x5val01 = 0.;
-            x5val06 = 0.;
-            x5val12 = 0.;
-            for ( int i = -2; i <= +2; i++ ) {
-              for ( int j = -2; j <= +2; j++ ) {
+        int jx = ix-1-Numbers::ix0EE(ism);
+        int jy = iy-1-Numbers::iy0EE(ism);
 
-                x5val01 = x5val01 + xmap01[ism-1][ix-1+i][iy-1+j];
-                x5val06 = x5val06 + xmap06[ism-1][ix-1+i][iy-1+j];
-                x5val12 = x5val12 + xmap12[ism-1][ix-1+i][iy-1+j];
+        xmap01_[ism-1][jx][jy] = xval01/10.;
+        xmap06_[ism-1][jx][jy] = xval06/10.;
+        xmap12_[ism-1][jx][jy] = xval12/10.;
 
-              }
-            }
-            x5val01 = x5val01 / 25.;
-            x5val06 = x5val06 / 25.;
-            x5val12 = x5val12 / 25.;
-            if ( mePed5SumMapG01_[ism-1] && x5val01 != 0. ) mePed5SumMapG01_[ism-1]->Fill(xix+Numbers::ix0EE(ism), xiy+Numbers::iy0EE(ism), x5val01);
-            if ( mePed5SumMapG06_[ism-1] && x5val06 != 0. ) mePed5SumMapG06_[ism-1]->Fill(xix+Numbers::ix0EE(ism), xiy+Numbers::iy0EE(ism), x5val06);
-            if ( mePed5SumMapG12_[ism-1] && x5val12 != 0. ) mePed5SumMapG12_[ism-1]->Fill(xix+Numbers::ix0EE(ism), xiy+Numbers::iy0EE(ism), x5val12);
+      }
 
-          }
+    }
 
-        }
+    if ( enableCommonNoise_ ) {
+      for ( int ism = 1; ism <= 18; ism++ ) {
+        if ( xmapUsed_[ism-1] ) this->commonNoise(ism);
       }
     }
-#endif
 
   } else {
 
@@ -573,7 +558,7 @@ void EEPedestalTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalPnDiodeDigiCollection> pns;
 
-  if ( e.getByLabel(EcalPnDiodeDigiCollection_, pns) ) {
+  if ( instrumentation_.getByLabel(e, EcalPnDiodeDigiCollection_, pns) ) {
 
     int nep = pns->size();
     LogDebug("EEPedestalTask") << "event " << ievt_ << " pns collection size " << nep;
@@ -614,3 +599,81 @@ void EEPedestalTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
 }
 
+void EEPedestalTask::updateMaps(void) {
+
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Flush);
+
+  stats_.write(3, mePedMapG01_);
+  stats_.write(2, mePedMapG06_);
+  stats_.write(1, mePedMapG12_);
+
+}
+
+void EEPedestalTask::commonNoise(int ism) {
+
+  // summed-area tables: sat[jx][jy] is the sum of the sample averages
+  // of all the crystals with local indices < jx and < jy, so that the
+  // sum over any window is obtained with four lookups
+  double sat01[51][51];
+  double sat06[51][51];
+  double sat12[51][51];
+
+  for ( int jy = 0; jy <= 50; jy++ ) {
+    sat01[0][jy] = 0.;
+    sat06[0][jy] = 0.;
+    sat12[0][jy] = 0.;
+  }
+
+  for ( int jx = 1; jx <= 50; jx++ ) {
+    double row01 = 0.;
+    double row06 = 0.;
+    double row12 = 0.;
+    sat01[jx][0] = 0.;
+    sat06[jx][0] = 0.;
+    sat12[jx][0] = 0.;
+    for ( int jy = 1; jy <= 50; jy++ ) {
+      row01 += xmap01_[ism-1][jx-1][jy-1];
+      row06 += xmap06_[ism-1][jx-1][jy-1];
+      row12 += xmap12_[ism-1][jx-1][jy-1];
+      sat01[jx][jy] = sat01[jx-1][jy] + row01;
+      sat06[jx][jy] = sat06[jx-1][jy] + row06;
+      sat12[jx][jy] = sat12[jx-1][jy] + row12;
+    }
+  }
+
+  for ( int ix = 1; ix <= 50; ix++ ) {
+    for ( int iy = 1; iy <= 50; iy++ ) {
+
+      if ( ! validMap_[ism-1][ix-1][iy-1] ) continue;
+
+      float xix = ix - 0.5 + Numbers::ix0EE(ism);
+      float xiy = iy - 0.5 + Numbers::iy0EE(ism);
+
+      if ( ix >= 2 && ix <= 49 && iy >= 2 && iy <= 49 ) {
+
+        float x3val01 = ( sat01[ix+1][iy+1] - sat01[ix-2][iy+1] - sat01[ix+1][iy-2] + sat01[ix-2][iy-2] ) / 9.;
+        float x3val06 = ( sat06[ix+1][iy+1] - sat06[ix-2][iy+1] - sat06[ix+1][iy-2] + sat06[ix-2][iy-2] ) / 9.;
+        float x3val12 = ( sat12[ix+1][iy+1] - sat12[ix-2][iy+1] - sat12[ix+1][iy-2] + sat12[ix-2][iy-2] ) / 9.;
+
+        if ( mePed3SumMapG01_[ism-1] && x3val01 != 0. ) mePed3SumMapG01_[ism-1]->Fill(xix, xiy, x3val01);
+        if ( mePed3SumMapG06_[ism-1] && x3val06 != 0. ) mePed3SumMapG06_[ism-1]->Fill(xix, xiy, x3val06);
+        if ( mePed3SumMapG12_[ism-1] && x3val12 != 0. ) mePed3SumMapG12_[ism-1]->Fill(xix, xiy, x3val12);
+
+      }
+
+      if ( ix >= 3 && ix <= 48 && iy >= 3 && iy <= 48 ) {
+
+        float x5val01 = ( sat01[ix+2][iy+2] - sat01[ix-3][iy+2] - sat01[ix+2][iy-3] + sat01[ix-3][iy-3] ) / 25.;
+        float x5val06 = ( sat06[ix+2][iy+2] - sat06[ix-3][iy+2] - sat06[ix+2][iy-3] + sat06[ix-3][iy-3] ) / 25.;
+        float x5val12 = ( sat12[ix+2][iy+2] - sat12[ix-3][iy+2] - sat12[ix+2][iy-3] + sat12[ix-3][iy-3] ) / 25.;
+
+        if ( mePed5SumMapG01_[ism-1] && x5val01 != 0. ) mePed5SumMapG01_[ism-1]->Fill(xix, xiy, x5val01);
+        if ( mePed5SumMapG06_[ism-1] && x5val06 != 0. ) mePed5SumMapG06_[ism-1]->Fill(xix, xiy, x5val06);
+        if ( mePed5SumMapG12_[ism-1] && x5val12 != 0. ) mePed5SumMapG12_[ism-1]->Fill(xix, xiy, x5val12);
+
+      }
+
+    }
+  }
+
+}
@@ -30,7 +30,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EERawDataTask.h"
 
-EERawDataTask::EERawDataTask(const edm::ParameterSet& ps) {
+EERawDataTask::EERawDataTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()) {
 
   init_ = false;
 
@@ -44,6 +44,10 @@ EERawDataTask::EERawDataTask(const edm::ParameterSet& ps) {
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   FEDRawDataCollection_ = ps.getParameter<edm::InputTag>("FEDRawDataCollection");
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
 
@@ -115,13 +119,17 @@ void EERawDataTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
   if ( meEESynchronizationErrorsTrend_ ){
     meEESynchronizationErrorsTrend_->getTH1()->GetXaxis()->SetLimits(0., 50.);
   }
+
 }
 
 void EERawDataTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
+
 }
 
 void EERawDataTask::reset(void) {
 
+  instrumentation_.reset();
+
   if ( meEEEventTypePreCalibrationBX_ ) meEEEventTypePreCalibrationBX_->Reset();
   if ( meEEEventTypeCalibrationBX_ ) meEEEventTypeCalibrationBX_->Reset();
   if ( meEEEventTypePostCalibrationBX_ ) meEEEventTypePostCalibrationBX_->Reset();
@@ -140,12 +148,15 @@ void EERawDataTask::reset(void) {
   if ( meEEBunchCrossingSRPErrors_ ) meEEBunchCrossingSRPErrors_->Reset();
   if ( meEESynchronizationErrorsByLumi_ ) meEESynchronizationErrorsByLumi_->Reset();
   if ( meEESynchronizationErrorsTrend_ ) meEESynchronizationErrorsTrend_->Reset();
+
 }
 
 void EERawDataTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EERawDataTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -325,12 +336,17 @@ void EERawDataTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EERawDataTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EERawDataTask");
     if(subfolder_.size())
@@ -400,7 +416,9 @@ void EERawDataTask::endLuminosityBlock(const edm::LuminosityBlock& , const  edm:
 	cleanup();
 	setup();
   }
-  
+
+  instrumentation_.endLumi();
+
   MonitorElement* me(meEESynchronizationErrorsTrend_);
   if(!me) return;
   if(ls_ >= 50){
@@ -415,12 +433,28 @@ void EERawDataTask::endJob(void) {
 
   edm::LogInfo("EERawDataTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EERawDataTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+
+  memoryReport_.report(dqmStore_, prefixME_, "EERawDataTask", "EERawDataTask", when);
+
+}
+
 void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
@@ -443,7 +477,13 @@ void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   int ECALDCC_BunchCrossing_MostFreqId = -1;
   int ECALDCC_TriggerType_MostFreqId = -1;
 
-  if ( e.getByLabel(FEDRawDataCollection_, allFedRawData) ) {
+  edm::Handle<EcalRawDataCollection> dcchs;
+
+  bool dcchsFound = instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs);
+
+  if ( dcchsFound ) dccHeaders_.update(e, dcchs);
+
+  if ( instrumentation_.getByLabel(e, FEDRawDataCollection_, allFedRawData) ) {
 
     // GT FED data
     const FEDRawData& gtFedData = allFedRawData->FEDData(812);
@@ -478,9 +518,7 @@ void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
       int ECALDCC_BunchCrossing_MostFreqCounts = 0;
       int ECALDCC_TriggerType_MostFreqCounts = 0;
 
-      edm::Handle<EcalRawDataCollection> dcchs;
-
-      if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
+      if ( dcchsFound ) {
 
         for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
 
@@ -556,23 +594,22 @@ void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
     edm::LogWarning("EERawDataTask") << FEDRawDataCollection_ << " not available";
   }
 
-  edm::Handle<EcalRawDataCollection> dcchs;
+  if ( dcchsFound ) {
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
+    for ( int ism = 1; ism <= 18; ism++ ) {
 
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+      const EcalDCCHeaderBlock* dcch = dccHeaders_.header(ism);
 
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
+      if ( ! dcch ) continue;
 
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
       float xism = ism+0.5;
 
-      int ECALDCC_runNumber     = dcchItr->getRunNumber();
+      int ECALDCC_runNumber     = dcch->getRunNumber();
 
-      int ECALDCC_L1A           = dcchItr->getLV1();
-      int ECALDCC_OrbitNumber   = dcchItr->getOrbit();
-      int ECALDCC_BunchCrossing = dcchItr->getBX();
-      int ECALDCC_TriggerType   = dcchItr->getBasicTriggerType();
+      int ECALDCC_L1A           = dccHeaders_.l1a(ism);
+      int ECALDCC_OrbitNumber   = dcch->getOrbit();
+      int ECALDCC_BunchCrossing = dccHeaders_.bx(ism);
+      int ECALDCC_TriggerType   = dcch->getBasicTriggerType();
 
       if ( evt_runNumber != ECALDCC_runNumber ) meEERunNumberErrors_->Fill( xism );
 
@@ -605,10 +642,10 @@ void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
       }
 
       // DCC vs. FE,TCC, SRP syncronization
-      const std::vector<short> feBxs = dcchItr->getFEBxs();
-      const std::vector<short> tccBx = dcchItr->getTCCBx();
-      const short srpBx = dcchItr->getSRPBx();
-      const std::vector<short> status = dcchItr->getFEStatus();
+      const std::vector<short> feBxs = dcch->getFEBxs();
+      const std::vector<short> tccBx = dcch->getTCCBx();
+      const short srpBx = dcch->getSRPBx();
+      const std::vector<short> status = dcch->getFEStatus();
 
       std::vector<int> BxSynchStatus;
       BxSynchStatus.reserve((int)feBxs.size());
@@ -632,9 +669,9 @@ void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
       if(srpBx != ECALDCC_BunchCrossing && srpBx != -1 && ECALDCC_BunchCrossing != -1) meEEBunchCrossingSRPErrors_->Fill( xism );
 
-      const std::vector<short> feLv1 = dcchItr->getFELv1();
-      const std::vector<short> tccLv1 = dcchItr->getTCCLv1();
-      const short srpLv1 = dcchItr->getSRPLv1();
+      const std::vector<short> feLv1 = dcch->getFELv1();
+      const std::vector<short> tccLv1 = dcch->getTCCLv1();
+      const short srpLv1 = dcch->getSRPLv1();
 
       // Lv1 in TCC,SRP,FE are limited to 12 bits(LSB), while in the DCC Lv1 has 24 bits
       int ECALDCC_L1A_12bit = ECALDCC_L1A & 0xfff;
@@ -673,7 +710,7 @@ void EERawDataTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
       }
 
-      float evtType = dcchItr->getRunType();
+      float evtType = dccHeaders_.runType(ism);
 
       if ( evtType < 0 || evtType > 22 ) evtType = -1;
 
@@ -0,0 +1,181 @@
+/*
+ * \file EEReadoutCensus.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalDetId/interface/EcalElectronicsId.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+#include "Geometry/EcalMapping/interface/EcalMappingRcd.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEReadoutCensus.h"
+
+EEReadoutCensus::EEReadoutCensus() {
+
+  init_ = false;
+
+  cacheId_ = 0;
+
+}
+
+EEReadoutCensus::~EEReadoutCensus() {
+
+}
+
+EEReadoutCensus& EEReadoutCensus::shared(void) {
+
+  static EEReadoutCensus census;
+
+  return census;
+
+}
+
+bool EEReadoutCensus::initTables(const edm::EventSetup& c) {
+
+  unsigned long long cacheId = c.get< EcalMappingRcd >().cacheIdentifier();
+
+  if ( init_ && cacheId == cacheId_ ) return true;
+
+  edm::ESHandle< EcalElectronicsMapping > handle;
+  c.get< EcalMappingRcd >().get(handle);
+  if ( ! handle.isValid() ) return false;
+  const EcalElectronicsMapping* map = handle.product();
+  if ( ! map ) return false;
+
+  iTT_.assign(EEDetId::kSizeForDenseIndexing, -1);
+  iRU_.assign(EEDetId::kSizeForDenseIndexing, -1);
+  iDCC_.assign(EEDetId::kSizeForDenseIndexing, -1);
+
+  for ( int hi = 0; hi < EEDetId::kSizeForDenseIndexing; hi++ ) {
+
+    EEDetId id = EEDetId::unhashIndex(hi);
+
+    EcalElectronicsId eid = map->getElectronicsId(id);
+    EcalTriggerElectronicsId tid = map->getTriggerElectronicsId(id);
+
+    int itcc = tid.tccId();
+    int itt = tid.ttId();
+    int idcc = eid.dccId();
+    int isc = eid.towerId();
+
+    if ( itcc >= 1 && itcc <= nTCC_ && itt >= 1 && itt <= nTT_ ) iTT_[hi] = (itcc-1) * nTT_ + (itt-1);
+    if ( idcc >= 1 && idcc <= nDCC_ && isc >= 1 && isc <= nRU_ ) iRU_[hi] = (idcc-1) * nRU_ + (isc-1);
+    if ( idcc >= 1 && idcc <= nDCC_ ) iDCC_[hi] = idcc-1;
+
+  }
+
+  for ( int i = 0; i < nTCC_ * nTT_; i++ ) nCryTT_[i] = 0;
+  for ( int i = 0; i < nDCC_ * nRU_; i++ ) nCryRU_[i] = 0;
+  for ( int i = 0; i < nDCC_; i++ ) nCryDCC_[i] = 0;
+
+  usedTT_.clear();
+  usedRU_.clear();
+  usedDCC_.clear();
+
+  usedTT_.reserve(nTCC_ * nTT_);
+  usedRU_.reserve(nDCC_ * nRU_);
+  usedDCC_.reserve(nDCC_);
+
+  // count again with the new tables
+  eventId_ = edm::EventID();
+  productId_ = edm::ProductID();
+
+  cacheId_ = cacheId;
+  init_ = true;
+
+  return true;
+
+}
+
+void EEReadoutCensus::update(const edm::Event& e, const edm::EventSetup& c, const edm::Handle<EEDigiCollection>& digis) {
+
+  if ( ! this->begin(e, c, digis) ) return;
+
+  for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+
+    EEDetId id = digiItr->id();
+
+    this->add(id.hashedIndex());
+
+  }
+
+}
+
+bool EEReadoutCensus::begin(const edm::Event& e, const edm::EventSetup& c, const edm::Handle<EEDigiCollection>& digis) {
+
+  if ( ! initTables(c) ) return false;
+
+  if ( e.id() == eventId_ && digis.id() == productId_ ) return false;
+
+  eventId_ = e.id();
+  productId_ = digis.id();
+
+  // only the counters used by the previous event have to be cleared
+
+  for ( unsigned int i = 0; i < usedTT_.size(); i++ ) nCryTT_[usedTT_[i]] = 0;
+  for ( unsigned int i = 0; i < usedRU_.size(); i++ ) nCryRU_[usedRU_[i]] = 0;
+  for ( unsigned int i = 0; i < usedDCC_.size(); i++ ) nCryDCC_[usedDCC_[i]] = 0;
+
+  usedTT_.clear();
+  usedRU_.clear();
+  usedDCC_.clear();
+
+  return true;
+
+}
+
+void EEReadoutCensus::add(const int hi) {
+
+  if ( hi < 0 || hi >= int(iTT_.size()) ) return;
+
+  int k = iTT_[hi];
+  if ( k >= 0 && nCryTT_[k]++ == 0 ) usedTT_.push_back(k);
+
+  k = iRU_[hi];
+  if ( k >= 0 && nCryRU_[k]++ == 0 ) usedRU_.push_back(k);
+
+  k = iDCC_[hi];
+  if ( k >= 0 && nCryDCC_[k]++ == 0 ) usedDCC_.push_back(k);
+
+}
+
+int EEReadoutCensus::nCryTT(const int itcc, const int itt) const {
+
+  if ( ! init_ ) return 0;
+  if ( itcc < 1 || itcc > nTCC_ || itt < 1 || itt > nTT_ ) return 0;
+
+  return nCryTT_[(itcc-1) * nTT_ + (itt-1)];
+
+}
+
+int EEReadoutCensus::nCryRU(const int idcc, const int isc) const {
+
+  if ( ! init_ ) return 0;
+  if ( idcc < 1 || idcc > nDCC_ || isc < 1 || isc > nRU_ ) return 0;
+
+  return nCryRU_[(idcc-1) * nRU_ + (isc-1)];
+
+}
+
+int EEReadoutCensus::nCryDCC(const int idcc) const {
+
+  if ( ! init_ ) return 0;
+  if ( idcc < 1 || idcc > nDCC_ ) return 0;
+
+  return nCryDCC_[idcc-1];
+
+}
+
+size_t EEReadoutCensus::bytes(void) const {
+
+  return sizeof(*this) +
+    ( iTT_.capacity() + iRU_.capacity() + iDCC_.capacity() ) * sizeof(int) +
+    ( usedTT_.capacity() + usedRU_.capacity() + usedDCC_.capacity() ) * sizeof(int);
+
+}
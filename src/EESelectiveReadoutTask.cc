@@ -41,7 +41,7 @@
 #include "CondFormats/DataRecord/interface/EcalSRSettingsRcd.h"
 
 
-EESelectiveReadoutTask::EESelectiveReadoutTask(const edm::ParameterSet& ps){
+EESelectiveReadoutTask::EESelectiveReadoutTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()), readoutCensus_(EEReadoutCensus::shared()) {
 
   init_ = false;
 
@@ -53,6 +53,10 @@ EESelectiveReadoutTask::EESelectiveReadoutTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   // parameters...
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
   EEUnsuppressedDigiCollection_ = ps.getParameter<edm::InputTag>("EEUsuppressedDigiCollection");
@@ -176,10 +180,13 @@ EESelectiveReadoutTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::Eve
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EESelectiveReadoutTask::reset(void) {
 
+  instrumentation_.reset();
+
   if ( EETowerSize_[0] ) EETowerSize_[0]->Reset();
   if ( EETowerSize_[1] ) EETowerSize_[1]->Reset();
 
@@ -247,6 +254,8 @@ void EESelectiveReadoutTask::setup(void) {
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EESelectiveReadoutTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -456,12 +465,17 @@ void EESelectiveReadoutTask::setup(void) {
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EESelectiveReadoutTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EESelectiveReadoutTask");
 
@@ -589,18 +603,48 @@ void EESelectiveReadoutTask::endJob(void){
 
   edm::LogInfo("EESelectiveReadoutTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EESelectiveReadoutTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("nCrySC", sizeof(nCrySC));
+  memoryReport_.add("nEvtFullReadout", sizeof(nEvtFullReadout));
+  memoryReport_.add("nEvtRUForced", sizeof(nEvtRUForced));
+  memoryReport_.add("nEvtZSReadout", sizeof(nEvtZSReadout));
+  memoryReport_.add("nEvtCompleteReadoutIfZS", sizeof(nEvtCompleteReadoutIfZS));
+  memoryReport_.add("nEvtDroppedReadoutIfFR", sizeof(nEvtDroppedReadoutIfFR));
+  memoryReport_.add("nEvtAnyReadout", sizeof(nEvtAnyReadout));
+  memoryReport_.add("nEvtHighInterest", sizeof(nEvtHighInterest));
+  memoryReport_.add("nEvtMediumInterest", sizeof(nEvtMediumInterest));
+  memoryReport_.add("nEvtLowInterest", sizeof(nEvtLowInterest));
+  memoryReport_.add("nEvtAnyInterest", sizeof(nEvtAnyInterest));
+  memoryReport_.add("eeRuActive_", sizeof(eeRuActive_));
+  memoryReport_.add("firWeights_", EEMemoryReport::bytes(firWeights_));
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+  memoryReport_.add("readoutCensus_ (shared)", &readoutCensus_, 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EESelectiveReadoutTask", "EESelectiveReadoutTask", when);
+
+}
+
 void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
 
   edm::Handle<FEDRawDataCollection> raw;
-  if ( e.getByLabel(FEDRawDataCollection_, raw) ) {
+  if ( instrumentation_.getByLabel(e, FEDRawDataCollection_, raw) ) {
 
     int EEFirstFED[2];
     EEFirstFED[0] = 601; // EE-
@@ -630,8 +674,11 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
   nFRO[0] = nFRO[1] = 0;
   nCompleteZS[0] = nCompleteZS[1] = 0;
   nDroppedFRO[0] = nDroppedFRO[1] = 0;
+  // number of crystals read out per tower and per RU, see EEReadoutCensus
+  bool readoutCensus = false;
+
   edm::Handle<EESrFlagCollection> eeSrFlags;
-  if ( e.getByLabel(EESRFlagCollection_,eeSrFlags) ) {
+  if ( instrumentation_.getByLabel(e, EESRFlagCollection_,eeSrFlags) ) {
 
     // Data Volume
     double aLowInterest[2];
@@ -646,10 +693,17 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
     aAnyInterest[1]=0;
 
     edm::Handle<EEDigiCollection> eeDigis;
-    if ( e.getByLabel(EEDigiCollection_ , eeDigis) ) {
+    if ( instrumentation_.getByLabel(e, EEDigiCollection_ , eeDigis) ) {
+
+      EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, eeDigis->size());
 
       anaDigiInit();
 
+      // counted in the loop below, unless another task already did
+      bool count = readoutCensus_.begin(e, c, eeDigis);
+
+      readoutCensus = true;
+
       // channel status
       edm::ESHandle<EcalChannelStatus> pChannelStatus;
       c.get<EcalChannelStatusRcd>().get(pChannelStatus);
@@ -666,6 +720,7 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
           statusCode = ch_code.getStatusCode();
         }
         anaDigi(eedf, *eeSrFlags, statusCode);
+        if ( count ) readoutCensus_.add(id.hashedIndex());
       }
 
       //low interest channels:
@@ -709,16 +764,13 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
       edm::LogWarning("EESelectiveReadoutTask") << EEDigiCollection_ << " not available";
     }
 
-    // initialize dcchs_ to mask disabled towers
-    std::map< int, std::vector<short> > towersStatus;
+    // front-end status of the DCCs, to mask disabled towers
+    bool towersStatus = false;
     edm::Handle<EcalRawDataCollection> dcchs;
 
-    if( e.getByLabel(FEDRawDataCollection_, dcchs) ) {
-      for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
-        if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
-        int ism = Numbers::iSM( *dcchItr, EcalEndcap );
-        towersStatus.insert(std::make_pair(ism, dcchItr->getFEStatus()));
-      }
+    if( instrumentation_.getByLabel(e, FEDRawDataCollection_, dcchs) ) {
+      dccHeaders_.update(e, dcchs);
+      towersStatus = true;
     }
 
     for ( EESrFlagCollection::const_iterator it = eeSrFlags->begin(); it != eeSrFlags->end(); ++it ) {
@@ -744,12 +796,14 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
       int flag = it->value() & ~EcalSrFlag::SRF_FORCED_MASK;
 
       int status=0;
-      if( towersStatus[ism].size() > 0 ) status = (towersStatus[ism])[isc - 1];
+      if( towersStatus && dccHeaders_.feStatus(ism).size() > 0 ) status = dccHeaders_.feStatus(ism)[isc - 1];
+
+      int nPerRu = readoutCensus ? readoutCensus_.nCryRU(iDcc, isc) : 0;
 
       if(flag == EcalSrFlag::SRF_FULL) {
         nEvtFullReadout[ix-1][iy-1][iz]++;
         nFRO[iz]++;
-        if(nPerRu_[iDcc-1][isc - 1] == 0) {
+        if(nPerRu == 0) {
           if(status != 1) nEvtDroppedReadoutIfFR[ix-1][iy-1][iz]++;
           nDroppedFRO[iz]++;
         }
@@ -761,7 +815,7 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
 
       if(flag == EcalSrFlag::SRF_ZS1 || flag == EcalSrFlag::SRF_ZS2) {
         nEvtZSReadout[ix-1][iy-1][iz]++;
-        if(nPerRu_[iDcc-1][isc - 1] == getCrystalCount(iDcc,isc)) {
+        if(nPerRu == getCrystalCount(iDcc,isc)) {
           if(status != 1) nEvtCompleteReadoutIfZS[ix-1][iy-1][iz]++;
           nCompleteZS[iz]++;
         }
@@ -870,7 +924,7 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
   }
 
   edm::Handle<EcalTrigPrimDigiCollection> TPCollection;
-  if ( e.getByLabel(EcalTrigPrimDigiCollection_, TPCollection) ) {
+  if ( instrumentation_.getByLabel(e, EcalTrigPrimDigiCollection_, TPCollection) ) {
 
     // Trigger Primitives
     EcalTrigPrimDigiCollection::const_iterator TPdigi;
@@ -896,6 +950,8 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
         int itcc = Numbers::iTCC( ism, EcalEndcap, ix, iy );
         int itt = Numbers::iTT( ism, EcalEndcap, ix, iy );
 
+        int nCryTT = readoutCensus ? readoutCensus_.nCryTT(itcc, itt) : 0;
+
         if ( ismt >= 1 && ismt <= 9 ) ix = 101 - ix;
 
         nEvtAnyInterest[ix-1][iy-1][iz]++;
@@ -911,7 +967,7 @@ void EESelectiveReadoutTask::analyze(const edm::Event& e, const edm::EventSetup&
         float xiy = iy-0.5;
 
         if ( ((TPdigi->ttFlag() & 0x3) == 1 || (TPdigi->ttFlag() & 0x3) == 3)
-             && nCryTT[itcc-1][itt-1] != (int)crystals->size() ) EETTFMismatch_[iz]->Fill(xix, xiy);
+             && nCryTT != (int)crystals->size() ) EETTFMismatch_[iz]->Fill(xix, xiy);
 
       }
 
@@ -1024,10 +1080,6 @@ void EESelectiveReadoutTask::anaDigi(const EEDataFrame& frame, const EESrFlagCol
 
     nCrySC[ttix-1][ttiy-1][ttiz]++;
 
-    int itcc = Numbers::iTCC( ism, EcalEndcap, ix, iy );
-    int itt = Numbers::iTT( ism, EcalEndcap, ix, iy );
-    nCryTT[itcc-1][itt-1]++;
-
     bool highInterest = ((srf->value() & ~EcalSrFlag::SRF_FORCED_MASK)
                          == EcalSrFlag::SRF_FULL);
 
@@ -1052,9 +1104,7 @@ void EESelectiveReadoutTask::anaDigi(const EEDataFrame& frame, const EESrFlagCol
         EELowInterestZsFIR_[1]->Fill( dccZsFIRval );
       }
     }
-    int isc = Numbers::iSC( ism, EcalEndcap, ix, iy );
     ++nPerDcc_[dccNum(id)-1];
-    ++nPerRu_[dccNum(id)-1][isc - 1];
   }
   
 }
@@ -1070,12 +1120,6 @@ void EESelectiveReadoutTask::anaDigiInit(){
   bzero(nRuPerDcc_, sizeof(nRuPerDcc_));
   bzero(eeRuActive_, sizeof(eeRuActive_));
 
-  for(int idcc=0; idcc<nECALDcc; idcc++) {
-    for(int isc=0; isc<nDccChs; isc++) {
-      nPerRu_[idcc][isc] = 0;
-    }
-  }
-
   for(int iz = 0; iz<2; iz++) {
     for(int ix = 0; ix < 20; ix++ ) {
       for(int iy = 0; iy < 20; iy++ ) {
@@ -1084,10 +1128,6 @@ void EESelectiveReadoutTask::anaDigiInit(){
     }
   }
 
-  for (int itcc = 0; itcc < 108; itcc++) {
-    for (int itt = 0; itt < 41; itt++) nCryTT[itcc][itt] = 0;
-  }
-
 }
 
 const EcalScDetId
@@ -22,11 +22,14 @@
 #include "DataFormats/EcalDetId/interface/EcalDetIdCollections.h"
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
 
+#include "TH1F.h"
+#include "TH2F.h"
+
 #include "DQM/EcalCommon/interface/Numbers.h"
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EEStatusFlagsTask.h"
 
-EEStatusFlagsTask::EEStatusFlagsTask(const edm::ParameterSet& ps){
+EEStatusFlagsTask::EEStatusFlagsTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()) {
 
   init_ = false;
 
@@ -40,6 +43,12 @@ EEStatusFlagsTask::EEStatusFlagsTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
+  updateEvents_ = ps.getUntrackedParameter<int>("updateEvents", 100);
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
 
   for (int i = 0; i < 18; i++) {
@@ -52,6 +61,13 @@ EEStatusFlagsTask::EEStatusFlagsTask(const edm::ParameterSet& ps){
 
   meFEchErrorsByLumi_ = 0;
 
+  for (int i = 0; i < 18; i++) {
+    for (int j = 0; j < 41; j++) towerBinsInit_[i][j] = false;
+    for (int j = 0; j < 16; j++) nStatus_[i][j] = 0;
+  }
+
+  nFEchErrors_.assign(18 * 50 * 50, 0);
+
 }
 
 EEStatusFlagsTask::~EEStatusFlagsTask(){
@@ -87,6 +103,8 @@ void EEStatusFlagsTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
 void EEStatusFlagsTask::endRun(const edm::Run& r, const edm::EventSetup& c) {
 
+  if ( init_ ) this->updateMaps();
+
 }
 
 void
@@ -96,10 +114,19 @@ EEStatusFlagsTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSet
 	cleanup();
 	setup();
   }
+  else if ( init_ ) this->updateMaps();
+  instrumentation_.endLumi();
 }
 
 void EEStatusFlagsTask::reset(void) {
 
+  instrumentation_.reset();
+
+  nFEchErrors_.assign(18 * 50 * 50, 0);
+  for (int i = 0; i < 18; i++) {
+    for (int j = 0; j < 16; j++) nStatus_[i][j] = 0;
+  }
+
   for (int i = 0; i < 18; i++) {
     if ( meEvtType_[i] ) meEvtType_[i]->Reset();
 
@@ -115,6 +142,8 @@ void EEStatusFlagsTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EEStatusFlagsTask");
+
   std::string name;
   std::string dir;
 
@@ -204,12 +233,17 @@ void EEStatusFlagsTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EEStatusFlagsTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     std::string dir = prefixME_ + "/EEStatusFlagsTask";
     if(subfolder_.size())
@@ -246,33 +280,65 @@ void EEStatusFlagsTask::endJob(void){
 
   edm::LogInfo("EEStatusFlagsTask") << "analyzed " << ievt_ << " events";
 
+  if ( init_ ) this->updateMaps();
+
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EEStatusFlagsTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  size_t towerBins = 0;
+  for ( int i = 0; i < 18; i++ ) {
+    for ( int j = 0; j < 41; j++ ) towerBins += EEMemoryReport::bytes(towerBins_[i][j]);
+  }
+
+  memoryReport_.add("towerBins_", sizeof(towerBins_) + towerBins);
+  memoryReport_.add("nFEchErrors_", EEMemoryReport::bytes(nFEchErrors_));
+  memoryReport_.add("nStatus_", sizeof(nStatus_));
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+
+  memoryReport_.report(dqmStore_, prefixME_, "EEStatusFlagsTask", "EEStatusFlagsTask", when);
+
+}
+
 void EEStatusFlagsTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
 
+  // the maps are also written every updateEvents events, not only at the end of the lumi section
+  if ( updateEvents_ > 0 && ievt_ % updateEvents_ == 0 ) this->updateMaps();
+
   // fill bin 0 with number of events in the lumi
   if ( meFEchErrorsByLumi_ ) meFEchErrorsByLumi_->Fill(0.);
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
+    dccHeaders_.update(e, dcchs);
 
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
+    for ( int ism = 1; ism <= 18; ism++ ) {
+
+      if ( ! dccHeaders_.found(ism) ) continue;
 
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
       float xism = ism + 0.5;
 
-      if ( meEvtType_[ism-1] ) meEvtType_[ism-1]->Fill(dcchItr->getRunType()+0.5);
+      if ( meEvtType_[ism-1] ) meEvtType_[ism-1]->Fill(dccHeaders_.runType(ism)+0.5);
+
+      const std::vector<short>& status = dccHeaders_.feStatus(ism);
 
-      const std::vector<short> status = dcchItr->getFEStatus();
+      int nErrors = 0;
 
       for ( unsigned int itt=1; itt<=status.size(); itt++ ) {
 
@@ -282,41 +348,43 @@ void EEStatusFlagsTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
         if ( ( ism == 8 || ism == 17 ) && ( itt >= 18 && itt <= 24 ) ) continue;
 
-        if ( itt >= 1 && itt <= 41 ) {
+        int s = status[itt-1];
 
-          std::vector<DetId>* crystals = Numbers::crystals( dcchItr->id(), itt );
+        bool acceptable = s >= 0 && s < 16 && ( ( acceptableStatus_ >> s ) & 0x1 );
 
-          for ( unsigned int i=0; i<crystals->size(); i++ ) {
+        if ( itt >= 1 && itt <= 41 ) {
 
-          EEDetId id = (*crystals)[i];
+          if ( ! acceptable ) {
 
-          int ix = id.ix();
-          int iy = id.iy();
+            const std::vector<int>& bins = towerBins(ism, itt);
 
-          if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
+            int* n = &nFEchErrors_[(ism-1) * 2500];
 
-          float xix = ix - 0.5;
-          float xiy = iy - 0.5;
+            for ( unsigned int i=0; i<bins.size(); i++ ) n[bins[i]]++;
 
-          if ( ! ( status[itt-1] == 0 || status[itt-1] == 1 || status[itt-1] == 7 || status[itt-1] == 8 || status[itt-1] == 12 || status[itt-1] == 15 ) ) {
-            if ( meFEchErrors_[ism-1][0] ) meFEchErrors_[ism-1][0]->Fill(xix, xiy);
-            if ( meFEchErrorsByLumi_ ) meFEchErrorsByLumi_->Fill(xism, 1./34./crystals->size());
-          }
+            if ( bins.size() != 0 ) nErrors++;
 
           }
 
         } else if ( itt == 69 || itt == 70 ) {
 
-          if ( ! ( status[itt-1] == 0 || status[itt-1] == 1 || status[itt-1] == 7 || status[itt-1] == 8 || status[itt-1] == 12 || status[itt-1] == 15 ) ) {
+          if ( ! acceptable ) {
             if ( meFEchErrors_[ism-1][1] ) meFEchErrors_[ism-1][1]->Fill(itt-68-0.5, 0);
           }
 
         }
 
-        if ( meFEchErrors_[ism-1][2] ) meFEchErrors_[ism-1][2]->Fill(status[itt-1]+0.5);
+        if ( s >= 0 && s < 16 ) {
+          nStatus_[ism-1][s]++;
+        } else {
+          if ( meFEchErrors_[ism-1][2] ) meFEchErrors_[ism-1][2]->Fill(s+0.5);
+        }
 
       }
 
+      // each tower in error is weighted by 1/34
+      if ( meFEchErrorsByLumi_ && nErrors > 0 ) meFEchErrorsByLumi_->Fill(xism, nErrors/34.);
+
     }
 
   } else {
@@ -327,3 +395,115 @@ void EEStatusFlagsTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
 }
 
+
+const std::vector<int>& EEStatusFlagsTask::towerBins(int ism, int itt) {
+
+  std::vector<int>& bins = towerBins_[ism-1][itt-1];
+
+  if ( towerBinsInit_[ism-1][itt-1] ) return bins;
+
+  int idcc = ( ism <= 9 ) ? ism : ism + 36;
+
+  std::vector<DetId>* crystals = Numbers::crystals( idcc, itt );
+
+  for ( unsigned int i=0; i<crystals->size(); i++ ) {
+
+    EEDetId id = (*crystals)[i];
+
+    int ix = id.ix();
+    int iy = id.iy();
+
+    if ( ism >= 1 && ism <= 9 ) ix = 101 - ix;
+
+    int jx = ix - Numbers::ix0EE(ism) - 1;
+    int jy = iy - Numbers::iy0EE(ism) - 1;
+
+    if ( jx >= 0 && jx < 50 && jy >= 0 && jy < 50 ) bins.push_back(jx + 50 * jy);
+
+  }
+
+  towerBinsInit_[ism-1][itt-1] = true;
+
+  return bins;
+
+}
+
+void EEStatusFlagsTask::updateMaps(void) {
+
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Flush);
+
+  // the counts are added as unit-weight fills: bin contents, Sumw2 if
+  // present, global sums and entries as Fill would leave them; the global
+  // sums are read first, since SetBinContent() clears them
+
+  for (int i = 0; i < 18; i++) {
+
+    int* n = &nFEchErrors_[i * 2500];
+
+    if ( meFEchErrors_[i][0] ) {
+
+      TH2F* h2 = meFEchErrors_[i][0]->getTH2F();
+
+      // in the TH2::GetStats order: sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwxy
+      double stats[7];
+      h2->GetStats(stats);
+
+      double entries = h2->GetEntries();
+
+      for ( int k = 0; k < 2500; k++ ) {
+        if ( n[k] == 0 ) continue;
+        int binx = k % 50 + 1;
+        int biny = k / 50 + 1;
+        int bin = h2->GetBin(binx, biny);
+        h2->SetBinContent(bin, h2->GetBinContent(bin) + n[k]);
+        if ( h2->GetSumw2N() ) h2->GetSumw2()->fArray[bin] += n[k];
+        double x = h2->GetXaxis()->GetBinCenter(binx);
+        double y = h2->GetYaxis()->GetBinCenter(biny);
+        stats[0] += n[k];
+        stats[1] += n[k];
+        stats[2] += n[k] * x;
+        stats[3] += n[k] * x * x;
+        stats[4] += n[k] * y;
+        stats[5] += n[k] * y * y;
+        stats[6] += n[k] * x * y;
+        entries += n[k];
+        n[k] = 0;
+      }
+
+      h2->PutStats(stats);
+      h2->SetEntries(entries);
+
+    }
+
+    if ( meFEchErrors_[i][2] ) {
+
+      TH1F* h1 = meFEchErrors_[i][2]->getTH1F();
+
+      // in the TH1::GetStats order: sumw, sumw2, sumwx, sumwx2
+      double stats[4];
+      h1->GetStats(stats);
+
+      double entries = h1->GetEntries();
+
+      for ( int s = 0; s < 16; s++ ) {
+        if ( nStatus_[i][s] == 0 ) continue;
+        int bin = s + 1;
+        h1->SetBinContent(bin, h1->GetBinContent(bin) + nStatus_[i][s]);
+        if ( h1->GetSumw2N() ) h1->GetSumw2()->fArray[bin] += nStatus_[i][s];
+        double x = h1->GetXaxis()->GetBinCenter(bin);
+        stats[0] += nStatus_[i][s];
+        stats[1] += nStatus_[i][s];
+        stats[2] += nStatus_[i][s] * x;
+        stats[3] += nStatus_[i][s] * x * x;
+        entries += nStatus_[i][s];
+        nStatus_[i][s] = 0;
+      }
+
+      h1->PutStats(stats);
+      h1->SetEntries(entries);
+
+    }
+
+  }
+
+}
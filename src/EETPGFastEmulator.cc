@@ -0,0 +1,426 @@
+/*
+ * \file EETPGFastEmulator.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+*/
+
+#include <map>
+
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalDetId/interface/EcalTrigTowerDetId.h"
+#include "DataFormats/EcalDetId/interface/EcalTriggerElectronicsId.h"
+
+#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+
+#include "CondFormats/EcalObjects/interface/EcalTPGLinearizationConst.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGPedestals.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGSlidingWindow.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGWeightGroup.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGWeightIdMap.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGLutGroup.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGLutIdMap.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGFineGrainStripEE.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGCrystalStatus.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGStripStatus.h"
+#include "CondFormats/EcalObjects/interface/EcalTPGTowerStatus.h"
+#include "CondFormats/DataRecord/interface/EcalTPGLinearizationConstRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGPedestalsRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGSlidingWindowRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGWeightGroupRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGWeightIdMapRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGLutGroupRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGLutIdMapRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGFineGrainStripEERcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGCrystalStatusRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGStripStatusRcd.h"
+#include "CondFormats/DataRecord/interface/EcalTPGTowerStatusRcd.h"
+
+#include "DQM/EcalCommon/interface/Numbers.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EETPGFastEmulator.h"
+
+EETPGFastEmulator::EETPGFastEmulator() {
+
+  init_ = false;
+
+  for ( int i = 0; i < nRecords_; i++ ) cacheId_[i] = 0;
+
+}
+
+EETPGFastEmulator::~EETPGFastEmulator() {
+
+}
+
+void EETPGFastEmulator::setup(const edm::EventSetup& c) {
+
+  unsigned long long cacheId[nRecords_];
+  cacheId[0] = c.get<EcalTPGLinearizationConstRcd>().cacheIdentifier();
+  cacheId[1] = c.get<EcalTPGPedestalsRcd>().cacheIdentifier();
+  cacheId[2] = c.get<EcalTPGSlidingWindowRcd>().cacheIdentifier();
+  cacheId[3] = c.get<EcalTPGWeightGroupRcd>().cacheIdentifier();
+  cacheId[4] = c.get<EcalTPGWeightIdMapRcd>().cacheIdentifier();
+  cacheId[5] = c.get<EcalTPGLutGroupRcd>().cacheIdentifier();
+  cacheId[6] = c.get<EcalTPGLutIdMapRcd>().cacheIdentifier();
+  cacheId[7] = c.get<EcalTPGFineGrainStripEERcd>().cacheIdentifier();
+  cacheId[8] = c.get<EcalTPGCrystalStatusRcd>().cacheIdentifier();
+  cacheId[9] = c.get<EcalTPGStripStatusRcd>().cacheIdentifier();
+  cacheId[10] = c.get<EcalTPGTowerStatusRcd>().cacheIdentifier();
+
+  bool changed = ! init_;
+  for ( int i = 0; i < nRecords_; i++ ) {
+    if ( cacheId[i] != cacheId_[i] ) changed = true;
+    cacheId_[i] = cacheId[i];
+  }
+
+  if ( ! changed ) return;
+
+  edm::ESHandle<EcalTPGLinearizationConst> pLin;
+  c.get<EcalTPGLinearizationConstRcd>().get(pLin);
+  edm::ESHandle<EcalTPGPedestals> pPed;
+  c.get<EcalTPGPedestalsRcd>().get(pPed);
+  edm::ESHandle<EcalTPGSlidingWindow> pSlid;
+  c.get<EcalTPGSlidingWindowRcd>().get(pSlid);
+  edm::ESHandle<EcalTPGWeightGroup> pWeightGroup;
+  c.get<EcalTPGWeightGroupRcd>().get(pWeightGroup);
+  edm::ESHandle<EcalTPGWeightIdMap> pWeightIdMap;
+  c.get<EcalTPGWeightIdMapRcd>().get(pWeightIdMap);
+  edm::ESHandle<EcalTPGLutGroup> pLutGroup;
+  c.get<EcalTPGLutGroupRcd>().get(pLutGroup);
+  edm::ESHandle<EcalTPGLutIdMap> pLutIdMap;
+  c.get<EcalTPGLutIdMapRcd>().get(pLutIdMap);
+  edm::ESHandle<EcalTPGFineGrainStripEE> pFgStrip;
+  c.get<EcalTPGFineGrainStripEERcd>().get(pFgStrip);
+  edm::ESHandle<EcalTPGCrystalStatus> pCryStatus;
+  c.get<EcalTPGCrystalStatusRcd>().get(pCryStatus);
+  edm::ESHandle<EcalTPGStripStatus> pStripStatus;
+  c.get<EcalTPGStripStatusRcd>().get(pStripStatus);
+  edm::ESHandle<EcalTPGTowerStatus> pTowerStatus;
+  c.get<EcalTPGTowerStatusRcd>().get(pTowerStatus);
+
+  const EcalElectronicsMapping* map = Numbers::getElectronicsMapping();
+
+  int nCry = EEDetId::kSizeForDenseIndexing;
+
+  base_.assign(3 * nCry, 0);
+  mult_.assign(3 * nCry, 0);
+  shift_.assign(3 * nCry, 0);
+  strip_.assign(nCry, -1);
+  stripPos_.assign(nCry, 0);
+  crystalMasked_.assign(nCry, false);
+
+  weights_.clear();
+  stripShift_.clear();
+  fgThreshold_.clear();
+  fgLut_.clear();
+  stripMasked_.clear();
+  tower_.clear();
+
+  towerId_.clear();
+  lut_.clear();
+  innerRing_.clear();
+  towerMasked_.clear();
+
+  std::map<uint32_t, int> stripIndex;
+  std::map<uint32_t, int> towerIndex;
+
+  for ( int hi = 0; hi < nCry; hi++ ) {
+
+    EEDetId id = EEDetId::unhashIndex(hi);
+
+    EcalTPGLinearizationConst::const_iterator linItr = pLin->find(id.rawId());
+    if ( linItr != pLin->end() ) {
+      mult_[3*hi+0] = linItr->mult_x12;
+      mult_[3*hi+1] = linItr->mult_x6;
+      mult_[3*hi+2] = linItr->mult_x1;
+      shift_[3*hi+0] = linItr->shift_x12;
+      shift_[3*hi+1] = linItr->shift_x6;
+      shift_[3*hi+2] = linItr->shift_x1;
+    }
+
+    EcalTPGPedestals::const_iterator pedItr = pPed->find(id.rawId());
+    if ( pedItr != pPed->end() ) {
+      base_[3*hi+0] = pedItr->mean_x12;
+      base_[3*hi+1] = pedItr->mean_x6;
+      base_[3*hi+2] = pedItr->mean_x1;
+    }
+
+    EcalTPGCrystalStatus::const_iterator cryItr = pCryStatus->find(id.rawId());
+    if ( cryItr != pCryStatus->end() ) crystalMasked_[hi] = cryItr->getStatusCode() != 0;
+
+    EcalTriggerElectronicsId elId = map->getTriggerElectronicsId(id);
+
+    // the strip conditions are keyed on the electronics id without the channel bits
+    uint32_t stripId = elId.rawId() & 0xfffffff8;
+
+    std::map<uint32_t, int>::const_iterator sItr = stripIndex.find(stripId);
+
+    if ( sItr == stripIndex.end() ) {
+
+      EcalTrigTowerDetId ttId = map->getTrigTowerDetId(elId.tccId(), elId.ttId());
+
+      std::map<uint32_t, int>::const_iterator tItr = towerIndex.find(ttId.rawId());
+
+      int itower = 0;
+
+      if ( tItr == towerIndex.end() ) {
+
+        itower = towerId_.size();
+        towerIndex[ttId.rawId()] = itower;
+
+        const unsigned int* lut = 0;
+
+        std::map<uint32_t, uint32_t>::const_iterator gItr = pLutGroup->getMap().find(ttId.rawId());
+        if ( gItr != pLutGroup->getMap().end() ) {
+          EcalTPGLutIdMap::EcalTPGLutMapItr lItr = pLutIdMap->getMap().find(gItr->second);
+          if ( lItr != pLutIdMap->getMap().end() ) lut = lItr->second.getLut();
+        }
+
+        towerId_.push_back(ttId);
+        lut_.push_back(lut);
+        innerRing_.push_back(ttId.ietaAbs() == 27 || ttId.ietaAbs() == 28);
+
+        EcalTPGTowerStatusMapIterator tsItr = pTowerStatus->getMap().find(ttId.rawId());
+        towerMasked_.push_back( tsItr != pTowerStatus->getMap().end() && tsItr->second != 0 );
+
+      } else {
+
+        itower = tItr->second;
+
+      }
+
+      int istrip = tower_.size();
+      stripIndex[stripId] = istrip;
+
+      uint32_t w[5] = { 0, 0, 0, 0, 0 };
+
+      std::map<uint32_t, uint32_t>::const_iterator gItr = pWeightGroup->getMap().find(stripId);
+      if ( gItr != pWeightGroup->getMap().end() ) {
+        EcalTPGWeightIdMap::EcalTPGWeightMapItr wItr = pWeightIdMap->getMap().find(gItr->second);
+        if ( wItr != pWeightIdMap->getMap().end() ) wItr->second.getValues(w[0], w[1], w[2], w[3], w[4]);
+      }
+
+      // the weights are 7 bit signed integers
+      for ( int i = 0; i < 5; i++ ) weights_.push_back( (w[i] & 0x40) ? int(w[i] | 0xffffffc0) : int(w[i]) );
+
+      std::map<uint32_t, uint32_t>::const_iterator swItr = pSlid->getMap().find(stripId);
+      stripShift_.push_back( swItr != pSlid->getMap().end() ? swItr->second : 0 );
+
+      EcalTPGFineGrainStripEEMapIterator fgItr = pFgStrip->getMap().find(stripId);
+      fgThreshold_.push_back( fgItr != pFgStrip->getMap().end() ? fgItr->second.threshold : 0 );
+      fgLut_.push_back( fgItr != pFgStrip->getMap().end() ? fgItr->second.lut : 0 );
+
+      EcalTPGStripStatusMapIterator ssItr = pStripStatus->getMap().find(stripId);
+      stripMasked_.push_back( ssItr != pStripStatus->getMap().end() && ssItr->second != 0 );
+
+      tower_.push_back(itower);
+
+      sItr = stripIndex.find(stripId);
+
+    }
+
+    strip_[hi] = sItr->second;
+    stripPos_[hi] = elId.channelId() - 1;
+
+  }
+
+  int nStrips = tower_.size();
+  int nTowers = towerId_.size();
+
+  stripSum_.assign(nStrips * nSamples_, 0);
+  stripFgIndex_.assign(nStrips * nSamples_, 0);
+  towerEt_.assign(nTowers * nTPSamples, 0);
+  towerFg_.assign(nTowers * nTPSamples, 0);
+  stripUsed_.assign(nStrips, false);
+  towerUsed_.assign(nTowers, false);
+  usedStrips_.clear();
+  usedTowers_.clear();
+  usedStrips_.reserve(nStrips);
+  usedTowers_.reserve(nTowers);
+
+  init_ = true;
+
+}
+
+void EETPGFastEmulator::process(const EEDigiCollection& digis, EcalTrigPrimDigiCollection& tps) {
+
+  if ( ! init_ ) return;
+
+  for ( unsigned int i = 0; i < usedStrips_.size(); i++ ) {
+    int k = usedStrips_[i];
+    for ( int j = 0; j < nSamples_; j++ ) {
+      stripSum_[k * nSamples_ + j] = 0;
+      stripFgIndex_[k * nSamples_ + j] = 0;
+    }
+    stripUsed_[k] = false;
+  }
+  usedStrips_.clear();
+
+  for ( unsigned int i = 0; i < usedTowers_.size(); i++ ) {
+    int t = usedTowers_[i];
+    for ( int j = 0; j < nTPSamples; j++ ) {
+      towerEt_[t * nTPSamples + j] = 0;
+      towerFg_[t * nTPSamples + j] = 0;
+    }
+    towerUsed_[t] = false;
+  }
+  usedTowers_.clear();
+
+  // linearisation and strip sums
+
+  for ( EEDigiCollection::const_iterator digiItr = digis.begin(); digiItr != digis.end(); ++digiItr ) {
+
+    EEDetId id = digiItr->id();
+
+    int hi = id.hashedIndex();
+
+    int k = strip_[hi];
+
+    if ( k < 0 ) continue;
+
+    if ( ! stripUsed_[k] ) {
+      stripUsed_[k] = true;
+      usedStrips_.push_back(k);
+    }
+
+    // a masked crystal has a null linearised output, hence no fine grain bit
+    if ( crystalMasked_[hi] ) continue;
+
+    EEDataFrame dataframe = (*digiItr);
+
+    const uint16_t* samples = dataframe.frame().begin();
+
+    int n = dataframe.size() < nSamples_ ? dataframe.size() : nSamples_;
+
+    int* sum = &stripSum_[k * nSamples_];
+    int* fgIndex = &stripFgIndex_[k * nSamples_];
+
+    for ( int i = 0; i < n; i++ ) {
+
+      int adc = samples[i] & 0xFFF;
+      int gainId = (samples[i] >> 12) & 0x3;
+
+      int lin = 0;
+
+      if ( gainId == 0 ) {
+        lin = (adc * 0xFF) >> 2;
+      } else {
+        int g = 3 * hi + gainId - 1;
+        lin = ((adc - base_[g]) * mult_[g]) >> (shift_[g] + 2);
+      }
+
+      if ( lin < 0 ) lin = 0;
+      if ( lin > 0x3FFFF ) lin = 0x3FFFF;
+
+      sum[i] += lin;
+
+      // fine grain comparator of the FENIX strip, on the 16 lower bits
+      // with the 2 upper bits as an overflow
+      if ( uint32_t(lin & 0xFFFF) > fgThreshold_[k] || ( lin & 0x30000 ) != 0 ) fgIndex[i] |= 1 << stripPos_[hi];
+
+    }
+
+  }
+
+  // amplitude filter, strip formatting and tower sums; the filter output
+  // for sample i is computed on samples i-3 to i+1
+
+  for ( unsigned int is = 0; is < usedStrips_.size(); is++ ) {
+
+    int k = usedStrips_[is];
+
+    int* sum = &stripSum_[k * nSamples_];
+    int* fgIndex = &stripFgIndex_[k * nSamples_];
+    const int* w = &weights_[5 * k];
+
+    int t = tower_[k];
+
+    if ( ! towerUsed_[t] ) {
+      towerUsed_[t] = true;
+      usedTowers_.push_back(t);
+    }
+
+    // a masked strip contributes neither Et nor fine grain to its tower
+    if ( stripMasked_[k] ) continue;
+
+    for ( int j = 0; j < nTPSamples; j++ ) {
+
+      int i = firstTPSample_ + j;
+
+      int filt = 0;
+
+      for ( int m = 0; m < 5; m++ ) {
+        int isample = i + 1 - 4 + m;
+        int s = 0;
+        if ( isample >= 0 && isample < nSamples_ ) s = sum[isample] > 0x3FFFF ? 0x3FFFF : sum[isample];
+        filt += (w[m] * s) >> 6;
+      }
+
+      if ( filt < 0 ) filt = 0;
+      if ( filt > 0x3FFFF ) filt = 0x3FFFF;
+
+      int et = filt >> stripShift_[k];
+      if ( et > 0xFFF ) et = 0xFFF;
+
+      // the LUT index has the strip identification bit on top of the 5
+      // crystal bits; the LUT word is 32 bit wide, so the index is taken
+      // modulo 32 as the shift of the FENIX emulation does on a 32 bit word
+      int fgLutIndex = fgIndex[i] | ( identif_ << 5 );
+
+      int fg = ( fgLut_[k] >> ( fgLutIndex & 0x1F ) ) & 0x1;
+
+      towerEt_[t * nTPSamples + j] += et;
+      towerFg_[t * nTPSamples + j] |= fg;
+
+    }
+
+  }
+
+  // compression
+
+  for ( unsigned int it = 0; it < usedTowers_.size(); it++ ) {
+
+    int t = usedTowers_[it];
+
+    EcalTriggerPrimitiveDigi tp(towerId_[t]);
+    tp.setSize(nTPSamples);
+
+    for ( int j = 0; j < nTPSamples; j++ ) {
+
+      int et = towerEt_[t * nTPSamples + j] >> 2;
+      if ( et > 0x3FF ) et = 0x3FF;
+      if ( innerRing_[t] ) et = et / 2;
+
+      // a masked tower is compressed as a null Et
+      if ( towerMasked_[t] ) et = 0;
+
+      int lutOut = lut_[t] ? int(lut_[t][et]) : 0;
+
+      tp.setSample(j, EcalTriggerPrimitiveSample(lutOut & 0xff, towerFg_[t * nTPSamples + j] != 0, (lutOut & 0x700) >> 8));
+
+    }
+
+    tps.push_back(tp);
+
+  }
+
+  tps.sort();
+
+}
+
+size_t EETPGFastEmulator::bytes(void) const {
+
+  return sizeof(*this) +
+    ( base_.capacity() + mult_.capacity() + shift_.capacity() + strip_.capacity() + stripPos_.capacity() ) * sizeof(int) +
+    ( weights_.capacity() + stripShift_.capacity() + tower_.capacity() ) * sizeof(int) +
+    ( fgThreshold_.capacity() + fgLut_.capacity() ) * sizeof(uint32_t) +
+    towerId_.capacity() * sizeof(EcalTrigTowerDetId) + lut_.capacity() * sizeof(const unsigned int*) +
+    ( stripSum_.capacity() + stripFgIndex_.capacity() + towerEt_.capacity() + towerFg_.capacity() ) * sizeof(int) +
+    ( usedStrips_.capacity() + usedTowers_.capacity() ) * sizeof(int) +
+    ( innerRing_.capacity() + stripUsed_.capacity() + towerUsed_.capacity() ) / 8 +
+    ( crystalMasked_.capacity() + stripMasked_.capacity() + towerMasked_.capacity() ) / 8;
+
+}
@@ -21,7 +21,6 @@
 
 #include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
-#include "DataFormats/EcalDigi/interface/EEDataFrame.h"
 #include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
 #include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
 #include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
@@ -30,7 +29,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EETestPulseTask.h"
 
-EETestPulseTask::EETestPulseTask(const edm::ParameterSet& ps){
+EETestPulseTask::EETestPulseTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()), digiScanner_(EEDigiScanner::shared()) {
 
   init_ = false;
 
@@ -42,6 +41,10 @@ EETestPulseTask::EETestPulseTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
   EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
   EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
@@ -104,10 +107,13 @@ EETestPulseTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EETestPulseTask::reset(void) {
 
+  instrumentation_.reset();
+
   for (int i = 0; i < 18; i++) {
     if (find(MGPAGains_.begin(), MGPAGains_.end(), 1) != MGPAGains_.end() ) {
       if ( meShapeMapG01_[i] ) meShapeMapG01_[i]->Reset();
@@ -137,146 +143,139 @@ void EETestPulseTask::setup(void){
 
   init_ = true;
 
-  std::string name;
-  std::stringstream GainN, GN;
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EETestPulseTask");
 
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask");
 
-    if (find(MGPAGains_.begin(), MGPAGains_.end(), 1) != MGPAGains_.end() ) {
+    // the maps of each SM are booked on first use, in bookMaps() and bookPnMaps()
 
-      GainN.str("");
-      GainN << "Gain" << std::setw(2) << std::setfill('0') << 1;
-      GN.str("");
-      GN << "G" << std::setw(2) << std::setfill('0') << 1;
+  }
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/" + GainN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EETPT shape " + Numbers::sEE(i+1) + " " + GN.str();
-        meShapeMapG01_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapG01_[i]->setAxisTitle("channel", 1);
-        meShapeMapG01_[i]->setAxisTitle("sample", 2);
-        meShapeMapG01_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapG01_[i], i+1);
-
-	name = "EETPT amplitude " + Numbers::sEE(i+1) + " " + GN.str();
-        meAmplMapG01_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapG01_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapG01_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapG01_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapG01_[i], i+1);
-      }
+  this->reportMemory("setup");
 
-    }
+}
 
-    if (find(MGPAGains_.begin(), MGPAGains_.end(), 6) != MGPAGains_.end() ) {
+void EETestPulseTask::bookMaps(int ism, int mgpaGain){
 
-      GainN.str("");
-      GainN << "Gain" << std::setw(2) << std::setfill('0') << 6;
-      GN.str("");
-      GN << "G" << std::setw(2) << std::setfill('0') << 6;
+  if ( ism < 1 || ism > 18 ) return;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/" + GainN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EETPT shape " + Numbers::sEE(i+1) + " " + GN.str();
-        meShapeMapG06_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapG06_[i]->setAxisTitle("channel", 1);
-        meShapeMapG06_[i]->setAxisTitle("sample", 2);
-        meShapeMapG06_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapG06_[i], i+1);
-
-	name = "EETPT amplitude " + Numbers::sEE(i+1) + " " + GN.str();
-        meAmplMapG06_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapG06_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapG06_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapG06_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapG06_[i], i+1);
-      }
+  int gain = 0;
 
-    }
+  if ( mgpaGain == 3 ) gain = 1;
+  if ( mgpaGain == 2 ) gain = 6;
+  if ( mgpaGain == 1 ) gain = 12;
 
-    if (find(MGPAGains_.begin(), MGPAGains_.end(), 12) != MGPAGains_.end() ) {
+  MonitorElement** meShapeMap = 0;
+  MonitorElement** meAmplMap = 0;
 
-      GainN.str("");
-      GainN << "Gain" << std::setw(2) << std::setfill('0') << 12;
-      GN.str("");
-      GN << "G" << std::setw(2) << std::setfill('0') << 12;
+  if ( gain == 1 ) {
+    meShapeMap = meShapeMapG01_;
+    meAmplMap = meAmplMapG01_;
+  }
+  if ( gain == 6 ) {
+    meShapeMap = meShapeMapG06_;
+    meAmplMap = meAmplMapG06_;
+  }
+  if ( gain == 12 ) {
+    meShapeMap = meShapeMapG12_;
+    meAmplMap = meAmplMapG12_;
+  }
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/" + GainN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EETPT shape " + Numbers::sEE(i+1) + " " + GN.str();
-        meShapeMapG12_[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
-        meShapeMapG12_[i]->setAxisTitle("channel", 1);
-        meShapeMapG12_[i]->setAxisTitle("sample", 2);
-        meShapeMapG12_[i]->setAxisTitle("amplitude", 3);
-        dqmStore_->tag(meShapeMapG12_[i], i+1);
-
-	name = "EETPT amplitude " + Numbers::sEE(i+1) + " " + GN.str();
-        meAmplMapG12_[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
-        meAmplMapG12_[i]->setAxisTitle("ix", 1);
-        if ( i+1 >= 1 && i+1 <= 9 ) meAmplMapG12_[i]->setAxisTitle("101-ix", 1);
-        meAmplMapG12_[i]->setAxisTitle("iy", 2);
-        dqmStore_->tag(meAmplMapG12_[i], i+1);
-      }
+  if ( ! meShapeMap ) return;
 
-    }
+  int i = ism-1;
 
-    dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/PN");
+  if ( meShapeMap[i] ) return;
 
-    if (find(MGPAGainsPN_.begin(), MGPAGainsPN_.end(), 1) != MGPAGainsPN_.end() ) {
+  if ( ! init_ || ! dqmStore_ ) return;
 
-      GainN.str("");
-      GainN << "Gain" << std::setw(2) << std::setfill('0') << 1;
-      GN.str("");
-      GN << "G" << std::setw(2) << std::setfill('0') << 1;
+  if ( find(MGPAGains_.begin(), MGPAGains_.end(), gain) == MGPAGains_.end() ) return;
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/PN/" + GainN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EETPT PNs amplitude " + Numbers::sEE(i+1) + " " + GN.str();
-        mePnAmplMapG01_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG01_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG01_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG01_[i], i+1);
-	name = "EETPT PNs pedestal " + Numbers::sEE(i+1) + " " + GN.str();
-        mePnPedMapG01_[i] =  dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG01_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG01_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG01_[i], i+1);
-      }
+  std::string name;
+  std::stringstream GainN, GN;
 
-    }
+  GainN << "Gain" << std::setw(2) << std::setfill('0') << gain;
+  GN << "G" << std::setw(2) << std::setfill('0') << gain;
 
-    if (find(MGPAGainsPN_.begin(), MGPAGainsPN_.end(), 16) != MGPAGainsPN_.end() ) {
+  dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/" + GainN.str());
 
-      GainN.str("");
-      GainN << "Gain" << std::setw(2) << std::setfill('0') << 16;
-      GN.str("");
-      GN << "G" << std::setw(2) << std::setfill('0') << 16;
+  name = "EETPT shape " + Numbers::sEE(i+1) + " " + GN.str();
+  meShapeMap[i] = dqmStore_->bookProfile2D(name, name, 850, 0., 850., 10, 0., 10., 4096, 0., 4096., "s");
+  meShapeMap[i]->setAxisTitle("channel", 1);
+  meShapeMap[i]->setAxisTitle("sample", 2);
+  meShapeMap[i]->setAxisTitle("amplitude", 3);
+  dqmStore_->tag(meShapeMap[i], i+1);
 
-      dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/PN/" + GainN.str());
-      for (int i = 0; i < 18; i++) {
-	name = "EETPT PNs amplitude " + Numbers::sEE(i+1) + " " + GN.str();
-        mePnAmplMapG16_[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnAmplMapG16_[i]->setAxisTitle("channel", 1);
-        mePnAmplMapG16_[i]->setAxisTitle("amplitude", 2);
-        dqmStore_->tag(mePnAmplMapG16_[i], i+1);
-	name = "EETPT PNs pedestal " + Numbers::sEE(i+1) + " " + GN.str();
-        mePnPedMapG16_[i] =  dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
-        mePnPedMapG16_[i]->setAxisTitle("channel", 1);
-        mePnPedMapG16_[i]->setAxisTitle("pedestal", 2);
-        dqmStore_->tag(mePnPedMapG16_[i], i+1);
-      }
+  name = "EETPT amplitude " + Numbers::sEE(i+1) + " " + GN.str();
+  meAmplMap[i] = dqmStore_->bookProfile2D(name, name, 50, Numbers::ix0EE(i+1)+0., Numbers::ix0EE(i+1)+50., 50, Numbers::iy0EE(i+1)+0., Numbers::iy0EE(i+1)+50., 4096, 0., 4096.*12., "s");
+  meAmplMap[i]->setAxisTitle("ix", 1);
+  if ( i+1 >= 1 && i+1 <= 9 ) meAmplMap[i]->setAxisTitle("101-ix", 1);
+  meAmplMap[i]->setAxisTitle("iy", 2);
+  dqmStore_->tag(meAmplMap[i], i+1);
 
-    }
+}
+
+void EETestPulseTask::bookPnMaps(int ism, int gainId){
 
+  if ( ism < 1 || ism > 18 ) return;
+
+  int gain = 0;
+
+  if ( gainId == 0 ) gain = 1;
+  if ( gainId == 1 ) gain = 16;
+
+  MonitorElement** mePnAmplMap = 0;
+  MonitorElement** mePnPedMap = 0;
+
+  if ( gain == 1 ) {
+    mePnAmplMap = mePnAmplMapG01_;
+    mePnPedMap = mePnPedMapG01_;
+  }
+  if ( gain == 16 ) {
+    mePnAmplMap = mePnAmplMapG16_;
+    mePnPedMap = mePnPedMapG16_;
   }
 
+  if ( ! mePnAmplMap ) return;
+
+  int i = ism-1;
+
+  if ( mePnAmplMap[i] ) return;
+
+  if ( ! init_ || ! dqmStore_ ) return;
+
+  if ( find(MGPAGainsPN_.begin(), MGPAGainsPN_.end(), gain) == MGPAGainsPN_.end() ) return;
+
+  std::string name;
+  std::stringstream GainN, GN;
+
+  GainN << "Gain" << std::setw(2) << std::setfill('0') << gain;
+  GN << "G" << std::setw(2) << std::setfill('0') << gain;
+
+  dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask/PN/" + GainN.str());
+
+  name = "EETPT PNs amplitude " + Numbers::sEE(i+1) + " " + GN.str();
+  mePnAmplMap[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
+  mePnAmplMap[i]->setAxisTitle("channel", 1);
+  mePnAmplMap[i]->setAxisTitle("amplitude", 2);
+  dqmStore_->tag(mePnAmplMap[i], i+1);
+
+  name = "EETPT PNs pedestal " + Numbers::sEE(i+1) + " " + GN.str();
+  mePnPedMap[i] = dqmStore_->bookProfile(name, name, 10, 0., 10., 4096, 0., 4096., "s");
+  mePnPedMap[i]->setAxisTitle("channel", 1);
+  mePnPedMap[i]->setAxisTitle("pedestal", 2);
+  dqmStore_->tag(mePnPedMap[i], i+1);
+
 }
 
 void EETestPulseTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EETestPulseTask");
 
@@ -352,12 +351,30 @@ void EETestPulseTask::endJob(void){
 
   edm::LogInfo("EETestPulseTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EETestPulseTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+  memoryReport_.add("digiScanner_ (shared)", &digiScanner_, 1);
+  memoryReport_.add("digiScanner_.view() (shared)", &digiScanner_.view(), 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EETestPulseTask", "EETestPulseTask", when);
+
+}
+
 void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   bool enable = false;
   int runType[18];
   for (int i=0; i<18; i++) runType[i] = -1;
@@ -366,22 +383,17 @@ void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
-
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
-
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
-
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-      runType[ism-1] = dcchItr->getRunType();
-      mgpaGain[ism-1] = dcchItr->getMgpaGain();
-
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::TESTPULSE_MGPA ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::TESTPULSE_GAP ) enable = true;
+    dccHeaders_.update(e, dcchs);
 
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      runType[ism-1] = dccHeaders_.runType(ism);
+      mgpaGain[ism-1] = dccHeaders_.mgpaGain(ism);
     }
 
+    if ( dccHeaders_.classes() & EEDccHeaderSummary::TestPulse ) enable = true;
+
   } else {
 
     edm::LogWarning("EETestPulseTask") << EcalRawDataCollection_ << " not available";
@@ -394,32 +406,40 @@ void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   ievt_++;
 
+  // book the maps of the SMs in test pulse mode here, once per event, not per frame or hit
+  for ( int ism = 1; ism <= 18; ism++ ) {
+    if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::TESTPULSE_MGPA ||
+             runType[ism-1] == EcalDCCHeaderBlock::TESTPULSE_GAP ) ) continue;
+    this->bookMaps(ism, mgpaGain[ism-1]);
+  }
+
   edm::Handle<EEDigiCollection> digis;
 
-  if ( e.getByLabel(EEDigiCollection_, digis) ) {
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::Digis, digis->size());
 
     int need = digis->size();
     LogDebug("EETestPulseTask") << "event " << ievt_ << " digi collection size " << need;
 
-    for ( EEDigiCollection::const_iterator digiItr = digis->begin(); digiItr != digis->end(); ++digiItr ) {
+    digiScanner_.update(e, c, digis, dcchs.isValid() ? &dccHeaders_ : 0);
 
-      EEDetId id = digiItr->id();
+    const std::vector<EEDigiScanner::Frame>& frames = digiScanner_.frames();
+    const EEDigiView& view = digiScanner_.view();
 
-      int ix = id.ix();
-      int iy = id.iy();
+    for ( unsigned int n = 0; n < frames.size(); n++ ) {
 
-      int ism = Numbers::iSM( id );
+      const EEDigiScanner::Frame& f = frames[n];
 
-      if ( ! ( runType[ism-1] == EcalDCCHeaderBlock::TESTPULSE_MGPA ||
-               runType[ism-1] == EcalDCCHeaderBlock::TESTPULSE_GAP ) ) continue;
+      if ( ! ( f.runType == EcalDCCHeaderBlock::TESTPULSE_MGPA ||
+               f.runType == EcalDCCHeaderBlock::TESTPULSE_GAP ) ) continue;
 
-      int ic = Numbers::icEE(ism, ix, iy);
-
-      EEDataFrame dataframe = (*digiItr);
+      int ism = f.ism;
+      int ic = f.ic;
 
       for (int i = 0; i < 10; i++) {
 
-        int adc = dataframe.sample(i).adc();
+        int adc = view.adc(i)[f.index];
 
         MonitorElement* meShapeMap = 0;
 
@@ -443,7 +463,9 @@ void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalUncalibratedRecHitCollection> hits;
 
-  if ( e.getByLabel(EcalUncalibratedRecHitCollection_, hits) ) {
+  if ( instrumentation_.getByLabel(e, EcalUncalibratedRecHitCollection_, hits) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::RecHits, hits->size());
 
     int neh = hits->size();
     LogDebug("EETestPulseTask") << "event " << ievt_ << " hits collection size " << neh;
@@ -490,7 +512,7 @@ void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalPnDiodeDigiCollection> pns;
 
-  if ( e.getByLabel(EcalPnDiodeDigiCollection_, pns) ) {
+  if ( instrumentation_.getByLabel(e, EcalPnDiodeDigiCollection_, pns) ) {
 
     int nep = pns->size();
     LogDebug("EETestPulseTask") << "event " << ievt_ << " pns collection size " << nep;
@@ -514,6 +536,8 @@ void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
         MonitorElement* mePNPed = 0;
 
+        this->bookPnMaps(ism, pnItr->sample(i).gainId());
+
         if ( pnItr->sample(i).gainId() == 0 ) mePNPed = mePnPedMapG01_[ism-1];
         if ( pnItr->sample(i).gainId() == 1 ) mePNPed = mePnPedMapG16_[ism-1];
 
@@ -543,6 +567,8 @@ void EETestPulseTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
       xvalmax = xvalmax - xvalped;
 
+      this->bookPnMaps(ism, pnItr->sample(0).gainId());
+
       if ( pnItr->sample(0).gainId() == 0 ) mePN = mePnAmplMapG01_[ism-1];
       if ( pnItr->sample(0).gainId() == 1 ) mePN = mePnAmplMapG16_[ism-1];
 
@@ -31,7 +31,7 @@
 
 #include "DQM/EcalEndcapMonitorTasks/interface/EETimingTask.h"
 
-EETimingTask::EETimingTask(const edm::ParameterSet& ps){
+EETimingTask::EETimingTask(const edm::ParameterSet& ps) : dccHeaders_(EEDccHeaderSummary::shared()) {
 
   init_ = false;
 
@@ -45,6 +45,10 @@ EETimingTask::EETimingTask(const edm::ParameterSet& ps){
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   energyThreshold_ = ps.getUntrackedParameter<double>("energyThreshold", 3.);
 
   EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
@@ -114,10 +118,13 @@ EETimingTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup co
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EETimingTask::reset(void) {
 
+  instrumentation_.reset();
+
   for (int i = 0; i < 18; i++) {
     if ( meTime_[i] ) meTime_[i]->Reset();
     if ( meTimeMap_[i] ) meTimeMap_[i]->Reset();
@@ -133,12 +140,15 @@ void EETimingTask::reset(void) {
   if ( meTimeDelta_ ) meTimeDelta_->Reset();
   if ( meTimeDelta2D_ ) meTimeDelta2D_->Reset();
 
+
 }
 
 void EETimingTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EETimingTask");
+
   std::string name;
 
   //for timing vs amplitude plots
@@ -221,12 +231,17 @@ void EETimingTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 void EETimingTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EETimingTask");
 
@@ -261,6 +276,7 @@ void EETimingTask::cleanup(void){
 
   }
 
+
   init_ = false;
 
 }
@@ -269,12 +285,28 @@ void EETimingTask::endJob(void){
 
   edm::LogInfo("EETimingTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EETimingTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("dccHeaders_ (shared)", sizeof(dccHeaders_));
+
+  memoryReport_.report(dqmStore_, prefixME_, "EETimingTask", "EETimingTask", when);
+
+}
+
 void EETimingTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   const unsigned STABLE_BEAMS = 11;
 
   bool isData = true;
@@ -284,25 +316,16 @@ void EETimingTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRawDataCollection> dcchs;
 
-  if ( e.getByLabel(EcalRawDataCollection_, dcchs) ) {
-
-    for ( EcalRawDataCollection::const_iterator dcchItr = dcchs->begin(); dcchItr != dcchs->end(); ++dcchItr ) {
-
-      if ( Numbers::subDet( *dcchItr ) != EcalEndcap ) continue;
+  if ( instrumentation_.getByLabel(e, EcalRawDataCollection_, dcchs) ) {
 
-      int ism = Numbers::iSM( *dcchItr, EcalEndcap );
-
-      runType[ism-1] = dcchItr->getRunType();
-
-      if ( dcchItr->getRunType() == EcalDCCHeaderBlock::COSMIC ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::MTCC ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::COSMICS_GLOBAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PHYSICS_GLOBAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::COSMICS_LOCAL ||
-           dcchItr->getRunType() == EcalDCCHeaderBlock::PHYSICS_LOCAL ) enable = true;
+    dccHeaders_.update(e, dcchs);
 
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      runType[ism-1] = dccHeaders_.runType(ism);
     }
 
+    if ( dccHeaders_.classes() & EEDccHeaderSummary::Physics ) enable = true;
+
   } else {
 
     isData = false; enable = true;
@@ -319,7 +342,7 @@ void EETimingTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   // resetting plots when stable beam is declared
   if( useBeamStatus_ && !stableBeamsDeclared_ ) {
     edm::Handle<L1GlobalTriggerEvmReadoutRecord> gtRecord;
-    if( e.getByLabel(L1GtEvmReadoutRecord_, gtRecord) ) {
+    if( instrumentation_.getByLabel(e, L1GtEvmReadoutRecord_, gtRecord) ) {
 
       unsigned lhcBeamMode = gtRecord->gtfeWord().beamMode();
 
@@ -341,7 +364,9 @@ void EETimingTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
   edm::Handle<EcalRecHitCollection> hits;
 
-  if ( e.getByLabel(EcalRecHitCollection_, hits) ) {
+  if ( instrumentation_.getByLabel(e, EcalRecHitCollection_, hits) ) {
+
+    EEInstrumentation::Timer loopTimer(instrumentation_, EEInstrumentation::RecHits, hits->size());
 
     int neh = hits->size();
     LogDebug("EETimingTask") << "event " << ievt_ << " hits collection size " << neh;
@@ -372,14 +397,6 @@ void EETimingTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
       }
 
-      MonitorElement* meTime = 0;
-      MonitorElement* meTimeMap = 0;
-      MonitorElement* meTimeAmpli = 0;
-
-      meTime = meTime_[ism-1];
-      meTimeMap = meTimeMap_[ism-1];
-      meTimeAmpli = meTimeAmpli_[ism-1];
-
       float xval = hitItr->energy();
       float yval = hitItr->time();
 
@@ -388,11 +405,11 @@ void EETimingTask::analyze(const edm::Event& e, const edm::EventSetup& c){
       uint32_t sev = sevlv->severityLevel(id, *hits );
 
       if ( (flag == EcalRecHit::kGood || flag == EcalRecHit::kOutOfTime) && sev != EcalSeverityLevel::kWeird ) {
-        if ( meTimeAmpli ) meTimeAmpli->Fill(xval, yval);
+        if ( meTimeAmpli_[ism-1] ) meTimeAmpli_[ism-1]->Fill(xval, yval);
         if ( meTimeAmpliSummary_[iz] ) meTimeAmpliSummary_[iz]->Fill(xval, yval);
         if ( hitItr->energy() > energyThreshold_ ) {
-          if ( meTimeMap ) meTimeMap->Fill(xix, xiy, yval+shiftProf2D);
-          if ( meTime ) meTime->Fill(yval);
+          if ( meTimeMap_[ism-1] ) meTimeMap_[ism-1]->Fill(xix, xiy, yval+shiftProf2D);
+          if ( meTime_[ism-1] ) meTime_[ism-1]->Fill(yval);
           if ( meTimeSummary1D_[iz] ) meTimeSummary1D_[iz]->Fill(yval);
 
           if ( meTimeSummaryMap_[iz] ) meTimeSummaryMap_[iz]->Fill(id.ix()-0.5, xiy, yval+shiftProf2D);
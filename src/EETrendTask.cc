@@ -52,6 +52,10 @@ EETrendTask::EETrendTask(const edm::ParameterSet& ps){
   prefixME_ = ps.getUntrackedParameter<std::string>("prefixME", "");
   enableCleanup_ = ps.getUntrackedParameter<bool>("enableCleanup", false);
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
+
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
   verbose_ = ps.getUntrackedParameter<bool>("verbose", false);
 
   // parameters...
@@ -71,6 +75,7 @@ EETrendTask::EETrendTask(const edm::ParameterSet& ps){
   EcalElectronicsIdCollection4_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection4");
   EcalElectronicsIdCollection5_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection5");
   EcalElectronicsIdCollection6_ = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection6");
+
   FEDRawDataCollection_ = ps.getParameter<edm::InputTag>("FEDRawDataCollection");
   EESRFlagCollection_ = ps.getParameter<edm::InputTag>("EESRFlagCollection");
 
@@ -141,10 +146,13 @@ EETrendTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup con
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EETrendTask::reset(void) {
 
+  instrumentation_.reset();
+
   if(nEEDigiMinutely_) nEEDigiMinutely_->Reset();
   if(nEcalPnDiodeDigiMinutely_) nEcalPnDiodeDigiMinutely_->Reset();
   if(nEcalRecHitMinutely_) nEcalRecHitMinutely_->Reset();
@@ -178,6 +186,8 @@ void EETrendTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EETrendTask");
+
   std::string name;
 
   if ( dqmStore_ ) {
@@ -310,6 +320,8 @@ void EETrendTask::setup(void){
 
   }
 
+  this->reportMemory("setup");
+
 }
 
 
@@ -317,6 +329,9 @@ void EETrendTask::cleanup(void){
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
     dqmStore_->setCurrentFolder(prefixME_ + "/EETrendTask");
 
@@ -381,13 +396,27 @@ void EETrendTask::endJob(void){
 
   edm::LogInfo("EETrendTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EETrendTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.report(dqmStore_, prefixME_, "EETrendTask", "EETrendTask", when);
+
+}
+
 
 void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
@@ -412,7 +441,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   // --------------------------------------------------
   int ndc = 0;
   edm::Handle<EEDigiCollection> digis;
-  if ( e.getByLabel(EEDigiCollection_, digis) ) ndc = digis->size();
+  if ( instrumentation_.getByLabel(e, EEDigiCollection_, digis) ) ndc = digis->size();
   else edm::LogWarning("EETrendTask") << EEDigiCollection_ << " is not available";
 
   ecaldqm::shift2Right(nEEDigiMinutely_->getTProfile(), minuteBinDiff);
@@ -427,7 +456,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   // --------------------------------------------------
   int npdc = 0;
   edm::Handle<EcalPnDiodeDigiCollection> pns;
-  if ( e.getByLabel(EcalPnDiodeDigiCollection_, pns) ) npdc = pns->size();
+  if ( instrumentation_.getByLabel(e, EcalPnDiodeDigiCollection_, pns) ) npdc = pns->size();
   else edm::LogWarning("EETrendTask") << EcalPnDiodeDigiCollection_ << " is not available";
 
   ecaldqm::shift2Right(nEcalPnDiodeDigiMinutely_->getTProfile(), minuteBinDiff);
@@ -442,7 +471,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   // --------------------------------------------------
   int nrhc = 0;
   edm::Handle<EcalRecHitCollection> hits;
-  if ( e.getByLabel(EcalRecHitCollection_, hits) ) nrhc = hits->size();
+  if ( instrumentation_.getByLabel(e, EcalRecHitCollection_, hits) ) nrhc = hits->size();
   else edm::LogWarning("EETrendTask") << EcalRecHitCollection_ << " is not available";
 
   ecaldqm::shift2Right(nEcalRecHitMinutely_->getTProfile(), minuteBinDiff);
@@ -457,7 +486,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   // --------------------------------------------------
   int ntpdc = 0;
   edm::Handle<EcalTrigPrimDigiCollection> tpdigis;
-  if ( e.getByLabel(EcalTrigPrimDigiCollection_, tpdigis) ) ntpdc = tpdigis->size();
+  if ( instrumentation_.getByLabel(e, EcalTrigPrimDigiCollection_, tpdigis) ) ntpdc = tpdigis->size();
   else edm::LogWarning("EETrendTask") << EcalTrigPrimDigiCollection_ << " is not available";
 
   ecaldqm::shift2Right(nEcalTrigPrimDigiMinutely_->getTProfile(), minuteBinDiff);
@@ -473,7 +502,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   int nbcc = 0;
   float nbcc_size = 0.0;
   edm::Handle<reco::BasicClusterCollection> pBasicClusters;
-  if ( e.getByLabel(BasicClusterCollection_, pBasicClusters) ) {
+  if ( instrumentation_.getByLabel(e, BasicClusterCollection_, pBasicClusters) ) {
     nbcc = pBasicClusters->size();
     for(reco::BasicClusterCollection::const_iterator it = pBasicClusters->begin();
 	it != pBasicClusters->end(); it++){
@@ -502,7 +531,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   int nscc = 0;
   float nscc_size = 0.0;
   edm::Handle<reco::SuperClusterCollection> pSuperClusters;
-  if ( e.getByLabel(SuperClusterCollection_, pSuperClusters) ) {
+  if ( instrumentation_.getByLabel(e, SuperClusterCollection_, pSuperClusters) ) {
     nscc = pSuperClusters->size();
     for(reco::SuperClusterCollection::const_iterator it = pSuperClusters->begin();
 	it != pSuperClusters->end(); it++){
@@ -649,7 +678,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   int kByte = 1024;
 
   edm::Handle<FEDRawDataCollection> allFedRawData;
-  if ( e.getByLabel(FEDRawDataCollection_, allFedRawData) ) {
+  if ( instrumentation_.getByLabel(e, FEDRawDataCollection_, allFedRawData) ) {
     for ( int iDcc = eem1; iDcc <= eep2; ++iDcc ) {
       int sizeInKB = allFedRawData->FEDData(iDcc).size()/kByte;
       if(iDcc >= eem1 && iDcc <= eem2) nfedEEminus += sizeInKB;
@@ -675,7 +704,7 @@ void EETrendTask::analyze(const edm::Event& e, const edm::EventSetup& c){
   // --------------------------------------------------
   int nsfc = 0;
   edm::Handle<EESrFlagCollection> eeSrFlags;
-  if ( e.getByLabel(EESRFlagCollection_,eeSrFlags) ) nsfc = eeSrFlags->size();
+  if ( instrumentation_.getByLabel(e, EESRFlagCollection_,eeSrFlags) ) nsfc = eeSrFlags->size();
   else edm::LogWarning("EETrendTask") << EESRFlagCollection_ << " is not available";
 
   ecaldqm::shift2Right(nEESRFlagMinutely_->getTProfile(), minuteBinDiff);
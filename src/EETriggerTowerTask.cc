@@ -20,6 +20,7 @@
 
 #include "DQM/EcalCommon/interface/Numbers.h"
 
+#include "DQM/EcalEndcapMonitorTasks/interface/EETPGFastEmulator.h"
 #include "DQM/EcalEndcapMonitorTasks/interface/EETriggerTowerTask.h"
 #include "FWCore/Common/interface/TriggerNames.h"
 
@@ -29,7 +30,7 @@ const int EETriggerTowerTask::nTTEta = 20;
 const int EETriggerTowerTask::nTTPhi = 20;
 const int EETriggerTowerTask::nSM = 18;
 
-EETriggerTowerTask::EETriggerTowerTask(const edm::ParameterSet& ps) {
+EETriggerTowerTask::EETriggerTowerTask(const edm::ParameterSet& ps) : readoutCensus_(EEReadoutCensus::shared()) {
 
   init_ = false;
 
@@ -39,8 +40,14 @@ EETriggerTowerTask::EETriggerTowerTask(const edm::ParameterSet& ps) {
 
   mergeRuns_ = ps.getUntrackedParameter<bool>("mergeRuns", false);
 
+  instrumentation_.enable( ps.getUntrackedParameter<bool>("enableInstrumentation", false) );
+
+  memoryReport_.enable( ps.getUntrackedParameter<bool>("enableMemoryReport", false) );
+
   enableCleanup_ = ps.getUntrackedParameter<bool>("enableCleanup", false);
 
+  enableFastEmulation_ = ps.getUntrackedParameter<bool>("enableFastEmulation", false);
+
   meEtSpectrumReal_[0] = 0;
   meEtSpectrumReal_[1] = 0;
   meEtSpectrumEmul_[0] = 0;
@@ -59,6 +66,9 @@ EETriggerTowerTask::EETriggerTowerTask(const edm::ParameterSet& ps) {
   meEmulMatchIndex1D_[1] = 0;
   meEmulMatchMaxIndex1D_[0] = 0;
   meEmulMatchMaxIndex1D_[1] = 0;
+  meHLTResults_ = 0;
+  meEmulOnly_ = 0;
+  meRealOnly_ = 0;
 
   reserveArray(meEtMapReal_);
   reserveArray(meVetoReal_);
@@ -76,6 +86,12 @@ EETriggerTowerTask::EETriggerTowerTask(const edm::ParameterSet& ps) {
   HLTCaloHLTBit_ = ps.getUntrackedParameter<std::string>("HLTCaloHLTBit", "");
   HLTMuonHLTBit_ = ps.getUntrackedParameter<std::string>("HLTMuonHLTBit", "");
 
+  HLTResultsTag_ = HLTResultsCollection_;
+  HLTResultsResolved_ = false;
+
+  HLTCaloHLTBitIndex_ = 0;
+  HLTMuonHLTBitIndex_ = 0;
+
   outputFile_ = ps.getUntrackedParameter<std::string>("OutputRootFile", "");
 
   LogDebug("EETriggerTowerTask") << "REAL     digis: " << realCollection_;
@@ -109,6 +125,10 @@ void EETriggerTowerTask::beginRun(const edm::Run& r, const edm::EventSetup& c) {
 
   Numbers::initGeometry(c, false);
 
+  HLTResultsResolved_ = false;
+
+  if ( enableFastEmulation_ ) fastEmulator_.setup(c);
+
   if ( ! mergeRuns_ ) this->reset();
 
 }
@@ -124,10 +144,13 @@ EETriggerTowerTask::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSe
 	cleanup();
 	setup();
   }
+  instrumentation_.endLumi();
 }
 
 void EETriggerTowerTask::reset(void) {
 
+  instrumentation_.reset();
+
   for (int iside = 0; iside < 2; iside++) {
     if ( meEtSpectrumReal_[iside] ) meEtSpectrumReal_[iside]->Reset();
     if ( meEtSpectrumEmul_[iside] ) meEtSpectrumEmul_[iside]->Reset();
@@ -140,6 +163,9 @@ void EETriggerTowerTask::reset(void) {
     if ( meEmulMatchMaxIndex1D_[iside] ) meEmulMatchMaxIndex1D_[iside]->Reset();
   }
 
+  if ( meEmulOnly_ ) meEmulOnly_->Reset();
+  if ( meRealOnly_ ) meRealOnly_->Reset();
+
   for (int i = 0; i < 18; i++) {
 
     if ( meEtMapReal_[i] ) meEtMapReal_[i]->Reset();
@@ -158,6 +184,8 @@ void EETriggerTowerTask::setup(void){
 
   init_ = true;
 
+  instrumentation_.setup(dqmStore_, prefixME_ + "/Instrumentation", "EETriggerTowerTask");
+
   if ( dqmStore_ ) {
     setup( "Real Digis",
            (prefixME_ + "/EETriggerTowerTask").c_str(), false );
@@ -168,6 +196,8 @@ void EETriggerTowerTask::setup(void){
   else {
     edm::LogError("EETriggerTowerTask") << "Bad DQMStore, cannot book MonitorElements.";
   }
+
+  this->reportMemory("setup");
 }
 
 void EETriggerTowerTask::setup( std::string const &nameext,
@@ -262,6 +292,21 @@ void EETriggerTowerTask::setup( std::string const &nameext,
       meTCCTimingMuon_[1]->setAxisTitle("TP data matching emulator", 2);
     }
 
+    name = "EETTT TP emulator only";
+    meEmulOnly_ = dqmStore_->book1D(name, name, 18, 1., 19.);
+    for (int i = 0; i < 18; i++) {
+      meEmulOnly_->setBinLabel(i+1, Numbers::sEE(i+1).c_str(), 1);
+    }
+
+    name = "EETTT TP real only";
+    meRealOnly_ = dqmStore_->book1D(name, name, 18, 1., 19.);
+    for (int i = 0; i < 18; i++) {
+      meRealOnly_->setBinLabel(i+1, Numbers::sEE(i+1).c_str(), 1);
+    }
+
+    name = "EETTT HLT results";
+    meHLTResults_ = dqmStore_->bookString(name, HLTResultsResolved_ ? HLTResultsTag_.encode() : "");
+
   } else {
     name = "EETTT Et spectrum " + nameext + " EE -";
     meEtSpectrumEmul_[0] = dqmStore_->book1D(name, name, 256, 0., 256.);
@@ -331,12 +376,19 @@ void EETriggerTowerTask::cleanup(void) {
 
   if ( ! init_ ) return;
 
+  instrumentation_.cleanup(dqmStore_);
+  memoryReport_.cleanup(dqmStore_);
+
   if ( dqmStore_ ) {
 
     if ( !outputFile_.empty() ) dqmStore_->save( outputFile_.c_str() );
 
     dqmStore_->rmdir( prefixME_ + "/EETriggerTowerTask" );
 
+    meHLTResults_ = 0;
+    meEmulOnly_ = 0;
+    meRealOnly_ = 0;
+
   }
 
   init_ = false;
@@ -347,25 +399,42 @@ void EETriggerTowerTask::endJob(void){
 
   edm::LogInfo("EETriggerTowerTask") << "analyzed " << ievt_ << " events";
 
+  this->reportMemory("endJob");
+
   if ( enableCleanup_ ) this->cleanup();
 
 }
 
+void EETriggerTowerTask::reportMemory(const std::string& when) {
+
+  if ( ! memoryReport_.enabled() ) return;
+
+  memoryReport_.clear();
+
+  memoryReport_.add("fastEmulator_", &fastEmulator_, 1);
+  memoryReport_.add("readoutCensus_ (shared)", &readoutCensus_, 1);
+
+  memoryReport_.report(dqmStore_, prefixME_, "EETriggerTowerTask", "EETriggerTowerTask", when);
+
+}
+
 void EETriggerTowerTask::analyze(const edm::Event& e, const edm::EventSetup& c){
 
+  EEInstrumentation::Timer timer(instrumentation_, EEInstrumentation::Total);
+
   if ( ! init_ ) this->setup();
 
   ievt_++;
 
   edm::Handle<EcalTrigPrimDigiCollection> realDigis;
 
-  if ( e.getByLabel(realCollection_, realDigis) ) {
+  if ( instrumentation_.getByLabel(e, realCollection_, realDigis) ) {
 
     int neetpd = realDigis->size();
     LogDebug("EETriggerTowerTask") << "event " << ievt_ << " trigger primitive digi collection size: " << neetpd;
 
     processDigis( e,
-                  realDigis,
+                  *realDigis,
                   meEtMapReal_,
                   meVetoReal_);
 
@@ -373,101 +442,143 @@ void EETriggerTowerTask::analyze(const edm::Event& e, const edm::EventSetup& c){
     edm::LogWarning("EETriggerTowerTask") << realCollection_ << " not available";
   }
 
+  const EcalTrigPrimDigiCollection* compDigis = realDigis.isValid() ? realDigis.product() : 0;
+
   edm::Handle<EcalTrigPrimDigiCollection> emulDigis;
 
-  if ( e.getByLabel(emulCollection_, emulDigis) ) {
+  if ( ! enableFastEmulation_ && ! instrumentation_.getByLabel(e, emulCollection_, emulDigis) ) {
+    edm::LogInfo("EETriggerTowerTask") << emulCollection_ << " not available";
+    return;
+  }
 
-    edm::Handle<edm::TriggerResults> hltResults;
+  // the emulated TPs are only compared on the events with HLT results,
+  // whether they are read or emulated here
 
-    if ( !e.getByLabel(HLTResultsCollection_, hltResults) ) {
-      HLTResultsCollection_ = edm::InputTag(HLTResultsCollection_.label(), HLTResultsCollection_.instance(), "HLT");
-    }
+  edm::Handle<edm::TriggerResults> hltResults;
 
-    if ( !e.getByLabel(HLTResultsCollection_, hltResults) ) {
-      HLTResultsCollection_ = edm::InputTag(HLTResultsCollection_.label(), HLTResultsCollection_.instance(), "FU");
-    }
+  if ( ! HLTResultsResolved_ ) this->resolveHLTResults(e);
+
+  if ( ! instrumentation_.getByLabel(e, HLTResultsTag_, hltResults) ) {
+    edm::LogWarning("EETriggerTowerTask") << HLTResultsTag_ << " not available";
+    return;
+  }
+
+  // the crystal digis are read once, for the fast emulation and for the
+  // number of crystals read out per tower, see EEReadoutCensus
+
+  edm::Handle<EEDigiCollection> crystalDigis;
 
-    if ( e.getByLabel(HLTResultsCollection_, hltResults) ) {
+  bool readoutCensus = false;
 
-      processDigis( e,
-                    emulDigis,
-                    meEtMapEmul_,
-                    meVetoEmul_,
-                    realDigis,
-                    hltResults);
+  if ( enableFastEmulation_ || compDigis ) {
+
+    if ( instrumentation_.getByLabel(e, EEDigiCollection_, crystalDigis) ) {
+
+      if ( compDigis ) {
+        readoutCensus_.update(e, c, crystalDigis);
+        readoutCensus = true;
+      }
 
     } else {
-      edm::LogWarning("EETriggerTowerTask") << HLTResultsCollection_ << " not available";
+      edm::LogWarning("EETriggerTowerTask") << EEDigiCollection_ << " not available";
     }
 
-  } else {
-    edm::LogInfo("EETriggerTowerTask") << emulCollection_ << " not available";
   }
 
-}
+  if ( enableFastEmulation_ ) {
 
-void
-EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTrigPrimDigiCollection>& digis,
-                                  array1& meEtMap,
-                                  array1& meVeto,
-                                  const edm::Handle<EcalTrigPrimDigiCollection>& compDigis,
-                                  const edm::Handle<edm::TriggerResults> & hltResults ) {
+    // emulate the TPs from the crystal digis, instead of reading them
 
-  int bx = e.bunchCrossing();
-  int nTP[2];
-  nTP[0] = nTP[1] = 0;
+    if ( ! crystalDigis.isValid() ) return;
 
-  // indexes are: readoutCrystalsInTower[TCCId][iTT]
-  int readoutCrystalsInTower[108][41];
-  for (int itcc = 0; itcc < 108; itcc++) {
-    for (int itt = 0; itt < 41; itt++) readoutCrystalsInTower[itcc][itt] = 0;
-  }
+    EcalTrigPrimDigiCollection fastDigis;
 
-  if ( compDigis.isValid() ) {
+    fastEmulator_.process(*crystalDigis, fastDigis);
 
-    edm::Handle<EEDigiCollection> crystalDigis;
+    processDigis( e,
+                  fastDigis,
+                  meEtMapEmul_,
+                  meVetoEmul_,
+                  compDigis,
+                  hltResults.product(),
+                  readoutCensus );
 
-    if ( e.getByLabel(EEDigiCollection_, crystalDigis) ) {
+    return;
 
-      for ( EEDigiCollection::const_iterator cDigiItr = crystalDigis->begin(); cDigiItr != crystalDigis->end(); ++cDigiItr ) {
+  }
 
-        EEDetId id = cDigiItr->id();
+  processDigis( e,
+                *emulDigis,
+                meEtMapEmul_,
+                meVetoEmul_,
+                compDigis,
+                hltResults.product(),
+                readoutCensus );
 
-        int ix = id.ix();
-        int iy = id.iy();
-        int ism = Numbers::iSM( id );
-        int itcc = Numbers::iTCC( ism, EcalEndcap, ix, iy );
-        int itt = Numbers::iTT( ism, EcalEndcap, ix, iy );
+}
 
-        readoutCrystalsInTower[itcc-1][itt-1]++;
+void EETriggerTowerTask::resolveHLTResults(const edm::Event& e) {
 
-      }
+  // try the configured process first, then the online HLT and the
+  // filter unit ones; keep the configured one if none is found
 
-    } else {
-      edm::LogWarning("EETriggerTowerTask") << EEDigiCollection_ << " not available";
-    }
+  edm::InputTag candidates[3];
+  candidates[0] = HLTResultsCollection_;
+  candidates[1] = edm::InputTag(HLTResultsCollection_.label(), HLTResultsCollection_.instance(), "HLT");
+  candidates[2] = edm::InputTag(HLTResultsCollection_.label(), HLTResultsCollection_.instance(), "FU");
+
+  HLTResultsTag_ = HLTResultsCollection_;
+
+  edm::Handle<edm::TriggerResults> hltResults;
 
+  for ( int i = 0; i < 3; i++ ) {
+    if ( instrumentation_.getByLabel(e, candidates[i], hltResults) ) {
+      HLTResultsTag_ = candidates[i];
+      break;
+    }
   }
 
+  HLTResultsResolved_ = true;
+
+  LogDebug("EETriggerTowerTask") << "HLT results: " << HLTResultsTag_;
+
+  std::string value = HLTResultsTag_.encode();
+  if ( meHLTResults_ ) meHLTResults_->Fill(value);
+
+}
+
+void
+EETriggerTowerTask::processDigis( const edm::Event& e, const EcalTrigPrimDigiCollection& digis,
+                                  array1& meEtMap,
+                                  array1& meVeto,
+                                  const EcalTrigPrimDigiCollection* compDigis,
+                                  const edm::TriggerResults* hltResults,
+                                  bool readoutCensus ) {
+
+  int bx = e.bunchCrossing();
+  int nTP[2];
+  nTP[0] = nTP[1] = 0;
+
   bool caloTrg = false;
   bool muonTrg = false;
 
-  if ( hltResults.isValid() ) {
+  if ( hltResults ) {
 
     int ntrigs = hltResults->size();
     if ( ntrigs!=0 ) {
 
       const edm::TriggerNames & triggerNames = e.triggerNames(*hltResults);
 
-      for ( int itrig = 0; itrig != ntrigs; ++itrig ) {
-        std::string trigName = triggerNames.triggerName(itrig);
-        bool accept = hltResults->accept(itrig);
+      // the path indices only change with the HLT menu
+      if ( triggerNames.parameterSetID() != HLTTriggerNamesID_ ) {
+        HLTTriggerNamesID_ = triggerNames.parameterSetID();
+        HLTCaloHLTBitIndex_ = triggerNames.triggerIndex(HLTCaloHLTBit_);
+        HLTMuonHLTBitIndex_ = triggerNames.triggerIndex(HLTMuonHLTBit_);
+      }
 
-        if ( trigName == HLTCaloHLTBit_ ) caloTrg = accept;
+      if ( HLTCaloHLTBitIndex_ < (unsigned int) ntrigs ) caloTrg = hltResults->accept(HLTCaloHLTBitIndex_);
 
-        if ( trigName == HLTMuonHLTBit_ ) muonTrg = accept;
-
-      }
+      if ( HLTMuonHLTBitIndex_ < (unsigned int) ntrigs ) muonTrg = hltResults->accept(HLTMuonHLTBitIndex_);
 
     } else {
       edm::LogWarning("EBTriggerTowerTask") << " zero size trigger names in input TriggerResults";
@@ -475,7 +586,12 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
 
   }
 
-  for ( EcalTrigPrimDigiCollection::const_iterator tpdigiItr = digis->begin(); tpdigiItr != digis->end(); ++tpdigiItr ) {
+  // both collections are sorted by tower id: walk them together instead
+  // of searching each emulated TP in the real ones
+  EcalTrigPrimDigiCollection::const_iterator compItr;
+  if ( compDigis ) compItr = compDigis->begin();
+
+  for ( EcalTrigPrimDigiCollection::const_iterator tpdigiItr = digis.begin(); tpdigiItr != digis.end(); ++tpdigiItr ) {
 
     if ( Numbers::subDet( tpdigiItr->id() ) != EcalEndcap ) continue;
 
@@ -496,7 +612,7 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
     bool matchSample[6];
     for (int j=0; j<6; j++) matchSample[j]=false;
 
-    if ( compDigis.isValid() ) {
+    if ( compDigis ) {
 
       if ( ismt >= 1 && ismt <= 9 ) {
         if ( meEtSpectrumEmul_[0] ) meEtSpectrumEmul_[0]->Fill( xvalEt );
@@ -506,7 +622,7 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
 
       float maxEt = 0;
       int maxTPIndex = -1;
-      for (int j=0; j<5; j++) {
+      for (int j=0; j<5 && j<tpdigiItr->size(); j++) {
         float EtTP = (*tpdigiItr)[j].compressedEt();
         if ( EtTP > maxEt ) {
           maxEt = EtTP;
@@ -522,7 +638,16 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
         if ( meEmulMatchMaxIndex1D_[1] && maxEt > 0 ) meEmulMatchMaxIndex1D_[1]->Fill( maxTPIndex );
       }
 
-      EcalTrigPrimDigiCollection::const_iterator compDigiItr = compDigis->find( tpdigiItr->id().rawId() );
+      uint32_t rawId = tpdigiItr->id().rawId();
+
+      for ( ; compItr != compDigis->end() && compItr->id().rawId() < rawId; ++compItr ) {
+        if ( Numbers::subDet( compItr->id() ) != EcalEndcap ) continue;
+        if ( meRealOnly_ ) meRealOnly_->Fill( Numbers::iSM( compItr->id() ) );
+      }
+
+      EcalTrigPrimDigiCollection::const_iterator compDigiItr = compDigis->end();
+      if ( compItr != compDigis->end() && compItr->id().rawId() == rawId ) compDigiItr = compItr++;
+
       if ( compDigiItr != compDigis->end() ) {
         int compDigiEt = compDigiItr->compressedEt();
         compDigiInterest = (compDigiItr->ttFlag() & 0x3);
@@ -543,7 +668,7 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
         bool matchedAny=false;
 
         for (int j=0; j<5; j++) {
-          if ((*tpdigiItr)[j].compressedEt() == compDigiEt ) {
+          if ( j<tpdigiItr->size() && (*tpdigiItr)[j].compressedEt() == compDigiEt ) {
             matchSample[j+1]=true;
             matchedAny=true;
           } else {
@@ -554,7 +679,9 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
         if (!matchedAny) matchSample[0]=true;
 
         // check if the tower has been readout completely and if it is medium or high interest
-        if (readoutCrystalsInTower[itcc-1][itt-1] == int(crystals->size()) &&
+        int readoutCrystalsInTower = readoutCensus ? readoutCensus_.nCryTT(itcc, itt) : 0;
+
+        if (readoutCrystalsInTower == int(crystals->size()) &&
             (compDigiInterest == 1 || compDigiInterest == 3) && compDigiEt > 0) {
 
           if ( tpdigiItr->compressedEt() != compDigiEt ) {
@@ -606,6 +733,7 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
       } else {
         good = false;
         goodVeto = false;
+        if ( meEmulOnly_ ) meEmulOnly_->Fill( ismt );
       }
 
       for ( unsigned int i=0; i<crystals->size(); i++ ) {
@@ -650,6 +778,13 @@ EETriggerTowerTask::processDigis( const edm::Event& e, const edm::Handle<EcalTri
 
   } // loop on TP
 
+  if ( compDigis ) {
+    for ( ; compItr != compDigis->end(); ++compItr ) {
+      if ( Numbers::subDet( compItr->id() ) != EcalEndcap ) continue;
+      if ( meRealOnly_ ) meRealOnly_->Fill( Numbers::iSM( compItr->id() ) );
+    }
+  }
+
   if ( meOccupancyBxReal_[0] ) meOccupancyBxReal_[0]->Fill( bx, nTP[0] );
   if ( meOccupancyBxReal_[1] ) meOccupancyBxReal_[1]->Fill( bx, nTP[1] );
 
@@ -0,0 +1,192 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# benchmark of the endcap tasks on synthetic events, or on the events of
+# an EEInputCapture file, e.g.
+#
+#   cmsRun EEBenchmark_cfg.py suite=pedestal maxEvents=1000
+#   cmsRun EEBenchmark_cfg.py suite=physics fileName=EEInput.bin
+#
+# each task runs wrapped in EETimed, which logs its time per event, per
+# digi and per end of lumi section in the EETimed category at the end of
+# the job; the instrumentation and the memory report of the tasks stay
+# off, so that they do not add to the times. With allocations=1 EETimed
+# also counts the allocations per event, run it then with cmsRunGlibC
+
+options = VarParsing('analysis')
+
+options.register('suite', 'physics', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'physics, pedestal, laser, led, testpulse, hlt, hltoffline or certification')
+options.register('fileName', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'EEInputCapture file to replay instead of the synthetic events, up to its last event')
+options.register('runNumber', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'run number of the synthetic events')
+options.register('lumiNumber', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'first lumi section of the synthetic events')
+options.register('eventsPerLumi', 100, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'synthetic events per lumi section')
+options.register('occupancy', -1., VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                 'fraction of the crystals read out, the one of the suite if negative')
+options.register('pileup', 2., VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                 'mean number of deposits per crystal with a signal')
+options.register('integrityErrorRate', -1., VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                 'probability of an error per SM and integrity collection, the one of the suite if negative')
+options.register('allocations', 0, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'count the allocations per event too, 0 or 1')
+options.register('globalTag', 'GR_R_52_V7::All', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'global tag')
+
+options.setDefault('maxEvents', 500)
+
+options.parseArguments()
+
+# run type, tasks, generator settings and task settings of each suite
+suites = {
+    # 028, 032, 036, 043: online pedestals, readout census, integrity summary, digi view
+    'physics' : ('PHYSICS_GLOBAL',
+                 ['EEOccupancyTask', 'EEPedestalOnlineTask', 'EEIntegrityTask', 'EEStatusFlagsTask', 'EERawDataTask',
+                  'EETimingTask', 'EECosmicTask', 'EETriggerTowerTask', 'EESelectiveReadoutTask', 'EEHltTask', 'EETrendTask'],
+                 { 'occupancy' : 0.2, 'integrityErrorRate' : 0.05 },
+                 { 'EETriggerTowerTask' : { 'enableFastEmulation' : True } }),
+    # 027, 043: pedestal statistics, digi view
+    'pedestal' : ('PEDESTAL_STD', ['EEPedestalTask'], { 'occupancy' : 1., 'mgpaGain' : 1 }, {}),
+    # 043: digi view
+    'laser' : ('LASER_STD', ['EELaserTask'], { 'occupancy' : 1. }, {}),
+    'led' : ('LED_STD', ['EELedTask'], { 'occupancy' : 1. }, {}),
+    'testpulse' : ('TESTPULSE_MGPA', ['EETestPulseTask'], { 'occupancy' : 1., 'mgpaGain' : 1 }, {}),
+    # 035, 036: HLT mode, integrity summary; hltoffline is the same task
+    # without the HLT mode, to compare the ns per event of the two
+    'hlt' : ('PHYSICS_GLOBAL', ['EEHltTask'], { 'occupancy' : 0.2, 'integrityErrorRate' : 0.05, 'crcErrorRate' : 0.01 },
+             { 'EEHltTask' : { 'hltMode' : True } }),
+    'hltoffline' : ('PHYSICS_GLOBAL', ['EEHltTask'], { 'occupancy' : 0.2, 'integrityErrorRate' : 0.05, 'crcErrorRate' : 0.01 },
+                    { 'EEHltTask' : { 'hltMode' : False } }),
+    # 039: lumi section transitions of the certification, one event per lumi section
+    'certification' : ('PHYSICS_GLOBAL',
+                       ['EEIntegrityTask', 'EEStatusFlagsTask', 'EERawDataTask', 'EEDataCertificationTask'],
+                       { 'occupancy' : 0.2 }, {})
+}
+
+if options.suite not in suites:
+    raise RuntimeError('unknown suite ' + options.suite)
+
+(runType, tasks, generator, settings) = suites[options.suite]
+
+if options.occupancy >= 0.:
+    generator['occupancy'] = options.occupancy
+
+if options.integrityErrorRate >= 0.:
+    generator['integrityErrorRate'] = options.integrityErrorRate
+
+generator['pileup'] = options.pileup
+
+eventsPerLumi = options.eventsPerLumi
+if options.suite == 'certification':
+    eventsPerLumi = 1
+
+process = cms.Process("EEBENCHMARK")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+# the replayed events keep the run, lumi and event numbers of the capture
+if options.fileName:
+    process.source = cms.Source("EEInputReplaySource",
+        fileName = cms.untracked.string(options.fileName)
+    )
+else:
+    process.source = cms.Source("EmptySource",
+        firstRun = cms.untracked.uint32(options.runNumber),
+        firstLuminosityBlock = cms.untracked.uint32(options.lumiNumber),
+        numberEventsInLuminosityBlock = cms.untracked.uint32(eventsPerLumi)
+    )
+
+process.load("Geometry.CaloEventSetup.CaloGeometry_cfi")
+process.load("Geometry.CaloEventSetup.CaloTopology_cfi")
+process.load("Geometry.CaloEventSetup.EcalTrigTowerConstituents_cfi")
+process.load("Geometry.CMSCommonData.cmsIdealGeometryXML_cfi")
+process.load("Geometry.EcalMapping.EcalMapping_cfi")
+process.load("Geometry.EcalMapping.EcalMappingRecord_cfi")
+
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.GlobalTag.globaltag = options.globalTag
+
+process.load("DQMServices.Core.DQM_cfg")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.categories.append('EETimed')
+process.MessageLogger.categories.append('EESyntheticInput')
+process.MessageLogger.cerr.FwkReport.reportEvery = 1000
+process.MessageLogger.cerr.threshold = 'INFO'
+process.MessageLogger.cerr.INFO = cms.untracked.PSet(limit = cms.untracked.int32(0))
+process.MessageLogger.cerr.EETimed = cms.untracked.PSet(limit = cms.untracked.int32(-1))
+process.MessageLogger.cerr.EESyntheticInput = cms.untracked.PSet(limit = cms.untracked.int32(-1))
+
+process.SimpleMemoryCheck = cms.Service("SimpleMemoryCheck",
+    ignoreTotal = cms.untracked.int32(1)
+)
+
+# the input, one producer for each label of the original job
+
+if options.fileName:
+
+    process.load("DQM.EcalEndcapMonitorTasks.EEInputReplay_cff")
+
+    for producer in ['ecalDigis', 'ecalGlobalUncalibRecHit', 'ecalRecHit', 'rawDataCollector']:
+        getattr(process, producer).fileName = options.fileName
+
+    process.ecalEndcapInput = cms.Sequence(process.ecalEndcapInputReplaySequence)
+
+else:
+
+    from DQM.EcalEndcapMonitorTasks.EEInputCapture_cfi import ecalEndcapInputCapture
+
+    process.ecalEndcapSyntheticInput = cms.EDProducer("EESyntheticInput",
+        runType = cms.untracked.string(runType),
+        **ecalEndcapInputCapture.parameters_()
+    )
+    for (name, value) in generator.items():
+        if isinstance(value, int):
+            setattr(process.ecalEndcapSyntheticInput, name, cms.untracked.int32(value))
+        else:
+            setattr(process.ecalEndcapSyntheticInput, name, cms.untracked.double(value))
+
+    process.ecalDigis = process.ecalEndcapSyntheticInput.clone()
+    process.ecalGlobalUncalibRecHit = process.ecalEndcapSyntheticInput.clone()
+    process.ecalRecHit = process.ecalEndcapSyntheticInput.clone()
+    process.rawDataCollector = process.ecalEndcapSyntheticInput.clone()
+
+    process.ecalEndcapInput = cms.Sequence(process.rawDataCollector*process.ecalDigis*process.ecalGlobalUncalibRecHit*process.ecalRecHit)
+
+# the tasks, wrapped in EETimed
+
+timedTasks = []
+
+for task in tasks:
+
+    if task == 'EEDataCertificationTask':
+        # not configured by default, see EEDataCertificationTask_cfi.py
+        parameters = { 'prefixME' : cms.untracked.string('EcalEndcap') }
+    else:
+        cfi = __import__('DQM.EcalEndcapMonitorTasks.' + task + '_cfi', fromlist = ['*'])
+        module = [m for m in cfi.__dict__.values() if isinstance(m, cms.EDAnalyzer) and m.type_() == task][0]
+        parameters = module.parameters_()
+
+    timed = cms.EDAnalyzer(task.replace('EE', 'EETimed', 1), **parameters)
+
+    timed.countAllocations = cms.untracked.bool(options.allocations != 0)
+
+    for (name, value) in settings.get(task, {}).items():
+        setattr(timed, name, cms.untracked.bool(value))
+
+    setattr(process, 'timed' + task, timed)
+    timedTasks.append(timed)
+
+process.ecalEndcapTimedTasks = cms.Sequence(timedTasks[0])
+for timed in timedTasks[1:]:
+    process.ecalEndcapTimedTasks += timed
+
+process.p = cms.Path(process.ecalEndcapInput)
+
+# on an end path, so that the TriggerResults of this process are there
+process.e = cms.EndPath(process.ecalEndcapTimedTasks)
@@ -0,0 +1,752 @@
+/*
+ * \file EESyntheticInput.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Synthetic endcap events for the benchmarks: crystal digis, uncalibrated
+ * and calibrated rec hits, trigger primitives, SR flags, PN digis, DCC
+ * headers, integrity errors and FED buffers, for one run type. Like
+ * EEInputReplay, only the collections whose input tag label is the label
+ * of this module are produced, and one instance stands in for each
+ * producer of the original job. Every instance draws the same event,
+ * since the random sequence is seeded with the event number.
+ *
+ * Physics events have a fraction occupancy of the crystals read out, a
+ * fraction signalFraction of them with a pulse made of a Poisson number
+ * (mean pileup) of exponential deposits (mean meanAmplitude ADC counts).
+ * Laser, LED and test pulse events have a pulse of calibAmplitude in all
+ * the crystals read out, pedestal events none.
+ *
+*/
+
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
+#include "DataFormats/EcalDetId/interface/EcalDetIdCollections.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "DataFormats/EcalRawData/interface/EcalRawDataCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+
+#include "Geometry/EcalMapping/interface/EcalElectronicsMapping.h"
+
+#include "DQM/EcalCommon/interface/Numbers.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDccHeaderSummary.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEInputFormat.h"
+
+class EESyntheticInput: public edm::EDProducer{
+
+public:
+
+/// Constructor
+EESyntheticInput(const edm::ParameterSet& ps);
+
+/// Destructor
+virtual ~EESyntheticInput();
+
+protected:
+
+/// Produce
+void produce(edm::Event& e, const edm::EventSetup& c);
+
+/// EndJob
+void endJob(void);
+
+private:
+
+/// Crystal, tower and SC tables, from the electronics mapping
+void setup(void);
+
+/// Draw the crystals read out and their amplitudes
+void generate(const edm::Event& e);
+
+/// Start the random sequence of part of the event
+void seed(const edm::Event& e, int part);
+
+/// Uniform in [0, 1)
+double flat(void);
+
+/// Gaussian, of mean 0 and width 1 (approximate)
+double gauss(void);
+
+/// Poisson, of mean mean
+int poisson(double mean);
+
+/// Raw 16 bit MGPA sample of amplitude amp above the pedestal at gain 12
+static uint16_t sample(double amp, int gainId);
+
+int ievt_;
+
+bool init_;
+
+std::string label_;
+
+uint64_t seed_;
+uint64_t state_;
+
+int runType_;
+unsigned int runClass_;
+
+double occupancy_;
+double signalFraction_;
+double pileup_;
+double meanAmplitude_;
+double calibAmplitude_;
+double adcToGeV_;
+double srThreshold_;
+int mgpaGain_;
+int wavelength_;
+double integrityErrorRate_;
+double crcErrorRate_;
+
+edm::InputTag EEDigiCollection_;
+edm::InputTag EcalTrigPrimDigiCollection_;
+edm::InputTag EESRFlagCollection_;
+edm::InputTag EcalUncalibratedRecHitCollection_;
+edm::InputTag EcalRecHitCollection_;
+edm::InputTag EcalPnDiodeDigiCollection_;
+edm::InputTag EcalRawDataCollection_;
+edm::InputTag EEDetIdCollection_[EEInputFormat::nDetIdErrors];
+edm::InputTag EcalElectronicsIdCollection_[EEInputFormat::nElectronicsIdErrors];
+edm::InputTag FEDRawDataCollection_;
+
+/// collections produced by this instance
+bool produceDigis_;
+bool produceTrigPrims_;
+bool produceSrFlags_;
+bool produceUncalibRecHits_;
+bool produceRecHits_;
+bool producePnDigis_;
+bool produceDccHeaders_;
+bool produceDetIdErrors_[EEInputFormat::nDetIdErrors];
+bool produceElectronicsIdErrors_[EEInputFormat::nElectronicsIdErrors];
+bool produceFedBuffers_;
+
+/// all the crystals, with their SM, tower and SC
+std::vector<EEDetId> crystals_;
+std::vector<int> ism_;
+std::vector<int> tower_;
+std::vector<int> sc_;
+
+std::vector<EcalTrigTowerDetId> towers_;
+std::vector<EcalScDetId> scs_;
+
+/// crystals of each SM
+std::vector<int> smCrystals_[18];
+
+/// crystals read out in the event, and their amplitude at gain 12
+std::vector<int> readout_;
+std::vector<double> amplitude_;
+
+/// number of digis produced
+double nDigis_;
+
+};
+
+static const double shape[EEDataFrame::MAXSAMPLES] = {
+  0., 0., 0., 0.03, 0.65, 1., 0.86, 0.62, 0.42, 0.27
+};
+
+static const struct {
+  const char* name;
+  int value;
+} runTypes[] = {
+  { "COSMIC", EcalDCCHeaderBlock::COSMIC },
+  { "BEAMH4", EcalDCCHeaderBlock::BEAMH4 },
+  { "BEAMH2", EcalDCCHeaderBlock::BEAMH2 },
+  { "MTCC", EcalDCCHeaderBlock::MTCC },
+  { "LASER_STD", EcalDCCHeaderBlock::LASER_STD },
+  { "TESTPULSE_MGPA", EcalDCCHeaderBlock::TESTPULSE_MGPA },
+  { "PEDESTAL_STD", EcalDCCHeaderBlock::PEDESTAL_STD },
+  { "LED_STD", EcalDCCHeaderBlock::LED_STD },
+  { "PHYSICS_GLOBAL", EcalDCCHeaderBlock::PHYSICS_GLOBAL },
+  { "COSMICS_GLOBAL", EcalDCCHeaderBlock::COSMICS_GLOBAL },
+  { "LASER_GAP", EcalDCCHeaderBlock::LASER_GAP },
+  { "TESTPULSE_GAP", EcalDCCHeaderBlock::TESTPULSE_GAP },
+  { "PEDESTAL_GAP", EcalDCCHeaderBlock::PEDESTAL_GAP },
+  { "LED_GAP", EcalDCCHeaderBlock::LED_GAP },
+  { "PHYSICS_LOCAL", EcalDCCHeaderBlock::PHYSICS_LOCAL },
+  { "COSMICS_LOCAL", EcalDCCHeaderBlock::COSMICS_LOCAL }
+};
+
+EESyntheticInput::EESyntheticInput(const edm::ParameterSet& ps){
+
+  ievt_ = 0;
+
+  init_ = false;
+
+  label_ = ps.getParameter<std::string>("@module_label");
+
+  seed_ = ps.getUntrackedParameter<unsigned int>("seed", 12345);
+  state_ = seed_;
+
+  std::string runType = ps.getUntrackedParameter<std::string>("runType", "PHYSICS_GLOBAL");
+
+  runType_ = -1;
+  for ( unsigned int i = 0; i < sizeof(runTypes)/sizeof(runTypes[0]); i++ ) {
+    if ( runType == runTypes[i].name ) runType_ = runTypes[i].value;
+  }
+
+  if ( runType_ < 0 ) {
+    throw cms::Exception("EESyntheticInput") << "unknown run type " << runType;
+  }
+
+  runClass_ = EEDccHeaderSummary::runClass(runType_);
+
+  occupancy_ = ps.getUntrackedParameter<double>("occupancy", 0.2);
+  signalFraction_ = ps.getUntrackedParameter<double>("signalFraction", 0.05);
+  pileup_ = ps.getUntrackedParameter<double>("pileup", 2.);
+  meanAmplitude_ = ps.getUntrackedParameter<double>("meanAmplitude", 30.);
+  calibAmplitude_ = ps.getUntrackedParameter<double>("calibAmplitude", 1500.);
+  adcToGeV_ = ps.getUntrackedParameter<double>("adcToGeV", 0.06);
+  srThreshold_ = ps.getUntrackedParameter<double>("srThreshold", 50.);
+  mgpaGain_ = ps.getUntrackedParameter<int>("mgpaGain", 1);
+  wavelength_ = ps.getUntrackedParameter<int>("wavelength", 0);
+  integrityErrorRate_ = ps.getUntrackedParameter<double>("integrityErrorRate", 0.);
+  crcErrorRate_ = ps.getUntrackedParameter<double>("crcErrorRate", 0.);
+
+  EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
+  EcalTrigPrimDigiCollection_ = ps.getParameter<edm::InputTag>("EcalTrigPrimDigiCollection");
+  EESRFlagCollection_ = ps.getParameter<edm::InputTag>("EESRFlagCollection");
+  EcalUncalibratedRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalUncalibratedRecHitCollection");
+  EcalRecHitCollection_ = ps.getParameter<edm::InputTag>("EcalRecHitCollection");
+  EcalPnDiodeDigiCollection_ = ps.getParameter<edm::InputTag>("EcalPnDiodeDigiCollection");
+  EcalRawDataCollection_ = ps.getParameter<edm::InputTag>("EcalRawDataCollection");
+  EEDetIdCollection_[0] = ps.getParameter<edm::InputTag>("EEDetIdCollection0");
+  EEDetIdCollection_[1] = ps.getParameter<edm::InputTag>("EEDetIdCollection1");
+  EEDetIdCollection_[2] = ps.getParameter<edm::InputTag>("EEDetIdCollection2");
+  EEDetIdCollection_[3] = ps.getParameter<edm::InputTag>("EEDetIdCollection3");
+  EcalElectronicsIdCollection_[0] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection1");
+  EcalElectronicsIdCollection_[1] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection2");
+  EcalElectronicsIdCollection_[2] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection3");
+  EcalElectronicsIdCollection_[3] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection4");
+  EcalElectronicsIdCollection_[4] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection5");
+  EcalElectronicsIdCollection_[5] = ps.getParameter<edm::InputTag>("EcalElectronicsIdCollection6");
+  FEDRawDataCollection_ = ps.getParameter<edm::InputTag>("FEDRawDataCollection");
+
+  produceDigis_ = EEDigiCollection_.label() == label_;
+  if ( produceDigis_ ) produces<EEDigiCollection>(EEDigiCollection_.instance());
+
+  produceTrigPrims_ = EcalTrigPrimDigiCollection_.label() == label_;
+  if ( produceTrigPrims_ ) produces<EcalTrigPrimDigiCollection>(EcalTrigPrimDigiCollection_.instance());
+
+  produceSrFlags_ = EESRFlagCollection_.label() == label_;
+  if ( produceSrFlags_ ) produces<EESrFlagCollection>(EESRFlagCollection_.instance());
+
+  produceUncalibRecHits_ = EcalUncalibratedRecHitCollection_.label() == label_;
+  if ( produceUncalibRecHits_ ) produces<EcalUncalibratedRecHitCollection>(EcalUncalibratedRecHitCollection_.instance());
+
+  produceRecHits_ = EcalRecHitCollection_.label() == label_;
+  if ( produceRecHits_ ) produces<EcalRecHitCollection>(EcalRecHitCollection_.instance());
+
+  producePnDigis_ = EcalPnDiodeDigiCollection_.label() == label_;
+  if ( producePnDigis_ ) produces<EcalPnDiodeDigiCollection>(EcalPnDiodeDigiCollection_.instance());
+
+  produceDccHeaders_ = EcalRawDataCollection_.label() == label_;
+  if ( produceDccHeaders_ ) produces<EcalRawDataCollection>(EcalRawDataCollection_.instance());
+
+  for ( int i = 0; i < EEInputFormat::nDetIdErrors; i++ ) {
+    produceDetIdErrors_[i] = EEDetIdCollection_[i].label() == label_;
+    if ( produceDetIdErrors_[i] ) produces<EEDetIdCollection>(EEDetIdCollection_[i].instance());
+  }
+
+  for ( int i = 0; i < EEInputFormat::nElectronicsIdErrors; i++ ) {
+    produceElectronicsIdErrors_[i] = EcalElectronicsIdCollection_[i].label() == label_;
+    if ( produceElectronicsIdErrors_[i] ) produces<EcalElectronicsIdCollection>(EcalElectronicsIdCollection_[i].instance());
+  }
+
+  produceFedBuffers_ = FEDRawDataCollection_.label() == label_;
+  if ( produceFedBuffers_ ) produces<FEDRawDataCollection>(FEDRawDataCollection_.instance());
+
+  nDigis_ = 0.;
+
+}
+
+EESyntheticInput::~EESyntheticInput(){
+
+}
+
+void EESyntheticInput::endJob(void){
+
+  edm::LogInfo("EESyntheticInput") << label_ << ": " << ievt_ << " events generated, "
+                                   << ( ievt_ ? nDigis_/ievt_ : 0. ) << " crystals read out per event";
+
+}
+
+double EESyntheticInput::flat(void) {
+
+  // xorshift64*
+  state_ ^= state_ >> 12;
+  state_ ^= state_ << 25;
+  state_ ^= state_ >> 27;
+
+  return ( (state_ * 2685821657736338717ULL) >> 11 ) * (1./9007199254740992.);
+
+}
+
+double EESyntheticInput::gauss(void) {
+
+  // sum of 12 uniforms
+  double x = -6.;
+  for ( int i = 0; i < 12; i++ ) x += this->flat();
+
+  return x;
+
+}
+
+int EESyntheticInput::poisson(double mean) {
+
+  double limit = exp(-mean);
+  double p = this->flat();
+
+  int n = 0;
+  while ( p > limit ) {
+    p *= this->flat();
+    n++;
+  }
+
+  return n;
+
+}
+
+uint16_t EESyntheticInput::sample(double amp, int gainId) {
+
+  static const double pedestal = 200.;
+
+  // the gain switches when gain 12, then gain 6, saturate
+  if ( gainId == 1 && pedestal + amp > 4000. ) {
+    gainId = 2;
+  }
+
+  if ( gainId == 2 && pedestal + amp/2. > 4000. ) {
+    gainId = 3;
+  }
+
+  double ratio = gainId == 1 ? 1. : gainId == 2 ? 2. : 12.;
+
+  int adc = int( pedestal + amp/ratio + 0.5 );
+  if ( adc > 4095 ) adc = 4095;
+  if ( adc < 0 ) adc = 0;
+
+  return uint16_t( adc | ( gainId << 12 ) );
+
+}
+
+void EESyntheticInput::setup(void) {
+
+  init_ = true;
+
+  const EcalElectronicsMapping* map = Numbers::getElectronicsMapping();
+
+  std::vector<int> towerIndex;
+  std::vector<int> scIndex;
+
+  for ( int iz = -1; iz <= 1; iz += 2 ) {
+    for ( int ix = 1; ix <= 100; ix++ ) {
+      for ( int iy = 1; iy <= 100; iy++ ) {
+
+        if ( ! EEDetId::validDetId(ix, iy, iz) ) continue;
+
+        EEDetId id(ix, iy, iz, EEDetId::XYMODE);
+
+        int ism = Numbers::iSM(id);
+
+        EcalTrigTowerDetId tower = map->getTrigTowerDetId(Numbers::iTCC(id), Numbers::iTT(id));
+        EcalScDetId sc = Numbers::getEcalScDetId(id);
+
+        // few towers and SCs, a linear search will do
+        int itt = -1;
+        for ( unsigned int i = 0; i < towers_.size(); i++ ) {
+          if ( towers_[i] == tower ) itt = i;
+        }
+        if ( itt < 0 ) {
+          itt = towers_.size();
+          towers_.push_back(tower);
+        }
+
+        int isc = -1;
+        for ( unsigned int i = 0; i < scs_.size(); i++ ) {
+          if ( scs_[i] == sc ) isc = i;
+        }
+        if ( isc < 0 ) {
+          isc = scs_.size();
+          scs_.push_back(sc);
+        }
+
+        smCrystals_[ism-1].push_back(crystals_.size());
+
+        crystals_.push_back(id);
+        ism_.push_back(ism);
+        tower_.push_back(itt);
+        sc_.push_back(isc);
+
+      }
+    }
+  }
+
+  readout_.reserve(crystals_.size());
+  amplitude_.resize(crystals_.size(), 0.);
+
+}
+
+void EESyntheticInput::seed(const edm::Event& e, int part) {
+
+  state_ = ( seed_ ^ ( ( uint64_t(e.id().event()) * 16 + part ) * 0x9e3779b97f4a7c15ULL ) ) | 1;
+
+}
+
+void EESyntheticInput::generate(const edm::Event& e) {
+
+  this->seed(e, 0);
+
+  readout_.clear();
+
+  for ( unsigned int i = 0; i < crystals_.size(); i++ ) {
+
+    amplitude_[i] = 0.;
+
+    if ( this->flat() >= occupancy_ ) continue;
+
+    readout_.push_back(i);
+
+    if ( runClass_ & ( EEDccHeaderSummary::Physics | EEDccHeaderSummary::Beam ) ) {
+
+      if ( this->flat() < signalFraction_ ) {
+        int n = 1 + this->poisson(pileup_);
+        for ( int k = 0; k < n; k++ ) amplitude_[i] += -meanAmplitude_ * log(1. - this->flat());
+      }
+
+    } else if ( runClass_ & ( EEDccHeaderSummary::Laser | EEDccHeaderSummary::Led | EEDccHeaderSummary::TestPulse ) ) {
+
+      amplitude_[i] = calibAmplitude_ * ( 1. + 0.05 * this->gauss() );
+
+    }
+
+  }
+
+}
+
+void EESyntheticInput::produce(edm::Event& e, const edm::EventSetup& c){
+
+  Numbers::initGeometry(c, false);
+
+  if ( ! init_ ) this->setup();
+
+  ievt_++;
+
+  this->generate(e);
+
+  nDigis_ += readout_.size();
+
+  bool calibration = runClass_ & ( EEDccHeaderSummary::Laser | EEDccHeaderSummary::Led | EEDccHeaderSummary::TestPulse | EEDccHeaderSummary::Pedestal );
+
+  int bx = calibration ? 3490 : 1 + int(e.id().event() % 3000);
+  int lv1 = int(e.id().event() & 0xffffff);
+  int orbit = int(e.id().event());
+
+  // gain of the pedestal and test pulse runs, free running otherwise
+  int gainId = ( runClass_ & ( EEDccHeaderSummary::Pedestal | EEDccHeaderSummary::TestPulse ) ) ? mgpaGain_ : 1;
+
+  if ( produceDigis_ ) {
+
+    this->seed(e, 1);
+
+    std::auto_ptr<EEDigiCollection> digis(new EEDigiCollection);
+    digis->reserve(readout_.size());
+
+    uint16_t samples[EEDataFrame::MAXSAMPLES];
+
+    for ( unsigned int n = 0; n < readout_.size(); n++ ) {
+
+      int i = readout_[n];
+
+      for ( int k = 0; k < EEDataFrame::MAXSAMPLES; k++ ) {
+        samples[k] = sample(amplitude_[i] * shape[k] + 1.5 * this->gauss(), gainId);
+      }
+
+      digis->push_back(crystals_[i].rawId(), samples);
+
+    }
+
+    digis->sort();
+
+    e.put(digis, EEDigiCollection_.instance());
+
+  }
+
+  if ( produceUncalibRecHits_ ) {
+
+    this->seed(e, 2);
+
+    std::auto_ptr<EcalUncalibratedRecHitCollection> uhits(new EcalUncalibratedRecHitCollection);
+    uhits->reserve(readout_.size());
+
+    for ( unsigned int n = 0; n < readout_.size(); n++ ) {
+      int i = readout_[n];
+      uhits->push_back( EcalUncalibratedRecHit( crystals_[i], amplitude_[i], 200., 0.1 * this->gauss(), 1. ) );
+    }
+
+    uhits->sort();
+
+    e.put(uhits, EcalUncalibratedRecHitCollection_.instance());
+
+  }
+
+  if ( produceRecHits_ ) {
+
+    this->seed(e, 3);
+
+    std::auto_ptr<EcalRecHitCollection> hits(new EcalRecHitCollection);
+    hits->reserve(readout_.size());
+
+    for ( unsigned int n = 0; n < readout_.size(); n++ ) {
+      int i = readout_[n];
+      hits->push_back( EcalRecHit( crystals_[i], amplitude_[i] * adcToGeV_, this->gauss() ) );
+    }
+
+    hits->sort();
+
+    e.put(hits, EcalRecHitCollection_.instance());
+
+  }
+
+  if ( produceTrigPrims_ ) {
+
+    std::vector<double> et(towers_.size(), 0.);
+
+    for ( unsigned int n = 0; n < readout_.size(); n++ ) {
+      int i = readout_[n];
+      et[tower_[i]] += amplitude_[i] * adcToGeV_;
+    }
+
+    std::auto_ptr<EcalTrigPrimDigiCollection> tps(new EcalTrigPrimDigiCollection);
+    tps->reserve(towers_.size());
+
+    for ( unsigned int i = 0; i < towers_.size(); i++ ) {
+
+      // 0.5 GeV per count
+      int compressedEt = int( 2. * et[i] );
+      if ( compressedEt > 0xff ) compressedEt = 0xff;
+
+      EcalTriggerPrimitiveDigi tp(towers_[i]);
+      tp.setSize(1);
+      tp.setSample(0, EcalTriggerPrimitiveSample(compressedEt, false, compressedEt > 10 ? 3 : 1));
+
+      tps->push_back(tp);
+
+    }
+
+    tps->sort();
+
+    e.put(tps, EcalTrigPrimDigiCollection_.instance());
+
+  }
+
+  if ( produceSrFlags_ ) {
+
+    std::vector<int> flags(scs_.size(), EcalSrFlag::SRF_ZS1);
+
+    for ( unsigned int n = 0; n < readout_.size(); n++ ) {
+      int i = readout_[n];
+      if ( amplitude_[i] > srThreshold_ ) flags[sc_[i]] = EcalSrFlag::SRF_FULL;
+    }
+
+    std::auto_ptr<EESrFlagCollection> srFlags(new EESrFlagCollection);
+    srFlags->reserve(scs_.size());
+
+    for ( unsigned int i = 0; i < scs_.size(); i++ ) srFlags->push_back( EESrFlag( scs_[i], flags[i] ) );
+
+    srFlags->sort();
+
+    e.put(srFlags, EESRFlagCollection_.instance());
+
+  }
+
+  if ( producePnDigis_ ) {
+
+    this->seed(e, 4);
+
+    std::auto_ptr<EcalPnDiodeDigiCollection> pns(new EcalPnDiodeDigiCollection);
+
+    // the PN diodes are read out in the calibration sequence only
+    if ( calibration ) {
+
+      for ( int ism = 1; ism <= 18; ism++ ) {
+
+        int dccId = ism <= 9 ? ism : ism + 36;
+
+        for ( int pnId = 1; pnId <= 10; pnId++ ) {
+
+          EcalPnDiodeDigi pn( EcalPnDiodeDetId(EcalEndcap, dccId, pnId) );
+          pn.setSize(50);
+
+          double amp = runClass_ & EEDccHeaderSummary::Pedestal ? 0. : 0.5 * calibAmplitude_;
+
+          for ( int k = 0; k < 50; k++ ) {
+            double x = k < 20 ? 0. : amp * exp( -0.1 * (k - 20) );
+            int adc = int( 700. + x + 2. * this->gauss() );
+            if ( adc > 4095 ) adc = 4095;
+            if ( adc < 0 ) adc = 0;
+            pn.setSample(k, EcalFEMSample( uint16_t( adc | ( 1 << 12 ) ) ));
+          }
+
+          pns->push_back(pn);
+
+        }
+
+      }
+
+    }
+
+    pns->sort();
+
+    e.put(pns, EcalPnDiodeDigiCollection_.instance());
+
+  }
+
+  if ( produceDccHeaders_ ) {
+
+    std::auto_ptr<EcalRawDataCollection> dcchs(new EcalRawDataCollection);
+    dcchs->reserve(18);
+
+    for ( int ism = 1; ism <= 18; ism++ ) {
+
+      int dccId = ism <= 9 ? ism : ism + 36;
+
+      EcalDCCHeaderBlock dcch;
+
+      dcch.setId(dccId);
+      dcch.setFedId(600 + dccId);
+      dcch.setRunNumber(e.id().run());
+      dcch.setLV1(lv1);
+      dcch.setBX(bx);
+      dcch.setOrbit(orbit);
+      dcch.setBasicTriggerType(calibration ? EcalDCCHeaderBlock::CALIBRATION_TRIGGER : EcalDCCHeaderBlock::PHYSICS_TRIGGER);
+      dcch.setRunType(runType_);
+      dcch.setRtHalf(ievt_ % 2);
+      dcch.setMgpaGain(mgpaGain_);
+      dcch.setMemGain(1);
+      dcch.setSRPBx(bx);
+      dcch.setSRPLv1(lv1 & 0xfff);
+
+      EcalDCCHeaderBlock::EcalDCCEventSettings settings;
+      settings.LaserPower = 0;
+      settings.LaserFilter = 0;
+      settings.wavelength = wavelength_;
+      settings.delay = 0;
+      settings.MEMVinj = 0;
+      settings.mgpa_content = 0;
+      settings.ped_offset = 0;
+      dcch.setEventSettings(settings);
+
+      // all the front ends in sync and enabled
+      dcch.setFEStatus(std::vector<short>(68, 0));
+      dcch.setFEBxs(std::vector<short>(68, bx));
+      dcch.setFELv1(std::vector<short>(68, lv1 & 0xfff));
+      dcch.setTCCBx(std::vector<short>(4, bx));
+      dcch.setTCCLv1(std::vector<short>(4, lv1 & 0xfff));
+
+      dcchs->push_back(dcch);
+
+    }
+
+    dcchs->sort();
+
+    e.put(dcchs, EcalRawDataCollection_.instance());
+
+  }
+
+  this->seed(e, 5);
+
+  // one error per SM and collection, with probability integrityErrorRate
+  for ( int i = 0; i < EEInputFormat::nDetIdErrors; i++ ) {
+
+    std::auto_ptr<EEDetIdCollection> ids(new EEDetIdCollection);
+
+    for ( int ism = 1; ism <= 18; ism++ ) {
+      if ( this->flat() >= integrityErrorRate_ ) continue;
+      const std::vector<int>& v = smCrystals_[ism-1];
+      if ( v.size() ) ids->push_back( crystals_[ v[ int(this->flat() * v.size()) ] ] );
+    }
+
+    if ( produceDetIdErrors_[i] ) e.put(ids, EEDetIdCollection_[i].instance());
+
+  }
+
+  for ( int i = 0; i < EEInputFormat::nElectronicsIdErrors; i++ ) {
+
+    std::auto_ptr<EcalElectronicsIdCollection> ids(new EcalElectronicsIdCollection);
+
+    for ( int ism = 1; ism <= 18; ism++ ) {
+
+      if ( this->flat() >= integrityErrorRate_ ) continue;
+
+      int dccId = ism <= 9 ? ism : ism + 36;
+
+      // the last three collections are the MEM ones, towers 69 and 70
+      if ( i >= 2 ) {
+        ids->push_back( EcalElectronicsId(dccId, 69 + int(this->flat() * 2), 1, 1) );
+      } else {
+        const std::vector<int>& v = smCrystals_[ism-1];
+        if ( v.size() ) ids->push_back( Numbers::getElectronicsMapping()->getElectronicsId( crystals_[ v[ int(this->flat() * v.size()) ] ] ) );
+      }
+
+    }
+
+    if ( produceElectronicsIdErrors_[i] ) e.put(ids, EcalElectronicsIdCollection_[i].instance());
+
+  }
+
+  if ( produceFedBuffers_ ) {
+
+    this->seed(e, 6);
+
+    int nReadout[18];
+    for ( int ism = 1; ism <= 18; ism++ ) nReadout[ism-1] = 0;
+
+    for ( unsigned int n = 0; n < readout_.size(); n++ ) nReadout[ism_[readout_[n]]-1]++;
+
+    std::auto_ptr<FEDRawDataCollection> raw(new FEDRawDataCollection);
+
+    for ( int ism = 1; ism <= 18; ism++ ) {
+
+      int dccId = ism <= 9 ? ism : ism + 36;
+
+      // FED header, DCC header, 3 words per crystal, FED trailer
+      int length = 1 + 8 + 3 * nReadout[ism-1] + 1;
+
+      FEDRawData& fedData = raw->FEDData(600 + dccId);
+      fedData.resize(length * sizeof(uint64_t));
+      memset(fedData.data(), 0, fedData.size());
+
+      uint64_t trailer = uint64_t(0xa) << 60 | uint64_t(length) << 32;
+      if ( this->flat() < crcErrorRate_ ) trailer |= 0x4;
+      memcpy(fedData.data() + (length - 1) * sizeof(uint64_t), &trailer, sizeof(trailer));
+
+    }
+
+    e.put(raw, FEDRawDataCollection_.instance());
+
+  }
+
+}
+
+DEFINE_FWK_MODULE(EESyntheticInput);
@@ -0,0 +1,359 @@
+/*
+ * \file EETimedTasks.cc
+ *
+ * $Date$
+ * $Revision$
+ *
+ * Benchmark wrappers of the tasks: module EETimedXxxTask takes the
+ * parameters of EEXxxTask and runs it unchanged, timing its analyze and
+ * its end of lumi section. At endJob the wall and CPU time per event,
+ * per crystal digi (when the task reads the digis) and per lumi section
+ * transition are logged in the EETimed category. With countAllocations
+ * the heap allocations of analyze are counted too, with the glibc malloc
+ * hooks: run with cmsRunGlibC, the hooks do not see the other allocators.
+ *
+*/
+
+#include <time.h>
+#include <malloc.h>
+#include <stdint.h>
+#include <string>
+#include <sstream>
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+
+#include "DQM/EcalEndcapMonitorTasks/interface/EEClusterTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EECosmicTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEStatusFlagsTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEIntegrityTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EELaserTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EELedTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEOccupancyTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalOnlineTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEPedestalTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EETestPulseTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EETriggerTowerTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EETimingTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EESelectiveReadoutTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EERawDataTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEHltTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDaqInfoTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDcsInfoTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EEDataCertificationTask.h"
+#include "DQM/EcalEndcapMonitorTasks/interface/EETrendTask.h"
+
+/// count of the heap allocations, through the glibc malloc hooks
+class EEAllocationCounter {
+
+public:
+
+/// Install the hooks
+static void start(void) {
+
+  oldMalloc_ = __malloc_hook;
+  oldRealloc_ = __realloc_hook;
+  oldMemalign_ = __memalign_hook;
+
+  install();
+
+}
+
+/// Restore the previous hooks
+static void stop(void) {
+
+  restore();
+
+}
+
+/// Allocations and bytes allocated while the hooks were installed
+static uint64_t allocations(void) { return allocations_; }
+static uint64_t bytes(void) { return bytes_; }
+
+private:
+
+static void install(void) {
+
+  __malloc_hook = mallocHook;
+  __realloc_hook = reallocHook;
+  __memalign_hook = memalignHook;
+
+}
+
+static void restore(void) {
+
+  __malloc_hook = oldMalloc_;
+  __realloc_hook = oldRealloc_;
+  __memalign_hook = oldMemalign_;
+
+}
+
+static void* mallocHook(size_t size, const void*) {
+
+  restore();
+  void* p = malloc(size);
+  allocations_++;
+  bytes_ += size;
+  install();
+
+  return p;
+
+}
+
+static void* reallocHook(void* ptr, size_t size, const void*) {
+
+  restore();
+  void* p = realloc(ptr, size);
+  allocations_++;
+  bytes_ += size;
+  install();
+
+  return p;
+
+}
+
+static void* memalignHook(size_t alignment, size_t size, const void*) {
+
+  restore();
+  void* p = memalign(alignment, size);
+  allocations_++;
+  bytes_ += size;
+  install();
+
+  return p;
+
+}
+
+static void* (*oldMalloc_)(size_t, const void*);
+static void* (*oldRealloc_)(void*, size_t, const void*);
+static void* (*oldMemalign_)(size_t, size_t, const void*);
+
+static uint64_t allocations_;
+static uint64_t bytes_;
+
+};
+
+void* (*EEAllocationCounter::oldMalloc_)(size_t, const void*) = 0;
+void* (*EEAllocationCounter::oldRealloc_)(void*, size_t, const void*) = 0;
+void* (*EEAllocationCounter::oldMemalign_)(size_t, size_t, const void*) = 0;
+
+uint64_t EEAllocationCounter::allocations_ = 0;
+uint64_t EEAllocationCounter::bytes_ = 0;
+
+template<class T> class EETimed: public T {
+
+public:
+
+/// Constructor
+EETimed(const edm::ParameterSet& ps) : T(ps) {
+
+  label_ = ps.getParameter<std::string>("@module_label");
+
+  countAllocations_ = ps.getUntrackedParameter<bool>("countAllocations", false);
+
+  hasDigis_ = ps.exists("EEDigiCollection");
+  if ( hasDigis_ ) EEDigiCollection_ = ps.getParameter<edm::InputTag>("EEDigiCollection");
+
+  nEvents_ = 0;
+  nDigis_ = 0;
+  nLumis_ = 0;
+
+  allocations_ = 0;
+  bytes_ = 0;
+
+  for ( int i = 0; i < 2; i++ ) {
+    event_[i] = 0;
+    lumi_[i] = 0;
+  }
+
+}
+
+/// Destructor
+virtual ~EETimed() {
+
+}
+
+protected:
+
+/// Analyze, timed
+void analyze(const edm::Event& e, const edm::EventSetup& c) {
+
+  if ( hasDigis_ ) {
+    edm::Handle<EEDigiCollection> digis;
+    if ( e.getByLabel(EEDigiCollection_, digis) ) nDigis_ += digis->size();
+  }
+
+  uint64_t start[2];
+  now(start);
+
+  if ( countAllocations_ ) {
+
+    uint64_t allocations = EEAllocationCounter::allocations();
+    uint64_t bytes = EEAllocationCounter::bytes();
+
+    EEAllocationCounter::start();
+    T::analyze(e, c);
+    EEAllocationCounter::stop();
+
+    allocations_ += EEAllocationCounter::allocations() - allocations;
+    bytes_ += EEAllocationCounter::bytes() - bytes;
+
+  } else {
+
+    T::analyze(e, c);
+
+  }
+
+  add(start, event_);
+
+  nEvents_++;
+
+}
+
+/// EndLuminosityBlock, timed
+void endLuminosityBlock(const edm::LuminosityBlock& lumiBlock, const edm::EventSetup& iSetup) {
+
+  uint64_t start[2];
+  now(start);
+
+  T::endLuminosityBlock(lumiBlock, iSetup);
+
+  add(start, lumi_);
+
+  nLumis_++;
+
+}
+
+/// EndJob, with the report
+void endJob(void) {
+
+  T::endJob();
+
+  std::stringstream s;
+
+  s << label_ << ": " << nEvents_ << " events";
+
+  if ( nEvents_ ) {
+    s << ", " << double(event_[0])/nEvents_ << " ns wall, " << double(event_[1])/nEvents_ << " ns CPU per event";
+    if ( hasDigis_ ) s << ", " << double(nDigis_)/nEvents_ << " digis, " << ( nDigis_ ? double(event_[0])/nDigis_ : 0. ) << " ns wall per digi";
+    if ( countAllocations_ ) s << ", " << double(allocations_)/nEvents_ << " allocations, " << double(bytes_)/nEvents_ << " bytes allocated per event";
+  }
+
+  s << "; " << nLumis_ << " lumi sections";
+
+  if ( nLumis_ ) {
+    s << ", " << double(lumi_[0])/nLumis_ << " ns wall, " << double(lumi_[1])/nLumis_ << " ns CPU per end of lumi section";
+  }
+
+  edm::LogInfo("EETimed") << s.str();
+
+}
+
+private:
+
+/// wall and thread CPU time, in ns
+static void now(uint64_t* t) {
+
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  t[0] = uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  t[1] = uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+
+}
+
+static void add(const uint64_t* start, uint64_t* sum) {
+
+  uint64_t t[2];
+  now(t);
+
+  sum[0] += t[0] - start[0];
+  sum[1] += t[1] - start[1];
+
+}
+
+std::string label_;
+
+bool countAllocations_;
+
+bool hasDigis_;
+edm::InputTag EEDigiCollection_;
+
+int nEvents_;
+uint64_t nDigis_;
+int nLumis_;
+
+uint64_t event_[2];
+uint64_t lumi_[2];
+
+uint64_t allocations_;
+uint64_t bytes_;
+
+};
+
+typedef EETimed<EEClusterTask> EETimedClusterTask;
+DEFINE_FWK_MODULE(EETimedClusterTask);
+
+typedef EETimed<EECosmicTask> EETimedCosmicTask;
+DEFINE_FWK_MODULE(EETimedCosmicTask);
+
+typedef EETimed<EEStatusFlagsTask> EETimedStatusFlagsTask;
+DEFINE_FWK_MODULE(EETimedStatusFlagsTask);
+
+typedef EETimed<EEIntegrityTask> EETimedIntegrityTask;
+DEFINE_FWK_MODULE(EETimedIntegrityTask);
+
+typedef EETimed<EELaserTask> EETimedLaserTask;
+DEFINE_FWK_MODULE(EETimedLaserTask);
+
+typedef EETimed<EELedTask> EETimedLedTask;
+DEFINE_FWK_MODULE(EETimedLedTask);
+
+typedef EETimed<EEOccupancyTask> EETimedOccupancyTask;
+DEFINE_FWK_MODULE(EETimedOccupancyTask);
+
+typedef EETimed<EEPedestalOnlineTask> EETimedPedestalOnlineTask;
+DEFINE_FWK_MODULE(EETimedPedestalOnlineTask);
+
+typedef EETimed<EEPedestalTask> EETimedPedestalTask;
+DEFINE_FWK_MODULE(EETimedPedestalTask);
+
+typedef EETimed<EETestPulseTask> EETimedTestPulseTask;
+DEFINE_FWK_MODULE(EETimedTestPulseTask);
+
+typedef EETimed<EETriggerTowerTask> EETimedTriggerTowerTask;
+DEFINE_FWK_MODULE(EETimedTriggerTowerTask);
+
+typedef EETimed<EETimingTask> EETimedTimingTask;
+DEFINE_FWK_MODULE(EETimedTimingTask);
+
+typedef EETimed<EESelectiveReadoutTask> EETimedSelectiveReadoutTask;
+DEFINE_FWK_MODULE(EETimedSelectiveReadoutTask);
+
+typedef EETimed<EERawDataTask> EETimedRawDataTask;
+DEFINE_FWK_MODULE(EETimedRawDataTask);
+
+typedef EETimed<EEHltTask> EETimedHltTask;
+DEFINE_FWK_MODULE(EETimedHltTask);
+
+typedef EETimed<EEDaqInfoTask> EETimedDaqInfoTask;
+DEFINE_FWK_MODULE(EETimedDaqInfoTask);
+
+typedef EETimed<EEDcsInfoTask> EETimedDcsInfoTask;
+DEFINE_FWK_MODULE(EETimedDcsInfoTask);
+
+typedef EETimed<EEDataCertificationTask> EETimedDataCertificationTask;
+DEFINE_FWK_MODULE(EETimedDataCertificationTask);
+
+typedef EETimed<EETrendTask> EETimedTrendTask;
+DEFINE_FWK_MODULE(EETimedTrendTask);
@@ -0,0 +1,57 @@
+#!/bin/sh
+
+# run the benchmark suites of EEBenchmark_cfg.py and print the time per
+# event, per digi and per end of lumi section of each task, then the
+# allocations per event from a second run, e.g.
+#
+#   runEEBenchmark.sh                         all the suites, 500 events
+#   runEEBenchmark.sh maxEvents=5000 pileup=5 more events, more pileup
+#   SUITES="hlt hltoffline" runEEBenchmark.sh HLT mode against offline
+#
+# the arguments are passed to cmsRun; run it on the release and on the
+# change to compare, with the same arguments. The allocations are counted
+# with the glibc malloc hooks, in a run of cmsRunGlibC when there is one
+
+test_dir=${LOCAL_TEST_DIR:-`dirname $0`}
+
+suites=${SUITES:-"physics pedestal laser led testpulse hlt hltoffline certification"}
+
+if which cmsRunGlibC > /dev/null 2>&1; then
+  alloc_cmsrun=cmsRunGlibC
+else
+  alloc_cmsrun=cmsRun
+  echo "cmsRunGlibC not found, the allocations of other allocators than glibc are not counted"
+fi
+
+status=0
+
+for suite in $suites; do
+
+  log=EEBenchmark_$suite.log
+  alloc_log=EEBenchmark_${suite}_allocations.log
+
+  cmsRun $test_dir/EEBenchmark_cfg.py suite=$suite "$@" > $log 2>&1
+
+  if [ $? -ne 0 ]; then
+    echo "suite $suite failed, see $log"
+    status=1
+    continue
+  fi
+
+  echo "suite $suite:"
+  grep -A1 "EETimed" $log | grep -v "^%MSG\|^--" | sed 's/^/  /'
+
+  $alloc_cmsrun $test_dir/EEBenchmark_cfg.py suite=$suite allocations=1 "$@" > $alloc_log 2>&1
+
+  if [ $? -ne 0 ]; then
+    echo "suite $suite allocation run failed, see $alloc_log"
+    status=1
+    continue
+  fi
+
+  echo "suite $suite, allocations:"
+  grep -A1 "EETimed" $alloc_log | grep -v "^%MSG\|^--" | sed 's/^/  /'
+
+done
+
+exit $status